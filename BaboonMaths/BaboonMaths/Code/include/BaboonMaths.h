@@ -4,6 +4,26 @@
 #include <stdarg.h>
 #include <vector>
 #include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <atomic>
+#include <memory_resource>
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <functional>
+#include <type_traits>
+
+// Vector4 computes on its components in a SIMD register where every target has one, SSE on x86 and NEON on AArch64,
+// unless BABOON_SCALAR_VECTOR4 asks for plain floats
+#if !defined(BABOON_SCALAR_VECTOR4) && (defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__))
+#define BABOON_VECTOR4_SSE
+#include <xmmintrin.h>
+#elif !defined(BABOON_SCALAR_VECTOR4) && (defined(__aarch64__) || defined(_M_ARM64))
+#define BABOON_VECTOR4_NEON
+#include <arm_neon.h>
+#endif
 
 namespace Baboon
 {
@@ -15,9 +35,136 @@ namespace Baboon
 	class Matrix2x2;
 	class Matrix3x3;
 	class Matrix4x4;
+	class Affine3;
+	class GpuUpload;
+	class Projection;
+	class ScreenProjection;
+	class Quaternion;
+	class MatrixX;
+	class MatrixXProduct;
+	class LU;
+	class Cholesky;
+	class QR;
+	class Matrix3x3Batch;
+	class TransformBuffer;
+	class FrameArena;
+	class Dataset;
+	class DatasetWriter;
+	class PointPipeline;
+	class DualQuaternion;
+	class Skinning;
+	class Particles;
+	class Cpu;
+
+	// vector of any library type whose memory comes from a std::pmr::memory_resource, such as a FrameArena
+	template <class T> using ScratchVector = std::pmr::vector<T>;
+
+	// true while the compiler evaluates a constant expression, where the C library can't be called
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define BABOON_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define BABOON_CONSTANT_EVALUATED() true
+#endif
+
+	// The operators defined in this header count their calls in the BABOON_PROFILE build like the library's
+	// operations, except where they are folded into a constant. The including code defines BABOON_PROFILE as well.
+#if defined(BABOON_PROFILE)
+	namespace Profiling
+	{
+		int Register(const char* name); // index of the operation, the same for every call with that name
+		void Count(int id); // one call on the calling thread
+	}
+#define BABOON_INLINE_PROFILE(name) \
+	do { \
+		if (!BABOON_CONSTANT_EVALUATED()) \
+			[] { static const int baboonProfileId = ::Baboon::Profiling::Register(name); ::Baboon::Profiling::Count(baboonProfileId); }(); \
+	} while (0)
+#else
+#define BABOON_INLINE_PROFILE(name) ((void)0)
+#endif
+
+	constexpr float ToRadians(float deg) { return deg * (PI / 180.f); }
+	constexpr float ToDegrees(float rad) { return rad * (180.f / PI); }
+
+	// Sine, cosine, tangent and square root usable in constant expressions, so constant transforms can be baked
+	// in static constexpr tables. At compile time they run in double precision (Taylor series on the reduced
+	// angle, Newton iterations), at run time they call the C library.
+
+	// sine and cosine of r in [-pi/4, pi/4], the first ignored term is below 1e-11
+	constexpr double SinPolynomial(double r)
+	{
+		double r2 = r * r;
+		return r * (1. + r2 * (-1. / 6. + r2 * (1. / 120. + r2 * (-1. / 5040. + r2 * (1. / 362880. + r2 * (-1. / 39916800. + r2 / 6227020800.))))));
+	}
+
+	constexpr double CosPolynomial(double r)
+	{
+		double r2 = r * r;
+		return 1. + r2 * (-1. / 2. + r2 * (1. / 24. + r2 * (-1. / 720. + r2 * (1. / 40320. + r2 * (-1. / 3628800. + r2 / 479001600.)))));
+	}
+
+	// x = quadrant * pi / 2 + r, pi / 2 being split in two doubles so r keeps its precision for large angles
+	constexpr double ReduceAngle(float x, int& quadrant)
+	{
+		double q = x * 0.63661977236758134308;
+		long long k = (long long)(q < 0. ? q - 0.5 : q + 0.5);
+		quadrant = (int)(((k % 4) + 4) % 4);
+		return (x - k * 1.57079632679489655800) - k * 6.12323399573676588613e-17;
+	}
+
+	constexpr float Sin(float x)
+	{
+		if (!BABOON_CONSTANT_EVALUATED())
+			return sinf(x);
+
+		int quadrant = 0;
+		double r = ReduceAngle(x, quadrant);
+		double s = quadrant % 2 == 0 ? SinPolynomial(r) : CosPolynomial(r);
+		return (float)(quadrant < 2 ? s : -s);
+	}
 
-	float ToRadians(float deg);
-	float ToDegrees(float rad);
+	constexpr float Cos(float x)
+	{
+		if (!BABOON_CONSTANT_EVALUATED())
+			return cosf(x);
+
+		int quadrant = 0;
+		double r = ReduceAngle(x, quadrant);
+		double c = quadrant % 2 == 0 ? CosPolynomial(r) : SinPolynomial(r);
+		return (float)(quadrant == 0 || quadrant == 3 ? c : -c);
+	}
+
+	constexpr float Tan(float x)
+	{
+		if (!BABOON_CONSTANT_EVALUATED())
+			return tanf(x);
+
+		int quadrant = 0;
+		double r = ReduceAngle(x, quadrant);
+		double t = SinPolynomial(r) / CosPolynomial(r);
+		return (float)(quadrant % 2 == 0 ? t : -1. / t);
+	}
+
+	constexpr float Sqrt(float x)
+	{
+		if (!BABOON_CONSTANT_EVALUATED())
+			return sqrtf(x);
+
+		if (x < 0.f || x != x)
+			return std::numeric_limits<float>::quiet_NaN();
+		if (x == 0.f || x == std::numeric_limits<float>::infinity())
+			return x;
+
+		// Newton iterations from above the root decrease until they reach it
+		double root = x > 1.f ? x : 1.;
+		for (;;) {
+			double next = 0.5 * (root + x / root);
+			if (next >= root)
+				break;
+			root = next;
+		}
+		return (float)root;
+	}
 
 	//Class for Vector2
 	class Vector2
@@ -28,9 +175,9 @@ namespace Baboon
 		float y;
 
 		// different ways of initializing a vector
-		Vector2();
-		Vector2(float _x, float _y);
-		Vector2(float coords);
+		constexpr Vector2() : x(0.f), y(0.f) {}
+		constexpr Vector2(float _x, float _y) : x(_x), y(_y) {}
+		constexpr Vector2(float coords) : x(coords), y(coords) {}
 		~Vector2() = default;
 
 		// different print methods
@@ -57,25 +204,27 @@ namespace Baboon
 		static Vector2 Rotate(Vector2 p, float theta, Vector2 anchor = Vector2()); // rotates a point around another point
 	};
 
-	bool operator==(const Vector2& v1, const Vector2& v2);
-	Vector2 operator+(const Vector2& v, const float& f);
-	Vector2 operator+(const float& f, const Vector2& v);
-	Vector2 operator-(const Vector2& v, const float& f);
-	Vector2 operator*(const Vector2& v, const float& f);
-	Vector2 operator*(const float& f, const Vector2& v);
-	Vector2 operator/(const Vector2& v, const float& f);
-	Vector2 operator+(const Vector2& v1, const Vector2& v2);
-	Vector2 operator-(const Vector2& v1, const Vector2& v2);
-	Vector2 operator*(const Vector2& v1, const Vector2& v2);
-	Vector2 operator/(const Vector2& v1, const Vector2& v2);
-	Vector2 operator+=(Vector2& v, float& f);
-	Vector2 operator-=(Vector2& v, float& f);
-	Vector2 operator*=(Vector2& v, float& f);
-	Vector2 operator/=(Vector2& v, float& f);
-	Vector2& operator+=(Vector2& v1, Vector2& v2);
-	Vector2& operator-=(Vector2& v1, Vector2& v2);
-	Vector2& operator*=(Vector2& v1, Vector2& v2);
-	Vector2& operator/=(Vector2& v1, Vector2& v2);
+	// inline so chained expressions fuse into one pass in the caller
+	constexpr bool operator==(const Vector2& v1, const Vector2& v2) { BABOON_INLINE_PROFILE("Vector2::operator=="); return v1.x == v2.x && v1.y == v2.y; }
+	constexpr Vector2 operator+(const Vector2& v, const float& f) { BABOON_INLINE_PROFILE("Vector2::operator+"); return Vector2(v.x + f, v.y + f); }
+	constexpr Vector2 operator+(const float& f, const Vector2& v) { BABOON_INLINE_PROFILE("Vector2::operator+"); return Vector2(f + v.x, f + v.y); }
+	constexpr Vector2 operator-(const Vector2& v, const float& f) { BABOON_INLINE_PROFILE("Vector2::operator-"); return Vector2(v.x - f, v.y - f); }
+	constexpr Vector2 operator*(const Vector2& v, const float& f) { BABOON_INLINE_PROFILE("Vector2::operator*"); return Vector2(v.x * f, v.y * f); }
+	constexpr Vector2 operator*(const float& f, const Vector2& v) { BABOON_INLINE_PROFILE("Vector2::operator*"); return Vector2(f * v.x, f * v.y); }
+	constexpr Vector2 operator/(const Vector2& v, const float& f) { BABOON_INLINE_PROFILE("Vector2::operator/"); return v * (1.f / f); }
+	constexpr Vector2 operator+(const Vector2& v1, const Vector2& v2) { BABOON_INLINE_PROFILE("Vector2::operator+"); return Vector2(v1.x + v2.x, v1.y + v2.y); }
+	constexpr Vector2 operator-(const Vector2& v1, const Vector2& v2) { BABOON_INLINE_PROFILE("Vector2::operator-"); return Vector2(v1.x - v2.x, v1.y - v2.y); }
+	constexpr Vector2 operator*(const Vector2& v1, const Vector2& v2) { BABOON_INLINE_PROFILE("Vector2::operator*"); return Vector2(v1.x * v2.x, v1.y * v2.y); }
+	constexpr Vector2 operator/(const Vector2& v1, const Vector2& v2) { BABOON_INLINE_PROFILE("Vector2::operator/"); return Vector2(v1.x / v2.x, v1.y / v2.y); }
+
+	constexpr Vector2& operator+=(Vector2& v, const float& f) { BABOON_INLINE_PROFILE("Vector2::operator+="); return v = v + f; }
+	constexpr Vector2& operator-=(Vector2& v, const float& f) { BABOON_INLINE_PROFILE("Vector2::operator-="); return v = v - f; }
+	constexpr Vector2& operator*=(Vector2& v, const float& f) { BABOON_INLINE_PROFILE("Vector2::operator*="); return v = v * f; }
+	constexpr Vector2& operator/=(Vector2& v, const float& f) { BABOON_INLINE_PROFILE("Vector2::operator/="); return v = v / f; }
+	constexpr Vector2& operator+=(Vector2& v1, const Vector2& v2) { BABOON_INLINE_PROFILE("Vector2::operator+="); return v1 = v1 + v2; }
+	constexpr Vector2& operator-=(Vector2& v1, const Vector2& v2) { BABOON_INLINE_PROFILE("Vector2::operator-="); return v1 = v1 - v2; }
+	constexpr Vector2& operator*=(Vector2& v1, const Vector2& v2) { BABOON_INLINE_PROFILE("Vector2::operator*="); return v1 = v1 * v2; }
+	constexpr Vector2& operator/=(Vector2& v1, const Vector2& v2) { BABOON_INLINE_PROFILE("Vector2::operator/="); return v1 = v1 / v2; }
 
 	//Class for Vector3
 	class Vector3
@@ -87,9 +236,9 @@ namespace Baboon
 		float z;
 
 		// different ways of initializing a vector
-		Vector3();
-		Vector3(float _x, float _y, float _z);
-		Vector3(float coords);
+		constexpr Vector3() : x(0.f), y(0.f), z(0.f) {}
+		constexpr Vector3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+		constexpr Vector3(float coords) : x(coords), y(coords), z(coords) {}
 		Vector3(Vector4& v);
 		~Vector3() = default;
 
@@ -109,39 +258,90 @@ namespace Baboon
 		static Vector3 Multiply(Vector3 v1, Vector3 v2); // multiplies two vectors
 		static Vector3 MidPoint(Vector3 v1, Vector3 v2); // get the mid point of two points
 		static float Distance(Vector3 p1, Vector3 p2); // get the distance between two points
-		static float SquaredNorm(Vector3 v); // returns the squared norm of a vector
-		static float Norm(Vector3 v); // returns the norm of a vector
-		static Vector3 Normalize(Vector3 v); //returns normalized vector
-		static float DotProduct(Vector3 v1, Vector3 v2); // returns the dot product of two vectors
-		static Vector3 CrossProduct(Vector3 v1, Vector3 v2); // returns the cross product of two vectors
+		static constexpr float SquaredNorm(Vector3 v); // returns the squared norm of a vector
+		static constexpr float Norm(Vector3 v); // returns the norm of a vector
+		static constexpr Vector3 Normalize(Vector3 v); //returns normalized vector
+		static constexpr float DotProduct(Vector3 v1, Vector3 v2); // returns the dot product of two vectors
+		static constexpr Vector3 CrossProduct(Vector3 v1, Vector3 v2); // returns the cross product of two vectors
 		static float GetAngle(Vector3 v1, Vector3 v2); // returns the angle between two vectors
 		static Vector3 Rotate(Vector3 p, float thetaX, float thetaY, float thetaZ); // rotates a point with the 3D rotation matrix
 	};
 
-	bool operator==(const Vector3& v1, const Vector3& v2);
-	Vector3 operator+(const Vector3& v, const float& f);
-	Vector3 operator+(const float& f, const Vector3& v);
-	Vector3 operator-(const Vector3& v, const float& f);
-	Vector3 operator*(const Vector3& v, const float& f);
-	Vector3 operator*(const float& f, const Vector3& v);
-	Vector3 operator/(const Vector3& v, const float& f);
-	Vector3 operator+(const Vector3& v1, const Vector3& v2);
-	Vector3 operator-(const Vector3& v1, const Vector3& v2);
-	Vector3 operator*(const Vector3& v1, const Vector3& v2);
-	Vector3 operator/(const Vector3& v1, const Vector3& v2);
-	Vector3 operator+=(Vector3& v, float& f);
-	Vector3 operator-=(Vector3& v, float& f);
-	Vector3 operator*=(Vector3& v, float& f);
-	Vector3 operator/=(Vector3& v, float& f);
-	Vector3& operator+=(Vector3& v1, Vector3& v2);
-	Vector3& operator-=(Vector3& v1, Vector3& v2);
-	Vector3& operator*=(Vector3& v1, Vector3& v2);
-	Vector3& operator/=(Vector3& v1, Vector3& v2);
-
-	//Class for Vector4
+	// inline so chained expressions fuse into one pass in the caller
+	constexpr bool operator==(const Vector3& v1, const Vector3& v2) { BABOON_INLINE_PROFILE("Vector3::operator=="); return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z; }
+	constexpr Vector3 operator+(const Vector3& v, const float& f) { BABOON_INLINE_PROFILE("Vector3::operator+"); return Vector3(v.x + f, v.y + f, v.z + f); }
+	constexpr Vector3 operator+(const float& f, const Vector3& v) { BABOON_INLINE_PROFILE("Vector3::operator+"); return Vector3(f + v.x, f + v.y, f + v.z); }
+	constexpr Vector3 operator-(const Vector3& v, const float& f) { BABOON_INLINE_PROFILE("Vector3::operator-"); return Vector3(v.x - f, v.y - f, v.z - f); }
+	constexpr Vector3 operator*(const Vector3& v, const float& f) { BABOON_INLINE_PROFILE("Vector3::operator*"); return Vector3(v.x * f, v.y * f, v.z * f); }
+	constexpr Vector3 operator*(const float& f, const Vector3& v) { BABOON_INLINE_PROFILE("Vector3::operator*"); return Vector3(f * v.x, f * v.y, f * v.z); }
+	constexpr Vector3 operator/(const Vector3& v, const float& f) { BABOON_INLINE_PROFILE("Vector3::operator/"); return v * (1.f / f); }
+	constexpr Vector3 operator+(const Vector3& v1, const Vector3& v2) { BABOON_INLINE_PROFILE("Vector3::operator+"); return Vector3(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z); }
+	constexpr Vector3 operator-(const Vector3& v1, const Vector3& v2) { BABOON_INLINE_PROFILE("Vector3::operator-"); return Vector3(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z); }
+	constexpr Vector3 operator*(const Vector3& v1, const Vector3& v2) { BABOON_INLINE_PROFILE("Vector3::operator*"); return Vector3(v1.x * v2.x, v1.y * v2.y, v1.z * v2.z); }
+	constexpr Vector3 operator/(const Vector3& v1, const Vector3& v2) { BABOON_INLINE_PROFILE("Vector3::operator/"); return Vector3(v1.x / v2.x, v1.y / v2.y, v1.z / v2.z); }
+
+	constexpr Vector3& operator+=(Vector3& v, const float& f) { BABOON_INLINE_PROFILE("Vector3::operator+="); return v = v + f; }
+	constexpr Vector3& operator-=(Vector3& v, const float& f) { BABOON_INLINE_PROFILE("Vector3::operator-="); return v = v - f; }
+	constexpr Vector3& operator*=(Vector3& v, const float& f) { BABOON_INLINE_PROFILE("Vector3::operator*="); return v = v * f; }
+	constexpr Vector3& operator/=(Vector3& v, const float& f) { BABOON_INLINE_PROFILE("Vector3::operator/="); return v = v / f; }
+	constexpr Vector3& operator+=(Vector3& v1, const Vector3& v2) { BABOON_INLINE_PROFILE("Vector3::operator+="); return v1 = v1 + v2; }
+	constexpr Vector3& operator-=(Vector3& v1, const Vector3& v2) { BABOON_INLINE_PROFILE("Vector3::operator-="); return v1 = v1 - v2; }
+	constexpr Vector3& operator*=(Vector3& v1, const Vector3& v2) { BABOON_INLINE_PROFILE("Vector3::operator*="); return v1 = v1 * v2; }
+	constexpr Vector3& operator/=(Vector3& v1, const Vector3& v2) { BABOON_INLINE_PROFILE("Vector3::operator/="); return v1 = v1 / v2; }
+
+	constexpr float Vector3::SquaredNorm(Vector3 v)
+	{
+		float xSquared = v.x * v.x;
+		float ySquared = v.y * v.y;
+		float zSquared = v.z * v.z;
+		float squaredNorm = xSquared + ySquared + zSquared;
+
+		return squaredNorm;
+	}
+
+	constexpr float Vector3::Norm(Vector3 v)
+	{
+		float norm = Sqrt(Vector3::SquaredNorm(v));
+
+		return norm;
+	}
+
+	constexpr Vector3 Vector3::Normalize(Vector3 v)
+	{
+		float norm = Vector3::Norm(v);
+
+		return { v.x / norm, v.y / norm, v.z / norm };
+	}
+
+	constexpr float Vector3::DotProduct(Vector3 v1, Vector3 v2)
+	{
+		float dotProduct = (v1.x * v2.x) + (v1.y * v2.y) + (v1.z * v2.z);
+
+		return dotProduct;
+	}
+
+	constexpr Vector3 Vector3::CrossProduct(Vector3 v1, Vector3 v2)
+	{
+		Vector3 v3;
+
+		v3.x = (v1.y * v2.z) - (v1.z * v2.y);
+		v3.y = (v1.z * v2.x) - (v1.x * v2.z);
+		v3.z = (v1.x * v2.y) - (v1.y * v2.x);
+
+		return v3;
+	}
+
+	// Class for Vector4 : four plain floats, the arithmetic below is inline and loads them into one SIMD register
+	// (unaligned, so a Vector4 keeps the layout and alignment of float[4]), with a plain float version for the others
 	class Vector4
 	{
 	public:
+#if defined(BABOON_VECTOR4_SSE)
+		using Register = __m128;
+#elif defined(BABOON_VECTOR4_NEON)
+		using Register = float32x4_t;
+#endif
+
 		// vector components
 		float x;
 		float y;
@@ -149,9 +349,16 @@ namespace Baboon
 		float w;
 
 		// different ways of initializing a vector
-		Vector4();
-		Vector4(float _x, float _y, float _z, float _w);
-		Vector4(float coords);
+		constexpr Vector4() : x(0.f), y(0.f), z(0.f), w(0.f) {}
+		constexpr Vector4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+		constexpr Vector4(float coords) : x(coords), y(coords), z(coords), w(coords) {}
+#if defined(BABOON_VECTOR4_SSE)
+		explicit Vector4(Register r) { _mm_storeu_ps(&x, r); }
+		Register Load() const { return _mm_loadu_ps(&x); } // the components as the lanes of a register
+#elif defined(BABOON_VECTOR4_NEON)
+		explicit Vector4(Register r) { vst1q_f32(&x, r); }
+		Register Load() const { return vld1q_f32(&x); }
+#endif
 		~Vector4() = default;
 
 		// different print methods
@@ -176,25 +383,145 @@ namespace Baboon
 		static float DotProduct(Vector4 v1, Vector4 v2); // returns the dot product of two vectors
 	};
 
-	bool operator==(const Vector4& v1, const Vector4& v2);
-	Vector4 operator+(const Vector4& v, const float& f);
-	Vector4 operator+(const float& f, const Vector4& v);
-	Vector4 operator-(const Vector4& v, const float& f);
-	Vector4 operator*(const Vector4& v, const float& f);
-	Vector4 operator*(const float& f, const Vector4& v);
-	Vector4 operator/(const Vector4& v, const float& f);
-	Vector4 operator+(const Vector4& v1, const Vector4& v2);
-	Vector4 operator-(const Vector4& v1, const Vector4& v2);
-	Vector4 operator*(const Vector4& v1, const Vector4& v2);
-	Vector4 operator/(const Vector4& v1, const Vector4& v2);
-	Vector4 operator+=(Vector4& v, float& f);
-	Vector4 operator-=(Vector4& v, float& f);
-	Vector4 operator*=(Vector4& v, float& f);
-	Vector4 operator/=(Vector4& v, float& f);
-	Vector4& operator+=(Vector4& v1, Vector4& v2);
-	Vector4& operator-=(Vector4& v1, Vector4& v2);
-	Vector4& operator*=(Vector4& v1, Vector4& v2);
-	Vector4& operator/=(Vector4& v1, Vector4& v2);
+	static_assert(sizeof(Vector4) == 4 * sizeof(float) && alignof(Vector4) == alignof(float), "Vector4 is four packed floats");
+
+	inline bool operator==(const Vector4& v1, const Vector4& v2)
+	{
+		BABOON_INLINE_PROFILE("Vector4::operator==");
+#if defined(BABOON_VECTOR4_SSE)
+		return _mm_movemask_ps(_mm_cmpeq_ps(v1.Load(), v2.Load())) == 0xf;
+#elif defined(BABOON_VECTOR4_NEON)
+		return vminvq_u32(vceqq_f32(v1.Load(), v2.Load())) != 0;
+#else
+		return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z && v1.w == v2.w;
+#endif
+	}
+
+	inline Vector4 operator+(const Vector4& v1, const Vector4& v2)
+	{
+		BABOON_INLINE_PROFILE("Vector4::operator+");
+#if defined(BABOON_VECTOR4_SSE)
+		return Vector4(_mm_add_ps(v1.Load(), v2.Load()));
+#elif defined(BABOON_VECTOR4_NEON)
+		return Vector4(vaddq_f32(v1.Load(), v2.Load()));
+#else
+		return Vector4(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z, v1.w + v2.w);
+#endif
+	}
+
+	inline Vector4 operator-(const Vector4& v1, const Vector4& v2)
+	{
+		BABOON_INLINE_PROFILE("Vector4::operator-");
+#if defined(BABOON_VECTOR4_SSE)
+		return Vector4(_mm_sub_ps(v1.Load(), v2.Load()));
+#elif defined(BABOON_VECTOR4_NEON)
+		return Vector4(vsubq_f32(v1.Load(), v2.Load()));
+#else
+		return Vector4(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z, v1.w - v2.w);
+#endif
+	}
+
+	inline Vector4 operator*(const Vector4& v1, const Vector4& v2)
+	{
+		BABOON_INLINE_PROFILE("Vector4::operator*");
+#if defined(BABOON_VECTOR4_SSE)
+		return Vector4(_mm_mul_ps(v1.Load(), v2.Load()));
+#elif defined(BABOON_VECTOR4_NEON)
+		return Vector4(vmulq_f32(v1.Load(), v2.Load()));
+#else
+		return Vector4(v1.x * v2.x, v1.y * v2.y, v1.z * v2.z, v1.w * v2.w);
+#endif
+	}
+
+	inline Vector4 operator/(const Vector4& v1, const Vector4& v2)
+	{
+		BABOON_INLINE_PROFILE("Vector4::operator/");
+#if defined(BABOON_VECTOR4_SSE)
+		return Vector4(_mm_div_ps(v1.Load(), v2.Load()));
+#elif defined(BABOON_VECTOR4_NEON)
+		return Vector4(vdivq_f32(v1.Load(), v2.Load()));
+#else
+		return Vector4(v1.x / v2.x, v1.y / v2.y, v1.z / v2.z, v1.w / v2.w);
+#endif
+	}
+
+	// the scalar is broadcast to the four lanes
+	inline Vector4 operator+(const Vector4& v, const float& f) { BABOON_INLINE_PROFILE("Vector4::operator+"); return v + Vector4(f); }
+	inline Vector4 operator+(const float& f, const Vector4& v) { BABOON_INLINE_PROFILE("Vector4::operator+"); return Vector4(f) + v; }
+	inline Vector4 operator-(const Vector4& v, const float& f) { BABOON_INLINE_PROFILE("Vector4::operator-"); return v - Vector4(f); }
+	inline Vector4 operator*(const Vector4& v, const float& f) { BABOON_INLINE_PROFILE("Vector4::operator*"); return v * Vector4(f); }
+	inline Vector4 operator*(const float& f, const Vector4& v) { BABOON_INLINE_PROFILE("Vector4::operator*"); return Vector4(f) * v; }
+	inline Vector4 operator/(const Vector4& v, const float& f) { BABOON_INLINE_PROFILE("Vector4::operator/"); return v * Vector4(1.f / f); }
+
+	inline Vector4& operator+=(Vector4& v, const float& f) { BABOON_INLINE_PROFILE("Vector4::operator+="); return v = v + f; }
+	inline Vector4& operator-=(Vector4& v, const float& f) { BABOON_INLINE_PROFILE("Vector4::operator-="); return v = v - f; }
+	inline Vector4& operator*=(Vector4& v, const float& f) { BABOON_INLINE_PROFILE("Vector4::operator*="); return v = v * f; }
+	inline Vector4& operator/=(Vector4& v, const float& f) { BABOON_INLINE_PROFILE("Vector4::operator/="); return v = v / f; }
+	inline Vector4& operator+=(Vector4& v1, const Vector4& v2) { BABOON_INLINE_PROFILE("Vector4::operator+="); return v1 = v1 + v2; }
+	inline Vector4& operator-=(Vector4& v1, const Vector4& v2) { BABOON_INLINE_PROFILE("Vector4::operator-="); return v1 = v1 - v2; }
+	inline Vector4& operator*=(Vector4& v1, const Vector4& v2) { BABOON_INLINE_PROFILE("Vector4::operator*="); return v1 = v1 * v2; }
+	inline Vector4& operator/=(Vector4& v1, const Vector4& v2) { BABOON_INLINE_PROFILE("Vector4::operator/="); return v1 = v1 / v2; }
+
+	inline Vector4 Vector4::Add(Vector4 v1, Vector4 v2)
+	{
+		return v1 + v2;
+	}
+
+	inline Vector4 Vector4::Multiply(Vector4 v1, Vector4 v2)
+	{
+		return v1 * v2;
+	}
+
+	inline Vector4 Vector4::MidPoint(Vector4 v1, Vector4 v2)
+	{
+		return (v1 + v2) * 0.5f;
+	}
+
+	inline float Vector4::DotProduct(Vector4 v1, Vector4 v2)
+	{
+#if defined(BABOON_VECTOR4_SSE)
+		// SSE2 has no dot product instruction : the products summed pairwise across lanes
+		__m128 p = _mm_mul_ps(v1.Load(), v2.Load());
+		__m128 s = _mm_add_ps(p, _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehl_ps(s, s)));
+#elif defined(BABOON_VECTOR4_NEON)
+		return vaddvq_f32(vmulq_f32(v1.Load(), v2.Load()));
+#else
+		return (v1.x * v2.x) + (v1.y * v2.y) + (v1.z * v2.z) + (v1.w * v2.w);
+#endif
+	}
+
+	inline float Vector4::SquaredNorm(Vector4 v)
+	{
+		return DotProduct(v, v);
+	}
+
+	inline float Vector4::Norm(Vector4 v)
+	{
+		return sqrtf(SquaredNorm(v));
+	}
+
+	inline float Vector4::Distance(Vector4 p1, Vector4 p2)
+	{
+		return Norm(p1 - p2);
+	}
+
+	inline Vector4 Vector4::Normalize(Vector4 v)
+	{
+#if defined(BABOON_VECTOR4_SSE)
+		// the squared norm summed into every lane, so the division needs no broadcast
+		__m128 r = v.Load();
+		__m128 p = _mm_mul_ps(r, r);
+		__m128 s = _mm_add_ps(p, _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 0, 1)));
+		s = _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+		return Vector4(_mm_div_ps(r, _mm_sqrt_ps(s)));
+#elif defined(BABOON_VECTOR4_NEON)
+		return Vector4(vdivq_f32(v.Load(), vdupq_n_f32(Norm(v))));
+#else
+		float norm = Norm(v);
+		return { v.x / norm, v.y / norm, v.z / norm, v.w / norm };
+#endif
+	}
 
 	// Class for 2x2 Matrices
 	class Matrix2x2
@@ -203,8 +530,8 @@ namespace Baboon
 		std::array<float, 4> elements;//vector to save the matrix's elements
 
 		// Different ways of initializing a matrix
-		Matrix2x2(bool identity = false);
-		Matrix2x2(std::array<float, 4> _elements);
+		constexpr Matrix2x2(bool identity = false);
+		constexpr Matrix2x2(std::array<float, 4> _elements);
 		~Matrix2x2() = default;
 
 		void Print(); // Displays the matrix
@@ -215,28 +542,123 @@ namespace Baboon
 		float operator[](int index); // operator to get any element of the matirx with the index
 
 		void Opposite(); // returns the opposite of a matrix
-		void Inverse();
+		bool Inverse(); // inverts the matrix, false and left as it is if singular
+		bool Inverse(Matrix2x2& result) const; // writes the inverse to result, which may be this matrix, false and result untouched if singular
 		void Transpose(); // transposes a matrix and returns it
 		void GaussJordan();
-		float Determinant(); // returns the determinant of a matrix
+		float Determinant() const; // returns the determinant of a matrix
 
-		static Matrix2x2 Add(Matrix2x2 mat1, Matrix2x2 mat2); // adds two matrices
-		static Matrix2x2 MultiplyNumber(Matrix2x2 mat, float number); // multiplies a matrix by a number
-		static Matrix2x2 Multiply(Matrix2x2 mat1, Matrix2x2 mat2); // multiplies two matrices
-		static Matrix2x2 Rotation(float theta); // returns a 2D rotation matrix
+		static constexpr Matrix2x2 Add(Matrix2x2 mat1, Matrix2x2 mat2); // adds two matrices
+		static constexpr Matrix2x2 MultiplyNumber(Matrix2x2 mat, float number); // multiplies a matrix by a number
+		static constexpr Matrix2x2 Multiply(Matrix2x2 mat1, Matrix2x2 mat2); // multiplies two matrices
+		static size_t Inverses(const Matrix2x2* matrices, Matrix2x2* inverses, size_t count); // with SIMD, inverses may be matrices, singular ones are copied, returns their count
+		static constexpr Matrix2x2 Rotation(float theta); // returns a 2D rotation matrix
 	};
 
-	Matrix2x2 operator+(const Matrix2x2& mat1, const Matrix2x2& mat2); // overloads + operator to add matrices
-	Matrix2x2 operator-(const Matrix2x2& mat1, const Matrix2x2& mat2);
-	Matrix2x2 operator*(const Matrix2x2& mat1, const Matrix2x2& mat2); // overloads * operator to multiply matrices
-	Matrix2x2 operator*(const Matrix2x2& m, const float& f);
-	Matrix2x2 operator*(const float& f, const Matrix2x2& m);
-	Vector2 operator*(const Matrix2x2& m, const Vector2& v); // overloads * operator to multiply a matrix by a 2D vector
+	constexpr Matrix2x2 operator+(const Matrix2x2& mat1, const Matrix2x2& mat2); // overloads + operator to add matrices
+	constexpr Matrix2x2 operator-(const Matrix2x2& mat1, const Matrix2x2& mat2);
+	constexpr Matrix2x2 operator*(const Matrix2x2& mat1, const Matrix2x2& mat2); // overloads * operator to multiply matrices
+	constexpr Matrix2x2 operator*(const Matrix2x2& m, const float& f);
+	constexpr Matrix2x2 operator*(const float& f, const Matrix2x2& m);
+	constexpr Vector2 operator*(const Matrix2x2& m, const Vector2& v); // overloads * operator to multiply a matrix by a 2D vector
 	Matrix2x2 operator+=(Matrix2x2& mat1, Matrix2x2& mat2);
 	Matrix2x2 operator-=(Matrix2x2& mat1, Matrix2x2& mat2);
 	Matrix2x2 operator*=(Matrix2x2& mat1, Matrix2x2& mat2);
 	Matrix2x2 operator*=(Matrix2x2& m, float& f);
 
+	constexpr Matrix2x2::Matrix2x2(bool identity) : elements{}
+	{
+		if (identity) {
+			for (int i = 0; i < 2; i++)
+				elements[i * 3] = 1.f;
+		}
+	}
+
+	constexpr Matrix2x2::Matrix2x2(std::array<float, 4> _elements) : elements(_elements) {}
+
+	constexpr Matrix2x2 Matrix2x2::Add(Matrix2x2 mat1, Matrix2x2 mat2)
+	{
+		Matrix2x2 m;
+		for (int i = 0; i < 4; i++)
+		{
+			m.elements[i] = mat1.elements[i] + mat2.elements[i];
+		}
+		return m;
+	}
+
+	constexpr Matrix2x2 Matrix2x2::MultiplyNumber(Matrix2x2 mat, float number)
+	{
+		Matrix2x2 m;
+		for (int i = 0; i < 4; i++)
+		{
+			m.elements[i] = mat.elements[i] * number;
+		}
+		return m;
+	}
+
+	constexpr Matrix2x2 Matrix2x2::Multiply(Matrix2x2 mat1, Matrix2x2 mat2)
+	{
+		std::array<float, 4> result{};
+
+		for (int i = 0; i < 2; ++i) {
+			for (int j = 0; j < 2; ++j) {
+				float sum = 0;
+				for (int k = 0; k < 2; ++k) {
+					sum += mat1.elements[i * 2 + k] * mat2.elements[k * 2 + j];
+				}
+				result[i * 2 + j] = sum;
+			}
+		}
+
+		Matrix2x2 m(result);
+		return m;
+	}
+
+	constexpr Matrix2x2 Matrix2x2::Rotation(float theta)
+	{
+		return Matrix2x2({
+			Cos(theta), -Sin(theta),
+			Sin(theta), Cos(theta)
+			});
+	}
+
+	constexpr Matrix2x2 operator+(const Matrix2x2& mat1, const Matrix2x2& mat2)
+	{
+		return Matrix2x2::Add(mat1, mat2);
+	}
+
+	constexpr Matrix2x2 operator-(const Matrix2x2& mat1, const Matrix2x2& mat2)
+	{
+		Matrix2x2 m;
+		for (int i = 0; i < 4; i++)
+		{
+			m.elements[i] = mat1.elements[i] - mat2.elements[i];
+		}
+		return m;
+	}
+
+	constexpr Matrix2x2 operator*(const Matrix2x2& mat1, const Matrix2x2& mat2)
+	{
+		return Matrix2x2::Multiply(mat1, mat2);
+	}
+
+	constexpr Matrix2x2 operator*(const Matrix2x2& m, const float& f)
+	{
+		return Matrix2x2::MultiplyNumber(m, f);
+	}
+
+	constexpr Matrix2x2 operator*(const float& f, const Matrix2x2& m)
+	{
+		return Matrix2x2::MultiplyNumber(m, f);
+	}
+
+	constexpr Vector2 operator*(const Matrix2x2& m, const Vector2& v)
+	{
+		return Vector2(
+			(m.elements[0] * v.x) + (m.elements[1] * v.y),
+			(m.elements[2] * v.x) + (m.elements[3] * v.y));
+	}
+
 	// Class for 3x3 Matrices
 	class Matrix3x3
 	{
@@ -244,8 +666,8 @@ namespace Baboon
 		std::array<float, 9> elements; //vector to save the matrix's elements
 
 		// Different ways of initializing a matrix
-		Matrix3x3(bool identity = false);
-		Matrix3x3(std::array<float, 9> _elements);
+		constexpr Matrix3x3(bool identity = false);
+		constexpr Matrix3x3(std::array<float, 9> _elements);
 		~Matrix3x3() = default;
 
 		void Print(); // Displays the matrix
@@ -256,33 +678,163 @@ namespace Baboon
 		float operator[](int index); // operator to get any element of the matirx with the index
 
 		void Opposite(); // returns the opposite of a matrix
-		void Inverse();
+		bool Inverse(); // inverts the matrix, false and left as it is if singular
+		bool Inverse(Matrix3x3& result) const; // writes the inverse to result, which may be this matrix, false and result untouched if singular
 		void Transpose(); // transposes a matrix and returns it
 		void GaussJordan();
-		float Determinant(); // returns the determinant of a matrix
+		float Determinant() const; // returns the determinant of a matrix
 
-		static Matrix3x3 Add(Matrix3x3 mat1, Matrix3x3 mat2); // adds two matrices
-		static Matrix3x3 MultiplyNumber(Matrix3x3 mat, float number); // multiplies a matrix by a number
-		static Matrix3x3 Multiply(Matrix3x3 mat1, Matrix3x3 mat2); // multiplies two matrices
+		static constexpr Matrix3x3 Add(Matrix3x3 mat1, Matrix3x3 mat2); // adds two matrices
+		static constexpr Matrix3x3 MultiplyNumber(Matrix3x3 mat, float number); // multiplies a matrix by a number
+		static constexpr Matrix3x3 Multiply(Matrix3x3 mat1, Matrix3x3 mat2); // multiplies two matrices
+		static void Determinants(const Matrix3x3* matrices, float* determinants, size_t count); // with SIMD, one per matrix
+		static size_t Inverses(const Matrix3x3* matrices, Matrix3x3* inverses, size_t count); // with SIMD, inverses may be matrices, singular ones are copied, returns their count
 		// returns a 3D rotation matrix with 3 rotation matrices for x, y and z axis
-		static Matrix3x3 Rotation(float thetaX, float thetaY, float thetaZ);
-		static Matrix3x3 RotationX(float thetaX);
-		static Matrix3x3 RotationY(float thetaY);
-		static Matrix3x3 RotationZ(float thetaZ);
+		static constexpr Matrix3x3 Rotation(float thetaX, float thetaY, float thetaZ);
+		static constexpr Matrix3x3 RotationX(float thetaX);
+		static constexpr Matrix3x3 RotationY(float thetaY);
+		static constexpr Matrix3x3 RotationZ(float thetaZ);
+		// eigen-decomposition of a symmetric matrix (upper triangle is read), eigenvectors are the columns sorted by decreasing eigenvalue
+		static void SymmetricEigen(const Matrix3x3& m, Vector3& eigenvalues, Matrix3x3& eigenvectors);
+		// m = u * diag(sigma) * transpose(v) with u and v rotations, sigma.z is negative when m flips orientation
+		static void SVD(const Matrix3x3& m, Matrix3x3& u, Vector3& sigma, Matrix3x3& v);
+		static void PolarDecomposition(const Matrix3x3& m, Matrix3x3& rotation, Matrix3x3& stretch); // m = rotation * stretch
 	};
 
 
-	Matrix3x3 operator+(const Matrix3x3& mat1, const Matrix3x3& mat2); // overloads + operator to add matrices
-	Matrix3x3 operator-(const Matrix3x3& mat1, const Matrix3x3& mat2);
-	Matrix3x3 operator*(const Matrix3x3& mat1, const Matrix3x3& mat2); // overloads * operator to multiply matrices
-	Matrix3x3 operator*(const Matrix3x3& m, const float& f);
-	Matrix3x3 operator*(const float& f, const Matrix3x3& m);
-	Vector3 operator*(const Matrix3x3& m, const Vector3& v); // overloads * operator to multiply a matrix by a 3D vector
+	constexpr Matrix3x3 operator+(const Matrix3x3& mat1, const Matrix3x3& mat2); // overloads + operator to add matrices
+	constexpr Matrix3x3 operator-(const Matrix3x3& mat1, const Matrix3x3& mat2);
+	constexpr Matrix3x3 operator*(const Matrix3x3& mat1, const Matrix3x3& mat2); // overloads * operator to multiply matrices
+	constexpr Matrix3x3 operator*(const Matrix3x3& m, const float& f);
+	constexpr Matrix3x3 operator*(const float& f, const Matrix3x3& m);
+	constexpr Vector3 operator*(const Matrix3x3& m, const Vector3& v); // overloads * operator to multiply a matrix by a 3D vector
 	Matrix3x3 operator+=(Matrix3x3& mat1, Matrix3x3& mat2);
 	Matrix3x3 operator-=(Matrix3x3& mat1, Matrix3x3& mat2);
 	Matrix3x3 operator*=(Matrix3x3& mat1, Matrix3x3& mat2);
 	Matrix3x3 operator*=(Matrix3x3& m, float& f);
 
+	constexpr Matrix3x3::Matrix3x3(bool identity) : elements{}
+	{
+		if (identity) {
+			for (int i = 0; i < 3; i++)
+				elements[i * 4] = 1.f;
+		}
+	}
+
+	constexpr Matrix3x3::Matrix3x3(std::array<float, 9> _elements) : elements(_elements) {}
+
+	constexpr Matrix3x3 Matrix3x3::Add(Matrix3x3 mat1, Matrix3x3 mat2)
+	{
+		Matrix3x3 m;
+		for (int i = 0; i < 9; i++)
+		{
+			m.elements[i] = mat1.elements[i] + mat2.elements[i];
+		}
+		return m;
+	}
+
+	constexpr Matrix3x3 Matrix3x3::MultiplyNumber(Matrix3x3 mat, float number)
+	{
+		Matrix3x3 m;
+		for (int i = 0; i < 9; i++)
+		{
+			m.elements[i] = mat.elements[i] * number;
+		}
+		return m;
+	}
+
+	constexpr Matrix3x3 Matrix3x3::Multiply(Matrix3x3 mat1, Matrix3x3 mat2)
+	{
+		std::array<float, 9> result{};
+
+		for (int i = 0; i < 3; ++i) {
+			for (int j = 0; j < 3; ++j) {
+				float sum = 0;
+				for (int k = 0; k < 3; ++k) {
+					sum += mat1.elements[i * 3 + k] * mat2.elements[k * 3 + j];
+				}
+				result[i * 3 + j] = sum;
+			}
+		}
+		Matrix3x3 m(result);
+		return m;
+	}
+
+	constexpr Matrix3x3 Matrix3x3::Rotation(float thetaX, float thetaY, float thetaZ)
+	{
+		return RotationZ(thetaZ) * RotationY(thetaY) * RotationX(thetaX);
+	}
+
+	constexpr Matrix3x3 Matrix3x3::RotationX(float thetaX)
+	{
+		return Matrix3x3({
+			1.f, 0.f, 0.f,
+			0.f, Cos(thetaX), -Sin(thetaX),
+			0.f, Sin(thetaX), Cos(thetaX)
+			});
+	}
+
+	constexpr Matrix3x3 Matrix3x3::RotationY(float thetaY)
+	{
+		return Matrix3x3({
+			Cos(thetaY), 0.f, Sin(thetaY),
+			0.f, 1.f, 0.f,
+			-Sin(thetaY), 0.f, Cos(thetaY)
+			});
+	}
+
+	constexpr Matrix3x3 Matrix3x3::RotationZ(float thetaZ)
+	{
+		return Matrix3x3({
+			Cos(thetaZ), -Sin(thetaZ), 0.f,
+			Sin(thetaZ), Cos(thetaZ), 0.f,
+			0.f, 0.f, 1.f
+			});
+	}
+
+	constexpr Matrix3x3 operator+(const Matrix3x3& mat1, const Matrix3x3& mat2)
+	{
+		return Matrix3x3::Add(mat1, mat2);
+	}
+
+	constexpr Matrix3x3 operator-(const Matrix3x3& mat1, const Matrix3x3& mat2)
+	{
+		Matrix3x3 m;
+		for (int i = 0; i < 9; i++)
+		{
+			m.elements[i] = mat1.elements[i] - mat2.elements[i];
+		}
+		return m;
+	}
+
+	constexpr Matrix3x3 operator*(const Matrix3x3& mat1, const Matrix3x3& mat2)
+	{
+		return Matrix3x3::Multiply(mat1, mat2);
+	}
+
+	constexpr Matrix3x3 operator*(const Matrix3x3& m, const float& f)
+	{
+		return Matrix3x3::MultiplyNumber(m, f);
+	}
+
+	constexpr Matrix3x3 operator*(const float& f, const Matrix3x3& m)
+	{
+		return Matrix3x3::MultiplyNumber(m, f);
+	}
+
+	constexpr Vector3 operator*(const Matrix3x3& m, const Vector3& v)
+	{
+		return Vector3(
+			(m.elements[0] * v.x) + (m.elements[1] * v.y) + (m.elements[2] * v.z),
+			(m.elements[3] * v.x) + (m.elements[4] * v.y) + (m.elements[5] * v.z),
+			(m.elements[6] * v.x) + (m.elements[7] * v.y) + (m.elements[8] * v.z));
+	}
+
+	// Depth that the perspective builders map the near and far planes to, after the w division : OpenGL's
+	// [-1, 1], [0, 1] for Direct3D, Vulkan and glClipControl, or reversed [1, 0], whose float precision is spread
+	// evenly over the distance when the depth buffer is a float one
+	enum class DepthRange { MinusOneToOne, ZeroToOne, ReverseZ };
+
 	// Class for 4x4 Matrices
 	class Matrix4x4
 	{
@@ -290,8 +842,8 @@ namespace Baboon
 		std::array<float, 16> elements; //vector to save the matrix's elements
 
 		// Different ways of initializing a matrix
-		Matrix4x4(bool identity = false);
-		Matrix4x4(std::array<float, 16> _elements);
+		constexpr Matrix4x4(bool identity = false);
+		constexpr Matrix4x4(std::array<float, 16> _elements);
 		~Matrix4x4() = default;
 
 		void Print(); // Displays the matrix
@@ -305,27 +857,1389 @@ namespace Baboon
 		void Inverse();
 		void Transpose(); // transposes a matrix and returns it
 		void GaussJordan();
-		float Determinant(); // returns the determinant of a matrix
+		float Determinant() const; // returns the determinant of a matrix
 		Matrix4x4 Comatrix() const;
 
-		static Matrix4x4 Homogeneous(Matrix3x3 m); // matrix 3x3 -> matrix 4x4
-		static Matrix4x4 Add(Matrix4x4 mat1, Matrix4x4 mat2); // adds two matrices
-		static Matrix4x4 MultiplyNumber(Matrix4x4 mat, float number); // multiplies a matrix by a number
+		static constexpr Matrix4x4 Homogeneous(Matrix3x3 m); // matrix 3x3 -> matrix 4x4
+		static constexpr Matrix4x4 Add(Matrix4x4 mat1, Matrix4x4 mat2); // adds two matrices
+		static constexpr Matrix4x4 MultiplyNumber(Matrix4x4 mat, float number); // multiplies a matrix by a number
 		static Matrix4x4 Multiply(Matrix4x4 mat1, Matrix4x4 mat2); // multiplies two matrices
-		static Matrix4x4 TRS(Vector3 translation, Vector3 rotation, Vector3 scaling); // returns a TRS matrix
-		static Matrix4x4 View(Vector3 up, Vector3 center, Vector3 eye);
-		static Matrix4x4 Perspective(float fovY, float aspect, float near, float far);
-		static Matrix4x4 Orthographic(float top, float bottom, float right, float left, float far, float near);
+		static void Determinants(const Matrix4x4* matrices, float* determinants, size_t count); // with SIMD, one per matrix
+		static constexpr Matrix4x4 TRS(Vector3 translation, Vector3 rotation, Vector3 scaling); // returns a TRS matrix
+		static constexpr Matrix4x4 View(Vector3 up, Vector3 center, Vector3 eye);
+		static constexpr Matrix4x4 Perspective(float fovY, float aspect, float zNear, float zFar, DepthRange range = DepthRange::MinusOneToOne);
+		// perspective without a far plane, what it clips going to infinity
+		static constexpr Matrix4x4 InfinitePerspective(float fovY, float aspect, float zNear, DepthRange range = DepthRange::MinusOneToOne);
+		static constexpr Matrix4x4 Orthographic(float top, float bottom, float right, float left, float zFar, float zNear);
+		// transforms count points (w = 1) with SIMD, dividing by w only if m is projective, result may alias points
+		static void TransformPoints(const Matrix4x4& m, const Vector3* points, Vector3* result, size_t count);
 	};
 
-	Matrix4x4 operator+(const Matrix4x4& mat1, const Matrix4x4& mat2); // overloads + operator to add matrices
-	Matrix4x4 operator-(const Matrix4x4& mat1, const Matrix4x4& mat2);
+	constexpr Matrix4x4 operator+(const Matrix4x4& mat1, const Matrix4x4& mat2); // overloads + operator to add matrices
+	constexpr Matrix4x4 operator-(const Matrix4x4& mat1, const Matrix4x4& mat2);
 	Matrix4x4 operator*(const Matrix4x4& mat1, const Matrix4x4& mat2); // overloads * operator to multiply matrices
-	Matrix4x4 operator*(const Matrix4x4& m, const float& f);
-	Matrix4x4 operator*(const float& f, const Matrix4x4& m);
+	constexpr Matrix4x4 operator*(const Matrix4x4& m, const float& f);
+	constexpr Matrix4x4 operator*(const float& f, const Matrix4x4& m);
 	Vector4 operator*(const Matrix4x4& m, const Vector4& v); // overloads * operator to multiply a matrix by a 4D vector
 	Matrix4x4 operator+=(Matrix4x4& mat1, Matrix4x4& mat2);
 	Matrix4x4 operator-=(Matrix4x4& mat1, Matrix4x4& mat2);
 	Matrix4x4 operator*=(Matrix4x4& mat1, Matrix4x4& mat2);
 	Matrix4x4 operator*=(Matrix4x4& m, float& f);
-}
\ No newline at end of file
+
+	constexpr Matrix4x4::Matrix4x4(bool identity) : elements{}
+	{
+		if (identity) {
+			for (int i = 0; i < 4; i++)
+				elements[i * 5] = 1.f;
+		}
+	}
+
+	constexpr Matrix4x4::Matrix4x4(std::array<float, 16> _elements) : elements(_elements) {}
+
+	constexpr Matrix4x4 Matrix4x4::Homogeneous(Matrix3x3 m)
+	{
+		return Matrix4x4({
+			m.elements[0], m.elements[1], m.elements[2], 0.f,
+			m.elements[3], m.elements[4], m.elements[5], 0.f,
+			m.elements[6], m.elements[7], m.elements[8], 0.f,
+			0.f, 0.f, 0.f, 1.f
+			});
+	}
+
+	constexpr Matrix4x4 Matrix4x4::Add(Matrix4x4 mat1, Matrix4x4 mat2)
+	{
+		Matrix4x4 m;
+		for (int i = 0; i < 16; i++)
+		{
+			m.elements[i] = mat1.elements[i] + mat2.elements[i];
+		}
+		return m;
+	}
+
+	constexpr Matrix4x4 Matrix4x4::MultiplyNumber(Matrix4x4 mat, float number)
+	{
+		Matrix4x4 m;
+		for (int i = 0; i < 16; i++)
+		{
+			m.elements[i] = mat.elements[i] * number;
+		}
+		return m;
+	}
+
+	constexpr Matrix4x4 Matrix4x4::TRS(Vector3 translation, Vector3 rotation, Vector3 scaling)
+	{
+		// translate * rotate * scale without the products : the rotation columns scaled, then the translation
+		Matrix3x3 rotate = Matrix3x3::Rotation(rotation.x, rotation.y, rotation.z);
+		const std::array<float, 9>& r = rotate.elements;
+
+		return Matrix4x4({
+			r[0] * scaling.x, r[1] * scaling.y, r[2] * scaling.z, translation.x,
+			r[3] * scaling.x, r[4] * scaling.y, r[5] * scaling.z, translation.y,
+			r[6] * scaling.x, r[7] * scaling.y, r[8] * scaling.z, translation.z,
+			0.f, 0.f, 0.f, 1.f
+			});
+	}
+
+	constexpr Matrix4x4 Matrix4x4::View(Vector3 up, Vector3 center, Vector3 eye)
+	{
+		Vector3 f = Vector3::Normalize(center - eye);
+		Vector3 r = Vector3::Normalize(Vector3::CrossProduct(f, up));
+		Vector3 u = Vector3::CrossProduct(r, f);
+
+		Matrix4x4 view({
+			r.x, r.y, r.z, -1.f * Vector3::DotProduct(r, eye),
+			u.x, u.y, u.z, -1.f * Vector3::DotProduct(u, eye),
+			-f.x, -f.y, -f.z, Vector3::DotProduct(f, eye),
+			0.f, 0.f, 0.f, 1.f
+			});
+
+		return view;
+	}
+
+	constexpr Matrix4x4 Matrix4x4::Perspective(float fovY, float aspect, float zNear, float zFar, DepthRange range)
+	{
+		// z' = a * z + b and w' = -z, a and b mapping -zNear and -zFar to the ends of the range
+		float focal = 1.f / Tan(fovY / 2.f);
+		float invDepth = 1.f / (zFar - zNear);
+		float a = range == DepthRange::MinusOneToOne ? -(zFar + zNear) * invDepth : range == DepthRange::ZeroToOne ? -zFar * invDepth : zNear * invDepth;
+		float b = (range == DepthRange::MinusOneToOne ? -2.f : range == DepthRange::ZeroToOne ? -1.f : 1.f) * zFar * zNear * invDepth;
+		return Matrix4x4({
+			focal / aspect, 0.f, 0.f, 0.f,
+			0.f, focal, 0.f, 0.f,
+			0.f, 0.f, a, b,
+			0.f, 0.f, -1.f, 0.f
+			});
+	}
+
+	constexpr Matrix4x4 Matrix4x4::InfinitePerspective(float fovY, float aspect, float zNear, DepthRange range)
+	{
+		// the limits of Perspective's a and b as zFar goes to infinity
+		float focal = 1.f / Tan(fovY / 2.f);
+		float a = range == DepthRange::ReverseZ ? 0.f : -1.f;
+		float b = (range == DepthRange::MinusOneToOne ? -2.f : range == DepthRange::ZeroToOne ? -1.f : 1.f) * zNear;
+		return Matrix4x4({
+			focal / aspect, 0.f, 0.f, 0.f,
+			0.f, focal, 0.f, 0.f,
+			0.f, 0.f, a, b,
+			0.f, 0.f, -1.f, 0.f
+			});
+	}
+
+	constexpr Matrix4x4 Matrix4x4::Orthographic(float top, float bottom, float right, float left, float zFar, float zNear)
+	{
+		return Matrix4x4({
+			2.f / (right - left), 0.f, 0.f, -1.f * ((right + left) / (right - left)),
+			0.f, 2.f / (top - bottom), 0.f, -1.f * ((top + bottom) / (top - bottom)),
+			0.f, 0.f, -2.f / (zFar - zNear), -1.f * ((zFar + zNear) / (zFar - zNear)),
+			0.f, 0.f, 0.f, 1.f
+			});
+	}
+
+	constexpr Matrix4x4 operator+(const Matrix4x4& mat1, const Matrix4x4& mat2)
+	{
+		return Matrix4x4::Add(mat1, mat2);
+	}
+
+	constexpr Matrix4x4 operator-(const Matrix4x4& mat1, const Matrix4x4& mat2)
+	{
+		Matrix4x4 m;
+		for (int i = 0; i < 16; i++)
+		{
+			m.elements[i] = mat1.elements[i] - mat2.elements[i];
+		}
+		return m;
+	}
+
+	constexpr Matrix4x4 operator*(const Matrix4x4& m, const float& f)
+	{
+		return Matrix4x4::MultiplyNumber(m, f);
+	}
+
+	constexpr Matrix4x4 operator*(const float& f, const Matrix4x4& m)
+	{
+		return Matrix4x4::MultiplyNumber(m, f);
+	}
+
+	// Affine transform as the top 3 rows of a Matrix4x4 whose bottom row is (0, 0, 0, 1) : the linear part in
+	// columns 0 to 2, the translation in column 3. Products, inverses and point transforms skip the bottom row.
+	class Affine3
+	{
+	public:
+		std::array<float, 12> elements; // row-major 3x4, elements[r * 4 + 3] is the translation
+
+		// Different ways of initializing a transform
+		constexpr Affine3(bool identity = false);
+		constexpr Affine3(std::array<float, 12> _elements);
+		constexpr Affine3(const Matrix3x3& linear, const Vector3& translation);
+		~Affine3() = default;
+
+		void Print(); // Displays the transform
+
+		constexpr Matrix3x3 Linear() const; // returns the linear part
+		constexpr Vector3 Translation() const;
+		constexpr Matrix4x4 ToMatrix4x4() const;
+
+		bool Inverse(); // inverts the transform, false and left as it is if the linear part is singular
+		bool Inverse(Affine3& result) const; // result may be this transform
+		Affine3 RigidInverse() const; // inverse of a rotation and translation : transposed rotation, no determinant
+		float Determinant() const; // returns the determinant of the linear part
+		// inverse transpose of the linear part, for normals, from its cofactors : the cofactors themselves if singular
+		Matrix3x3 NormalMatrix() const;
+
+		static constexpr Affine3 FromMatrix4x4(const Matrix4x4& m); // top 3 rows of m, its bottom row is dropped
+		static Affine3 Multiply(const Affine3& a1, const Affine3& a2); // a2 then a1, 36 multiplies
+		static Vector3 TransformPoint(const Affine3& a, const Vector3& p);
+		static Vector3 TransformVector(const Affine3& a, const Vector3& v); // linear part only
+		// transforms count points with SIMD like Matrix4x4::TransformPoints, result may alias points
+		static void TransformPoints(const Affine3& a, const Vector3* points, Vector3* result, size_t count);
+	};
+
+	Affine3 operator*(const Affine3& a1, const Affine3& a2);
+	Vector3 operator*(const Affine3& a, const Vector3& p); // transforms a point
+
+	constexpr Affine3::Affine3(bool identity) : elements{}
+	{
+		if (identity) {
+			for (int i = 0; i < 3; i++)
+				elements[i * 5] = 1.f;
+		}
+	}
+
+	constexpr Affine3::Affine3(std::array<float, 12> _elements) : elements(_elements) {}
+
+	constexpr Affine3::Affine3(const Matrix3x3& linear, const Vector3& translation) : elements{
+		linear.elements[0], linear.elements[1], linear.elements[2], translation.x,
+		linear.elements[3], linear.elements[4], linear.elements[5], translation.y,
+		linear.elements[6], linear.elements[7], linear.elements[8], translation.z
+		} {}
+
+	constexpr Matrix3x3 Affine3::Linear() const
+	{
+		return Matrix3x3({
+			elements[0], elements[1], elements[2],
+			elements[4], elements[5], elements[6],
+			elements[8], elements[9], elements[10]
+			});
+	}
+
+	constexpr Vector3 Affine3::Translation() const
+	{
+		return Vector3(elements[3], elements[7], elements[11]);
+	}
+
+	constexpr Matrix4x4 Affine3::ToMatrix4x4() const
+	{
+		return Matrix4x4({
+			elements[0], elements[1], elements[2], elements[3],
+			elements[4], elements[5], elements[6], elements[7],
+			elements[8], elements[9], elements[10], elements[11],
+			0.f, 0.f, 0.f, 1.f
+			});
+	}
+
+	constexpr Affine3 Affine3::FromMatrix4x4(const Matrix4x4& m)
+	{
+		return Affine3({
+			m.elements[0], m.elements[1], m.elements[2], m.elements[3],
+			m.elements[4], m.elements[5], m.elements[6], m.elements[7],
+			m.elements[8], m.elements[9], m.elements[10], m.elements[11]
+			});
+	}
+
+	// Perspective projection keeping its matrix and inverse, rebuilt only when a parameter changes. farPlane may be
+	// infinity for InfinitePerspective.
+	class Projection
+	{
+	public:
+		Projection(float _fovY, float _aspect, float _nearPlane, float _farPlane, DepthRange _range = DepthRange::MinusOneToOne);
+		~Projection() = default;
+
+		void SetFieldOfView(float _fovY);
+		void SetAspect(float _aspect);
+		void SetClipPlanes(float _nearPlane, float _farPlane);
+		void SetDepthRange(DepthRange _range);
+
+		float FieldOfView() const { return fovY; }
+		float Aspect() const { return aspect; }
+		float Near() const { return nearPlane; }
+		float Far() const { return farPlane; }
+		DepthRange Range() const { return range; }
+		const Matrix4x4& Matrix() const { return matrix; }
+		const Matrix4x4& InverseMatrix() const { return inverse; } // clip space to view space
+
+		// normalized device coordinates (x and y in [-1, 1], depth in the range) to view space points, with SIMD,
+		// result may alias points
+		void Unproject(const Vector3* points, Vector3* result, size_t count) const;
+
+	private:
+		float fovY;
+		float aspect;
+		float nearPlane;
+		float farPlane;
+		DepthRange range;
+		Matrix4x4 matrix;
+		Matrix4x4 inverse;
+
+		void Update();
+	};
+
+	// Rectangle of the render target in pixels, y going down from its top left corner like window coordinates
+	struct Viewport
+	{
+		float x;
+		float y;
+		float width;
+		float height;
+	};
+
+	// bits of the clip flags, set for each plane of the clip volume a point is outside of
+	enum ClipFlag : uint8_t { ClipLeft = 1, ClipRight = 2, ClipBottom = 4, ClipTop = 8, ClipNear = 16, ClipFar = 32 };
+
+	class ScreenProjection
+	{
+	public:
+		// Projects count world points through viewProjection into the viewport with SIMD, split over threadCount
+		// threads (0 : one per core) when there are enough points. clipFlags (or nullptr) gets the ClipFlag bits of
+		// each point, the screen position of a point behind the eye (ClipNear) means nothing.
+		static void Project(const Matrix4x4& viewProjection, const Viewport& viewport, const Vector3* points, Vector2* screen,
+			uint8_t* clipFlags, size_t count, DepthRange range = DepthRange::MinusOneToOne, int threadCount = 0);
+	};
+
+	// Layout of the matrices written for the GPU. Matrix4x4 is row-major and transforms column vectors (Perspective and
+	// View give clip = m * v), which GLSL and Vulkan read column-major : they get the transpose by default, and
+	// BABOON_ROW_MAJOR_UPLOAD picks row-major at compile time (HLSL row_major, shaders computing v * m).
+	enum class MatrixLayout { RowMajor, ColumnMajor };
+#if defined(BABOON_ROW_MAJOR_UPLOAD)
+	constexpr MatrixLayout UploadLayout = MatrixLayout::RowMajor;
+#else
+	constexpr MatrixLayout UploadLayout = MatrixLayout::ColumnMajor;
+#endif
+
+	// Packs matrices straight into mapped uniform or storage buffers with the std140/std430 layout, with non-temporal
+	// stores when the destination is 16 byte aligned, so write-combined memory is never read or cached
+	class GpuUpload
+	{
+	public:
+		static constexpr size_t Mat4Size = 64; // bytes of a mat4
+		static constexpr size_t Mat3Size = 48; // bytes of a std140 mat3, 3 vec4 whose w is 0
+
+		static void PackMatrices(const Matrix4x4* matrices, void* destination, size_t count, MatrixLayout layout = UploadLayout);
+		static void PackMatrices(const Affine3* transforms, void* destination, size_t count, MatrixLayout layout = UploadLayout); // as mat4
+		static void PackMatrices(const Matrix3x3* matrices, void* destination, size_t count, MatrixLayout layout = UploadLayout); // as mat3
+	};
+
+	// Class for rotation quaternions, x y z is the vector part and w the scalar part
+	class Quaternion
+	{
+	public:
+		float x;
+		float y;
+		float z;
+		float w;
+
+		// different ways of initializing a quaternion, the default one is the identity rotation
+		Quaternion();
+		Quaternion(float _x, float _y, float _z, float _w);
+		~Quaternion() = default;
+
+		void Print();
+
+		static Quaternion AxisAngle(const Vector3& axis, float angle); // rotation of angle radians around a unit axis
+		static Quaternion FromMatrix(const Matrix3x3& m); // quaternion of a rotation matrix
+		static Matrix3x3 ToMatrix(const Quaternion& q); // rotation matrix of a unit quaternion
+		static Quaternion Conjugate(const Quaternion& q); // inverse rotation of a unit quaternion
+		static Quaternion Normalize(const Quaternion& q);
+		static float DotProduct(const Quaternion& q1, const Quaternion& q2);
+		static Quaternion Multiply(const Quaternion& q1, const Quaternion& q2); // rotation q2 then q1
+		static Vector3 Rotate(const Quaternion& q, const Vector3& v); // rotates a vector by a unit quaternion
+		static Quaternion Nlerp(const Quaternion& q1, const Quaternion& q2, float t); // normalized lerp on the shortest path
+		static Quaternion Slerp(const Quaternion& q1, const Quaternion& q2, float t); // constant speed interpolation on the shortest path
+	};
+
+	bool operator==(const Quaternion& q1, const Quaternion& q2);
+	Quaternion operator*(const Quaternion& q1, const Quaternion& q2);
+	Vector3 operator*(const Quaternion& q, const Vector3& v);
+
+	// Expression templates for MatrixX : sums, differences and scalings build lightweight nodes that are
+	// evaluated in a single pass when assigned to a MatrixX, so chains like a * 2.f + b - c allocate once.
+	// Products are collected in a MatrixXProduct chain and multiplied in the cheapest association order.
+	template <class E>
+	struct MatrixXExpr
+	{
+		const E& Derived() const { return static_cast<const E&>(*this); }
+		int Rows() const { return Derived().Rows(); }
+		int Cols() const { return Derived().Cols(); }
+	};
+
+	// nodes keep matrices by reference and other nodes by value
+	template <class E> struct MatrixXOperand { using Type = const E; };
+	template <> struct MatrixXOperand<MatrixX> { using Type = const MatrixX&; };
+
+	void MatrixXCheckSameSize(int rows1, int cols1, int rows2, int cols2); // exits on mismatched element-wise operands
+
+	// Class for dynamically-sized matrices (row-major)
+	class MatrixX : public MatrixXExpr<MatrixX>
+	{
+	public:
+		int rows;
+		int cols;
+		std::pmr::vector<float> elements; //vector to save the matrix's elements
+
+		// Different ways of initializing a matrix, the elements come from resource (the heap by default)
+		MatrixX();
+		MatrixX(int _rows, int _cols, bool identity = false, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+		MatrixX(int _rows, int _cols, std::vector<float> _elements);
+		MatrixX(const Matrix2x2& m);
+		MatrixX(const Matrix3x3& m);
+		MatrixX(const Matrix4x4& m);
+		template <class E> MatrixX(const MatrixXExpr<E>& e) : rows(0), cols(0) { Assign(e.Derived()); } // evaluates an expression
+		~MatrixX() = default;
+
+		MatrixX(const MatrixX&) = default;
+		MatrixX(MatrixX&&) = default;
+		MatrixX& operator=(const MatrixX&) = default;
+		MatrixX& operator=(MatrixX&&) = default;
+		template <class E> MatrixX& operator=(const MatrixXExpr<E>& e) { Assign(e.Derived()); return *this; }
+
+		void Print(); // Displays the matrix
+
+		float operator[](int index); // operator to get any element of the matirx with the index
+		float& At(int row, int col); // returns a reference to the element at (row, col)
+		float At(int row, int col) const;
+
+		int Rows() const { return rows; }
+		int Cols() const { return cols; }
+		float Coefficient(size_t index) const { return elements[index]; } // element access used by the expressions
+
+		void Opposite(); // returns the opposite of a matrix
+		void Transpose(); // transposes a matrix
+
+		static MatrixX Add(const MatrixX& mat1, const MatrixX& mat2); // adds two matrices
+		static MatrixX MultiplyNumber(const MatrixX& mat, float number); // multiplies a matrix by a number
+		// multiplies two matrices with a cache-blocked kernel, threadCount = 0 uses every hardware thread
+		static MatrixX Multiply(const MatrixX& mat1, const MatrixX& mat2, int threadCount = 0);
+		// raw row-major product c = a * b where a is m x k, b is k x n and c is m x n
+		static void Gemm(int m, int n, int k, const float* a, int lda, const float* b, int ldb, float* c, int ldc, int threadCount = 0);
+
+	private:
+		void Assign(const MatrixXProduct& p);
+		template <class E> void Assign(const E& e)
+		{
+			// element-wise expressions only read index i to write index i, so e may reference *this. A resize can only
+			// come with a product reading *this though, which must still see the old matrix : evaluated aside then
+			if (rows != e.Rows() || cols != e.Cols()) {
+				MatrixX result(e.Rows(), e.Cols(), false, elements.get_allocator().resource());
+				for (size_t i = 0; i < result.elements.size(); i++)
+					result.elements[i] = e.Coefficient(i);
+				*this = std::move(result);
+				return;
+			}
+			for (size_t i = 0; i < elements.size(); i++)
+				elements[i] = e.Coefficient(i);
+		}
+	};
+
+	template <class L, class R>
+	struct MatrixXSum : MatrixXExpr<MatrixXSum<L, R>>
+	{
+		typename MatrixXOperand<L>::Type a;
+		typename MatrixXOperand<R>::Type b;
+
+		MatrixXSum(const L& _a, const R& _b) : a(_a), b(_b) { MatrixXCheckSameSize(a.Rows(), a.Cols(), b.Rows(), b.Cols()); }
+		int Rows() const { return a.Rows(); }
+		int Cols() const { return a.Cols(); }
+		float Coefficient(size_t index) const { return a.Coefficient(index) + b.Coefficient(index); }
+	};
+
+	template <class L, class R>
+	struct MatrixXDifference : MatrixXExpr<MatrixXDifference<L, R>>
+	{
+		typename MatrixXOperand<L>::Type a;
+		typename MatrixXOperand<R>::Type b;
+
+		MatrixXDifference(const L& _a, const R& _b) : a(_a), b(_b) { MatrixXCheckSameSize(a.Rows(), a.Cols(), b.Rows(), b.Cols()); }
+		int Rows() const { return a.Rows(); }
+		int Cols() const { return a.Cols(); }
+		float Coefficient(size_t index) const { return a.Coefficient(index) - b.Coefficient(index); }
+	};
+
+	template <class E>
+	struct MatrixXScaled : MatrixXExpr<MatrixXScaled<E>>
+	{
+		typename MatrixXOperand<E>::Type a;
+		float f;
+
+		MatrixXScaled(const E& _a, float _f) : a(_a), f(_f) {}
+		int Rows() const { return a.Rows(); }
+		int Cols() const { return a.Cols(); }
+		float Coefficient(size_t index) const { return a.Coefficient(index) * f; }
+	};
+
+	// Chain of matrix products, evaluated once (in the association order minimizing multiply-adds) when first read
+	class MatrixXProduct : public MatrixXExpr<MatrixXProduct>
+	{
+	public:
+		std::vector<const MatrixX*> factors; // factors of the chain, left to right
+		std::vector<std::shared_ptr<const MatrixX>> owned; // factors evaluated from sub-expressions
+
+		void Append(const MatrixX& m); // appends a matrix to the chain
+		void Append(const MatrixXProduct& p); // appends another chain
+		template <class E> void Append(const MatrixXExpr<E>& e) { Append(std::make_shared<const MatrixX>(e)); }
+
+		int Rows() const;
+		int Cols() const;
+		float Coefficient(size_t index) const; // evaluates the chain on first use
+		MatrixX Evaluate() const; // multiplies the chain in its optimal order
+
+	private:
+		void Append(std::shared_ptr<const MatrixX> m);
+		mutable std::shared_ptr<const MatrixX> result;
+	};
+
+	template <class L, class R>
+	MatrixXSum<L, R> operator+(const MatrixXExpr<L>& mat1, const MatrixXExpr<R>& mat2) // overloads + operator to add matrices
+	{
+		return MatrixXSum<L, R>(mat1.Derived(), mat2.Derived());
+	}
+
+	template <class L, class R>
+	MatrixXDifference<L, R> operator-(const MatrixXExpr<L>& mat1, const MatrixXExpr<R>& mat2)
+	{
+		return MatrixXDifference<L, R>(mat1.Derived(), mat2.Derived());
+	}
+
+	template <class L, class R>
+	MatrixXProduct operator*(const MatrixXExpr<L>& mat1, const MatrixXExpr<R>& mat2) // overloads * operator to multiply matrices
+	{
+		MatrixXProduct p;
+		p.Append(mat1.Derived());
+		p.Append(mat2.Derived());
+		return p;
+	}
+
+	template <class E>
+	MatrixXScaled<E> operator*(const MatrixXExpr<E>& m, const float& f)
+	{
+		return MatrixXScaled<E>(m.Derived(), f);
+	}
+
+	template <class E>
+	MatrixXScaled<E> operator*(const float& f, const MatrixXExpr<E>& m)
+	{
+		return MatrixXScaled<E>(m.Derived(), f);
+	}
+
+	// LU factorization with partial pivoting (P * A = L * U) of a square matrix, reusable for many right-hand sides
+	class LU
+	{
+	public:
+		MatrixX lu; // L below the diagonal (unit diagonal implied), U on and above it
+		std::vector<int> pivots; // row of A stored at each row of lu
+		int pivotSign; // sign of the row permutation
+		bool singular;
+
+		LU(const MatrixX& m);
+		LU(const Matrix2x2& m);
+		LU(const Matrix3x3& m);
+		LU(const Matrix4x4& m);
+		~LU() = default;
+
+		bool IsSingular() const; // true when a pivot is negligible compared to the matrix's scale
+		float Determinant() const; // returns the determinant of the factorized matrix
+		MatrixX Inverse() const; // returns the inverse of the factorized matrix
+		MatrixX Solve(const MatrixX& b) const; // solves A * x = b for every column of b
+		Vector2 Solve(const Vector2& b) const;
+		Vector3 Solve(const Vector3& b) const;
+		Vector4 Solve(const Vector4& b) const;
+
+		// solves count independent systems m[i] * x[i] = b[i], returns the number of singular systems (their x is zero)
+		static int SolveBatch(const Matrix3x3* m, const Vector3* b, Vector3* x, int count);
+		static int SolveBatch(const Matrix4x4* m, const Vector4* b, Vector4* x, int count);
+	};
+
+	// Cholesky factorization (A = L * transpose(L)) of a symmetric positive definite matrix
+	class Cholesky
+	{
+	public:
+		MatrixX l; // lower triangular factor
+		bool positiveDefinite;
+
+		Cholesky(const MatrixX& m);
+		Cholesky(const Matrix3x3& m);
+		Cholesky(const Matrix4x4& m);
+		~Cholesky() = default;
+
+		bool IsPositiveDefinite() const;
+		float Determinant() const; // returns the determinant of the factorized matrix
+		MatrixX Solve(const MatrixX& b) const; // solves A * x = b for every column of b
+		Vector3 Solve(const Vector3& b) const;
+		Vector4 Solve(const Vector4& b) const;
+
+		// solves count independent symmetric positive definite systems, returns the number of failed ones (their x is zero)
+		static int SolveBatch(const Matrix3x3* m, const Vector3* b, Vector3* x, int count);
+		static int SolveBatch(const Matrix4x4* m, const Vector4* b, Vector4* x, int count);
+	};
+
+	// Householder QR factorization (A = Q * R) of a rows x cols matrix with rows >= cols
+	class QR
+	{
+	public:
+		MatrixX qr; // Householder vectors on and below the diagonal, R above it
+		std::vector<float> rDiagonal; // diagonal of R
+
+		QR(const MatrixX& m);
+		QR(const Matrix3x3& m);
+		QR(const Matrix4x4& m);
+		~QR() = default;
+
+		bool IsFullRank() const;
+		MatrixX Q() const; // returns the rows x cols orthonormal factor
+		MatrixX R() const; // returns the cols x cols upper triangular factor
+		MatrixX Solve(const MatrixX& b) const; // least squares solution of A * x = b for every column of b
+		Vector3 Solve(const Vector3& b) const;
+		Vector4 Solve(const Vector4& b) const;
+	};
+
+	// Batch of 3x3 matrices stored element-major (all m00s, then all m01s...) so each SIMD instruction works on a register of matrices
+	class Matrix3x3Batch
+	{
+	public:
+		int count; // number of matrices
+		int stride; // count rounded up to the SIMD width, distance between two elements of the same matrix
+		std::pmr::vector<float> elements; // element e of matrix i is elements[e * stride + i]
+
+		// Different ways of initializing a batch, the lanes come from resource (the heap by default)
+		Matrix3x3Batch(int _count = 0, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+		Matrix3x3Batch(const Matrix3x3* matrices, int _count, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+		~Matrix3x3Batch() = default;
+
+		void Resize(int _count); // resizes the batch, new matrices are zero
+		void Set(int index, const Matrix3x3& m); // stores a matrix in the batch
+		Matrix3x3 Get(int index) const; // returns a matrix of the batch
+		float* Element(int e); // returns the lane array of element e
+		const float* Element(int e) const;
+
+		void Inverse(); // inverts every matrix, singular ones are left untouched
+		void Transpose(); // transposes every matrix
+		void Determinant(float* determinants) const; // writes the count determinants
+
+		static void Multiply(const Matrix3x3Batch& mat1, const Matrix3x3Batch& mat2, Matrix3x3Batch& result); // multiplies matrices pairwise
+		// batched versions of the Matrix3x3 decompositions, a register of matrices at a time
+		static void SymmetricEigen(const Matrix3x3Batch& m, Vector3* eigenvalues, Matrix3x3Batch& eigenvectors);
+		static void SVD(const Matrix3x3Batch& m, Matrix3x3Batch& u, Vector3* sigma, Matrix3x3Batch& v);
+		static void PolarDecomposition(const Matrix3x3Batch& m, Matrix3x3Batch& rotation, Matrix3x3Batch& stretch);
+	};
+
+	// Lock-free buffer of Matrix4x4 frames : one writer fills and publishes whole frames while any number of readers
+	// (up to maxReaders at the same time) read the latest published frame in place, without locks or copies
+	class TransformBuffer
+	{
+	public:
+		// A published frame pinned for reading, the writer never reuses its memory while the snapshot is alive
+		class Snapshot
+		{
+		public:
+			const Matrix4x4* transforms; // nullptr if nothing was published yet
+			int count;
+			unsigned long long frame; // number of the frame, increasing with every publish
+
+			Snapshot();
+			Snapshot(Snapshot&& other) noexcept;
+			Snapshot& operator=(Snapshot&& other) noexcept;
+			Snapshot(const Snapshot&) = delete;
+			Snapshot& operator=(const Snapshot&) = delete;
+			~Snapshot();
+
+			void Release(); // unpins the frame early
+
+		private:
+			friend class TransformBuffer;
+			std::atomic<int>* readers;
+		};
+
+		TransformBuffer(int _capacity, int maxReaders = 1);
+		~TransformBuffer() = default;
+
+		int Capacity() const; // number of matrices per frame
+
+		// writer side : returns the frame to fill (never visible to readers), or nullptr if more than maxReaders pin frames
+		Matrix4x4* BeginFrame();
+		void Publish(int count); // makes the first count matrices of the frame being written the latest frame
+
+		// reader side : pins the latest published frame
+		Snapshot AcquireLatest();
+
+	private:
+		struct alignas(64) Slot
+		{
+			std::atomic<int> readers{ 0 };
+			std::vector<Matrix4x4> transforms;
+			int count = 0;
+			unsigned long long frame = 0;
+		};
+
+		int capacity;
+		std::vector<Slot> slots; // maxReaders + 2 slots, so one is always free for the writer
+		alignas(64) std::atomic<int> latest; // slot of the latest published frame, -1 before the first publish
+		int writing; // slot returned by the last BeginFrame
+		unsigned long long frameCount;
+	};
+
+	// Bump allocator for per-frame scratch memory : allocating is a pointer increment, nothing is freed individually
+	// and Reset releases everything at once. Memory handed out since the last Reset must not be used after it.
+	class FrameArena : public std::pmr::memory_resource
+	{
+	public:
+		FrameArena(size_t _capacity, std::pmr::memory_resource* _upstream = std::pmr::new_delete_resource());
+		~FrameArena();
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		void Reset(); // rewinds the arena, grows it first if the last frame did not fit
+		size_t Capacity() const;
+		size_t Used() const; // bytes handed out since the last Reset, overflow included
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+		struct Overflow
+		{
+			void* p;
+			size_t bytes;
+			size_t alignment;
+		};
+
+		std::pmr::memory_resource* upstream;
+		char* buffer;
+		size_t capacity;
+		size_t offset;
+		std::vector<Overflow> overflows; // allocations that did not fit in the buffer, freed by Reset
+		size_t overflowBytes;
+	};
+
+	// Binary dataset files : a 64 bytes header, arrays of floats, Vector2/3/4 or matrices aligned on 64 bytes,
+	// then a table describing every array. Arrays are stored as the library lays them out in memory (AoS),
+	// or as one float lane per component (SoA), so a mapped file is used in place without any parsing.
+	enum class DatasetType : uint32_t { Float, Vector2, Vector3, Vector4, Matrix2x2, Matrix3x3, Matrix4x4 };
+	enum class DatasetLayout : uint32_t { AoS, SoA };
+
+	constexpr uint32_t DatasetVersion = 1;
+
+	int DatasetComponents(DatasetType type); // number of floats in one item of the type
+
+	template <class T> struct DatasetTypeOf;
+	template <> struct DatasetTypeOf<float> { static constexpr DatasetType Value = DatasetType::Float; };
+	template <> struct DatasetTypeOf<Vector2> { static constexpr DatasetType Value = DatasetType::Vector2; };
+	template <> struct DatasetTypeOf<Vector3> { static constexpr DatasetType Value = DatasetType::Vector3; };
+	template <> struct DatasetTypeOf<Vector4> { static constexpr DatasetType Value = DatasetType::Vector4; };
+	template <> struct DatasetTypeOf<Matrix2x2> { static constexpr DatasetType Value = DatasetType::Matrix2x2; };
+	template <> struct DatasetTypeOf<Matrix3x3> { static constexpr DatasetType Value = DatasetType::Matrix3x3; };
+	template <> struct DatasetTypeOf<Matrix4x4> { static constexpr DatasetType Value = DatasetType::Matrix4x4; };
+
+	// table entry of an array, as stored in the file
+	struct DatasetArray
+	{
+		char name[32]; // nul terminated
+		DatasetType type;
+		DatasetLayout layout;
+		uint64_t count; // number of items
+		uint64_t offset; // from the start of the file
+		uint64_t laneStride; // SoA only : bytes between two component lanes
+	};
+
+	// read-only view of items stored in a dataset
+	template <class T>
+	struct DatasetSpan
+	{
+		const T* data = nullptr;
+		size_t count = 0;
+
+		const T* begin() const { return data; }
+		const T* end() const { return data + count; }
+		const T& operator[](size_t index) const { return data[index]; }
+		bool Empty() const { return count == 0; }
+	};
+
+	// Dataset file mapped in memory, its arrays stay valid until Close
+	class Dataset
+	{
+	public:
+		Dataset() = default;
+		~Dataset();
+		Dataset(const Dataset&) = delete;
+		Dataset& operator=(const Dataset&) = delete;
+
+		bool Open(const std::string& path); // maps the file and checks its header and table, false on failure
+		void Close();
+
+		int ArrayCount() const;
+		const DatasetArray& ArrayAt(int index) const;
+		const DatasetArray* Find(const std::string& name) const; // nullptr if there is no such array
+
+		// items of an AoS array, empty if the array is missing, of another type or SoA
+		template <class T> DatasetSpan<T> Array(const std::string& name) const
+		{
+			const DatasetArray* a = Find(name);
+			if (!a || a->type != DatasetTypeOf<T>::Value || a->layout != DatasetLayout::AoS)
+				return {};
+			return { reinterpret_cast<const T*>(base + a->offset), (size_t)a->count };
+		}
+
+		// lane of one component (x = 0, y = 1... or a matrix element) of a SoA array, empty if there is none
+		DatasetSpan<float> Lane(const std::string& name, int component) const;
+
+	private:
+		const char* base = nullptr;
+		size_t size = 0;
+		const DatasetArray* table = nullptr;
+		int arrayCount = 0;
+		void* file = nullptr; // platform handles of the mapping
+		void* mapping = nullptr;
+	};
+
+	// Writes a dataset file while the data is produced, nothing but the table is kept in memory
+	class DatasetWriter
+	{
+	public:
+		DatasetWriter() = default;
+		~DatasetWriter(); // closes the file if needed
+
+		bool Open(const std::string& path);
+		// starts a new array, SoA arrays need their count up front so every lane can be placed
+		void BeginArray(const std::string& name, DatasetType type, DatasetLayout layout = DatasetLayout::AoS, uint64_t count = 0);
+		template <class T> void Append(const T* items, size_t count)
+		{
+			if (current < 0 || arrays[current].type != DatasetTypeOf<T>::Value) {
+				std::cout << "Cannot append items of another type to the array" << std::endl;
+				return;
+			}
+			AppendFloats(reinterpret_cast<const float*>(items), count);
+		}
+		void EndArray();
+		bool Close(); // writes the table and the header, false if any write failed
+
+	private:
+		void AppendFloats(const float* items, size_t count);
+		void PadTo(uint64_t position);
+
+		std::ofstream stream;
+		std::vector<DatasetArray> arrays;
+		int current = -1; // array being written
+		uint64_t written = 0; // items of the current array
+		uint64_t position = 0; // end of the data written so far
+	};
+
+	// Streams Vector3 points through a transform chunk by chunk : a reader thread fills chunks from the source,
+	// the calling thread transforms them and a writer thread hands them to the sink, so I/O and compute overlap
+	class PointPipeline
+	{
+	public:
+		using Source = std::function<size_t(Vector3* points, size_t capacity)>; // fills up to capacity points, 0 at the end
+		using Sink = std::function<bool(const Vector3* points, size_t count)>; // returns false to stop the pipeline
+
+		PointPipeline(size_t _chunkSize = 1 << 16, int _chunkCount = 3);
+		~PointPipeline() = default;
+
+		void SetTransform(const Matrix4x4& m);
+		void SetTransform(const Matrix4x4* chain, int count); // chain[0] is applied first, the chain is multiplied once here
+		const Matrix4x4& Transform() const;
+
+		uint64_t Run(const Source& source, const Sink& sink); // returns the number of points written
+		uint64_t Run(std::istream& in, std::ostream& out); // raw Vector3 arrays, as written by DatasetWriter in AoS
+
+	private:
+		Matrix4x4 transform;
+		size_t chunkSize; // points per chunk
+		int chunkCount; // chunks in flight, 3 lets reading, transforming and writing all run at once
+	};
+
+	// Compressed storage : half float vectors, smallest-three quaternions and vectors quantized inside bounds
+	// (per clip for instance). The bulk Pack / Unpack run on SIMD lanes, only the bit fields are handled in scalar.
+	uint16_t FloatToHalf(float f); // rounds to nearest even, keeps infinities and NaN
+	float HalfToFloat(uint16_t h);
+
+	// 6 bytes Vector3, about 3 significant digits
+	struct HalfVector3
+	{
+		uint16_t x;
+		uint16_t y;
+		uint16_t z;
+
+		static void Pack(const Vector3* vectors, HalfVector3* packed, size_t count);
+		static void Unpack(const HalfVector3* packed, Vector3* vectors, size_t count);
+	};
+
+	// Unit quaternion as its three smallest components, the largest one is rebuilt from the norm. q and -q being
+	// the same rotation, the sign is chosen so the dropped component is positive.
+	// 32 bits : 2 bits of index and 3 x 10 bits (about 1e-3 precision)
+	struct PackedQuaternion32
+	{
+		uint32_t bits;
+
+		static void Pack(const Quaternion* quaternions, PackedQuaternion32* packed, size_t count);
+		static void Unpack(const PackedQuaternion32* packed, Quaternion* quaternions, size_t count);
+	};
+
+	// 48 bits : 2 bits of index and 3 x 15 bits (about 4e-5 precision)
+	struct PackedQuaternion48
+	{
+		uint16_t bits[3];
+
+		static void Pack(const Quaternion* quaternions, PackedQuaternion48* packed, size_t count);
+		static void Unpack(const PackedQuaternion48* packed, Quaternion* quaternions, size_t count);
+	};
+
+	// box the quantized vectors are stored in, such as the range of a clip's translations
+	struct QuantizationBounds
+	{
+		Vector3 min;
+		Vector3 max;
+
+		static QuantizationBounds FromPoints(const Vector3* points, size_t count);
+	};
+
+	// Vector3 as 16 bits per axis inside QuantizationBounds, values outside are clamped
+	struct QuantizedVector3
+	{
+		uint16_t x;
+		uint16_t y;
+		uint16_t z;
+
+		static void Pack(const Vector3* vectors, QuantizedVector3* packed, size_t count, const QuantizationBounds& bounds);
+		static void Unpack(const QuantizedVector3* packed, Vector3* vectors, size_t count, const QuantizationBounds& bounds);
+	};
+
+	// 18 bytes translation * rotation * scale transform, instead of the 64 bytes of a Matrix4x4 (shear is lost)
+	struct PackedTransform
+	{
+		PackedQuaternion48 rotation;
+		QuantizedVector3 translation;
+		HalfVector3 scale;
+
+		static void Pack(const Matrix4x4* transforms, PackedTransform* packed, size_t count, const QuantizationBounds& translationBounds);
+		static void Unpack(const PackedTransform* packed, Matrix4x4* transforms, size_t count, const QuantizationBounds& translationBounds);
+	};
+
+	// Keyframe animation : tracks of Vector2/3/4 with step, linear, cubic Hermite, Catmull-Rom or Bezier
+	// interpolation, and rotation tracks of quaternions. Key times are kept apart from the values so the
+	// search only walks floats, and a TrackCursor remembers the last segment for monotonic playback.
+	enum class Interpolation { Step, Linear, CubicHermite, CatmullRom, Bezier };
+
+	// segment a track was last sampled in, one per playing track
+	struct TrackCursor
+	{
+		int key = 0;
+	};
+
+	// key times shared by every kind of track
+	class TrackTimes
+	{
+	public:
+		std::vector<float> times; // increasing key times
+
+		int KeyCount() const;
+		float StartTime() const;
+		float EndTime() const;
+
+	protected:
+		// finds the segment holding time (clamped to the keys) and the position u in [0, 1] inside it
+		int Locate(float time, TrackCursor& cursor, float& u) const;
+	};
+
+	template <class V>
+	class Track : public TrackTimes
+	{
+	public:
+		Interpolation interpolation;
+		std::vector<V> values; // one per key
+		// two per key : the in and out tangents (per second) for CubicHermite, the in and out control points for Bezier,
+		// empty for the other modes, which never read them
+		std::vector<V> tangents;
+
+		Track(Interpolation _interpolation = Interpolation::Linear);
+		~Track() = default;
+
+		bool HasTangents() const; // true for the CubicHermite and Bezier modes
+		void AddKey(float time, const V& value); // keys must be added in increasing time order, zero tangents if any
+		void AddKey(float time, const V& value, const V& in, const V& out); // with Hermite tangents or Bezier control points
+
+		V Sample(float time) const;
+		V Sample(float time, TrackCursor& cursor) const;
+		// samples tracks[i] at times[i] into results[i], cursors may be nullptr. A convenience loop over Sample : the
+		// cost of a sample is its key search and the loads of its keys, which tracks can't share in SIMD lanes
+		static void SampleBatch(const Track* tracks, const float* times, V* results, TrackCursor* cursors, int count);
+	};
+
+	extern template class Track<Vector2>;
+	extern template class Track<Vector3>;
+	extern template class Track<Vector4>;
+
+	// Rotation keys interpolated with Slerp (Linear and the cubic modes) or held (Step)
+	class RotationTrack : public TrackTimes
+	{
+	public:
+		Interpolation interpolation;
+		std::vector<Quaternion> values;
+
+		RotationTrack(Interpolation _interpolation = Interpolation::Linear);
+		~RotationTrack() = default;
+
+		void AddKey(float time, const Quaternion& value);
+
+		Quaternion Sample(float time) const;
+		Quaternion Sample(float time, TrackCursor& cursor) const;
+		// like Track::SampleBatch, a convenience loop over Sample
+		static void SampleBatch(const RotationTrack* tracks, const float* times, Quaternion* results, TrackCursor* cursors, int count);
+	};
+
+	// Rigid transform as a unit dual quaternion : real is the rotation, dual = 0.5 * translation * real
+	class DualQuaternion
+	{
+	public:
+		Quaternion real;
+		Quaternion dual;
+
+		DualQuaternion(); // identity
+		DualQuaternion(const Quaternion& rotation, const Vector3& translation);
+		~DualQuaternion() = default;
+
+		static DualQuaternion FromMatrix(const Matrix4x4& m); // rotation and translation of m, its scale is dropped
+		static void FromMatrices(const Matrix4x4* matrices, DualQuaternion* result, int count);
+		static Vector3 TransformPoint(const DualQuaternion& dq, const Vector3& p);
+		static Vector3 TransformVector(const DualQuaternion& dq, const Vector3& v); // rotation only
+	};
+
+	// Vertex streams of a skinned mesh : four bone influences per vertex, weights summing to 1
+	// (unused influences have a weight of 0 and any valid index)
+	struct SkinStreams
+	{
+		const Vector3* positions;
+		const Vector3* normals; // nullptr to skin positions only
+		const uint16_t* boneIndices; // 4 per vertex, indices in the palette
+		const float* boneWeights; // 4 per vertex
+		int vertexCount;
+	};
+
+	// Skinning kernels, a register of vertices at a time with the bones gathered per lane, split in chunks over
+	// threadCount threads (0 uses every hardware thread) for large meshes
+	class Skinning
+	{
+	public:
+		// linear blend skinning : blends the 3x4 part of the bone matrices, normals are renormalized
+		static void LinearBlend(const SkinStreams& mesh, const Matrix4x4* palette, Vector3* positions, Vector3* normals, int threadCount = 0);
+		// dual quaternion skinning : no candy-wrapper collapse on twisting joints, bones must be rigid
+		static void DualQuaternionBlend(const SkinStreams& mesh, const DualQuaternion* palette, Vector3* positions, Vector3* normals, int threadCount = 0);
+	};
+
+	// A Vector3 stream stored as one float lane per component
+	struct Vector3Lanes
+	{
+		float* x;
+		float* y;
+		float* z;
+	};
+
+	// Particle state as structure of arrays, every lane holds count floats
+	struct ParticleStreams
+	{
+		Vector3Lanes positions;
+		Vector3Lanes velocities; // Euler integrators only
+		Vector3Lanes previous; // Verlet only : positions at the previous step
+		int count;
+	};
+
+	struct ParticleForces
+	{
+		Vector3 gravity;
+		float drag = 0.f; // acceleration opposed to the velocity, per unit of velocity
+		bool killOutOfBounds = false; // removes the particles leaving [boundsMin, boundsMax]
+		Vector3 boundsMin;
+		Vector3 boundsMax;
+	};
+
+	// Particle integrators over SoA streams, a register of particles at a time, split in chunks over threadCount
+	// threads (0 uses every hardware thread) for large systems. Killed particles are replaced by the last
+	// alive ones, so the order is not kept, and every integrator returns the new particle count.
+	class Particles
+	{
+	public:
+		// x += v * dt, then v += a * dt
+		static int ExplicitEuler(ParticleStreams& particles, const ParticleForces& forces, float dt, int threadCount = 0);
+		// v += a * dt, then x += v * dt : stable for the same time steps as Verlet, at the cost of Euler
+		static int SemiImplicitEuler(ParticleStreams& particles, const ParticleForces& forces, float dt, int threadCount = 0);
+		// x += (x - previous) * (1 - drag * dt) + gravity * dt * dt, previous keeps the old position
+		static int Verlet(ParticleStreams& particles, const ParticleForces& forces, float dt, int threadCount = 0);
+	};
+
+	// Instruction sets the kernels are built for, from the narrowest to the widest
+	enum class SimdLevel { Scalar, SSE, AVX2, AVX512 };
+
+	// The library is built for every SimdLevel of the target, the batch kernels, 4x4 products and GEMM run the
+	// widest one the CPU and OS support, picked once on first use
+	class Cpu
+	{
+	public:
+		static SimdLevel Detected(); // widest level this machine supports
+		static SimdLevel Active(); // level the kernels run
+		// forces a level, for tests and benchmarks, returns false and changes nothing if the machine lacks it
+		static bool Force(SimdLevel level);
+		static const char* Name(SimdLevel level);
+	};
+
+	// calls of one operation over every thread, cycles being the time stamp counter ticks spent in it (nanoseconds
+	// where there is none), nested operations included, while the timing was on
+	struct ProfileEntry
+	{
+		std::string name;
+		uint64_t calls;
+		uint64_t cycles;
+	};
+
+	// Counters of the instrumented build : with BABOON_PROFILE defined when building the library, every public
+	// operation (accessors, printing and memory management aside) counts its calls on the calling thread, and its
+	// cycles while the timing is on. Without it nothing is instrumented, Snapshot is empty and the operations cost
+	// what they did. The constexpr builders are never counted, they are meant to be folded at compile time, and the
+	// operators defined in this header count their calls only (see BABOON_INLINE_PROFILE).
+	class Profiler
+	{
+	public:
+		static bool Enabled(); // whether the library was built with BABOON_PROFILE
+		static void SetTiming(bool enabled); // off by default, reading the clock twice a call costs more than counting
+		static bool Timing();
+
+		// operations called since the last Reset, of the threads still running and of the ended ones, by name
+		static std::vector<ProfileEntry> Snapshot();
+		// calls running on other threads meanwhile count either before or after it, never twice
+		static void Reset();
+
+		static std::string ToJson(const std::vector<ProfileEntry>& entries);
+		static bool WriteJson(const std::string& path); // the current snapshot, false if the file can't be written
+	};
+
+	// Fixed point number raw / 2^FractionBits, for simulations that must give bit-identical results on every machine
+	// and compiler (lockstep multiplayer) : integer arithmetic only, sums wrap on overflow, products round toward
+	// negative infinity and quotients toward zero, conversions from floats saturate. Fixed16 is Q16.16 (steps of
+	// 1.5e-5 up to 32768), Fixed32 is Q32.32.
+	// Q32.32 products and quotients go through 128 bits, __int128 where the compiler has it, the same bits otherwise.
+	template <class Raw, int FractionBits>
+	class Fixed
+	{
+	public:
+		using Unsigned = std::make_unsigned_t<Raw>;
+		static constexpr Raw One = (Raw)((Unsigned)1 << FractionBits);
+
+		Raw raw;
+
+		constexpr Fixed() : raw(0) {}
+		constexpr Fixed(int i) : raw((Raw)((Unsigned)(Raw)i << FractionBits)) {}
+
+		static constexpr Fixed FromRaw(Raw r) { Fixed f; f.raw = r; return f; }
+		// nearest value, ties to even, saturated to the range of Raw and 0 for NaN (the batch conversions do the same) :
+		// the only step where floats enter the simulation
+		static Fixed FromFloat(float f) { return FromDouble((double)f); }
+		static Fixed FromDouble(double d);
+		float ToFloat() const { return (float)raw * (1.f / (float)One); }
+		double ToDouble() const { return (double)raw / (double)One; }
+		constexpr int ToInt() const { return (int)(raw >> FractionBits); } // rounds toward negative infinity
+
+		// batch conversions, SIMD for Fixed16
+		static void FromFloats(const float* f, Fixed* fixed, size_t count);
+		static void ToFloats(const Fixed* fixed, float* f, size_t count);
+
+		static constexpr Raw Multiply(Raw a, Raw b);
+		static constexpr Raw Divide(Raw a, Raw b); // b must not be 0
+
+		friend constexpr Fixed operator+(Fixed a, Fixed b) { return FromRaw((Raw)((Unsigned)a.raw + (Unsigned)b.raw)); }
+		friend constexpr Fixed operator-(Fixed a, Fixed b) { return FromRaw((Raw)((Unsigned)a.raw - (Unsigned)b.raw)); }
+		friend constexpr Fixed operator-(Fixed a) { return FromRaw((Raw)(0 - (Unsigned)a.raw)); }
+		friend constexpr Fixed operator*(Fixed a, Fixed b) { return FromRaw(Multiply(a.raw, b.raw)); }
+		friend constexpr Fixed operator/(Fixed a, Fixed b) { return FromRaw(Divide(a.raw, b.raw)); }
+		friend constexpr Fixed& operator+=(Fixed& a, Fixed b) { return a = a + b; }
+		friend constexpr Fixed& operator-=(Fixed& a, Fixed b) { return a = a - b; }
+		friend constexpr Fixed& operator*=(Fixed& a, Fixed b) { return a = a * b; }
+		friend constexpr Fixed& operator/=(Fixed& a, Fixed b) { return a = a / b; }
+		friend constexpr bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+		friend constexpr bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+		friend constexpr bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+		friend constexpr bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+		friend constexpr bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+		friend constexpr bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+	private:
+		// signed 64 x 64 -> 128 bit product as two's complement halves
+		static constexpr void Product128(int64_t a, int64_t b, uint64_t& high, uint64_t& low);
+	};
+
+	using Fixed16 = Fixed<int32_t, 16>;
+	using Fixed32 = Fixed<int64_t, 32>;
+
+	template <class Raw, int FractionBits>
+	constexpr void Fixed<Raw, FractionBits>::Product128(int64_t a, int64_t b, uint64_t& high, uint64_t& low)
+	{
+		uint64_t ua = (uint64_t)a, ub = (uint64_t)b;
+		uint64_t al = ua & 0xffffffffu, ah = ua >> 32, bl = ub & 0xffffffffu, bh = ub >> 32;
+		uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+		uint64_t middle = (ll >> 32) + (lh & 0xffffffffu) + (hl & 0xffffffffu);
+		low = (middle << 32) | (ll & 0xffffffffu);
+		// unsigned product, then the signed correction of the high half
+		high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+		high -= (a < 0 ? ub : 0) + (b < 0 ? ua : 0);
+	}
+
+	template <class Raw, int FractionBits>
+	Fixed<Raw, FractionBits> Fixed<Raw, FractionBits>::FromDouble(double d)
+	{
+		// rounded first, so a value rounding up to 2^(bits - 1) saturates too
+		const double limit = (double)((Unsigned)1 << (sizeof(Raw) * 8 - 1));
+		double r = std::nearbyint(d * (double)One);
+		if (r != r)
+			return Fixed();
+		if (r >= limit)
+			return FromRaw(std::numeric_limits<Raw>::max());
+		if (r <= -limit)
+			return FromRaw(std::numeric_limits<Raw>::min());
+		return FromRaw((Raw)r);
+	}
+
+	template <class Raw, int FractionBits>
+	constexpr Raw Fixed<Raw, FractionBits>::Multiply(Raw a, Raw b)
+	{
+		if constexpr (sizeof(Raw) <= 4) {
+			return (Raw)(((int64_t)a * b) >> FractionBits);
+		}
+		else {
+#if defined(__SIZEOF_INT128__)
+			return (Raw)(((__int128)a * b) >> FractionBits);
+#else
+			uint64_t high = 0, low = 0;
+			Product128(a, b, high, low);
+			return (Raw)((high << (64 - FractionBits)) | (low >> FractionBits));
+#endif
+		}
+	}
+
+	template <class Raw, int FractionBits>
+	constexpr Raw Fixed<Raw, FractionBits>::Divide(Raw a, Raw b)
+	{
+		if constexpr (sizeof(Raw) <= 4) {
+			return (Raw)((int64_t)a * One / b);
+		}
+		else {
+#if defined(__SIZEOF_INT128__)
+			return (Raw)((__int128)a * One / b);
+#else
+			// long division of the magnitudes, a * 2^FractionBits being up to 128 bits, the quotient wraps to 64
+			uint64_t ua = a < 0 ? 0 - (uint64_t)a : (uint64_t)a, ub = b < 0 ? 0 - (uint64_t)b : (uint64_t)b;
+			uint64_t high = ua >> (64 - FractionBits), low = ua << FractionBits;
+			uint64_t remainder = 0, quotient = 0;
+			for (int i = 127; i >= 0; i--)
+			{
+				uint64_t bit = i >= 64 ? (high >> (i - 64)) & 1 : (low >> i) & 1;
+				bool carry = (remainder >> 63) != 0;
+				remainder = (remainder << 1) | bit;
+				quotient <<= 1;
+				if (carry || remainder >= ub) {
+					remainder -= ub;
+					quotient |= 1;
+				}
+			}
+			return (Raw)((a < 0) != (b < 0) ? 0 - quotient : quotient);
+#endif
+		}
+	}
+
+	// Deterministic functions of fixed point numbers : the trigonometry interpolates a quarter wave table of 4096
+	// steps built at compile time (error below 2e-8), the square root is exact to the last bit (rounded down).
+	template <class Raw, int FractionBits> Fixed<Raw, FractionBits> Sin(Fixed<Raw, FractionBits> angle);
+	template <class Raw, int FractionBits> Fixed<Raw, FractionBits> Cos(Fixed<Raw, FractionBits> angle);
+	template <class Raw, int FractionBits> void SinCos(Fixed<Raw, FractionBits> angle, Fixed<Raw, FractionBits>& sine, Fixed<Raw, FractionBits>& cosine);
+	template <class Raw, int FractionBits> Fixed<Raw, FractionBits> Sqrt(Fixed<Raw, FractionBits> x); // 0 for negative numbers
+	template <class Raw, int FractionBits> Fixed<Raw, FractionBits> Abs(Fixed<Raw, FractionBits> x);
+
+	template <class F>
+	class FixedVector2
+	{
+	public:
+		F x;
+		F y;
+
+		constexpr FixedVector2() : x(), y() {}
+		constexpr FixedVector2(F _x, F _y) : x(_x), y(_y) {}
+
+		static FixedVector2 FromVector(const Vector2& v);
+		Vector2 ToVector() const;
+
+		static F DotProduct(FixedVector2 v1, FixedVector2 v2);
+		static F CrossProduct(FixedVector2 v1, FixedVector2 v2);
+		static F SquaredNorm(FixedVector2 v);
+		static F Norm(FixedVector2 v);
+		static FixedVector2 Normalize(FixedVector2 v); // the zero vector stays zero
+		static FixedVector2 Rotate(FixedVector2 p, F theta, FixedVector2 anchor = FixedVector2()); // rotates a point around another point
+
+		friend constexpr FixedVector2 operator+(FixedVector2 v1, FixedVector2 v2) { return { v1.x + v2.x, v1.y + v2.y }; }
+		friend constexpr FixedVector2 operator-(FixedVector2 v1, FixedVector2 v2) { return { v1.x - v2.x, v1.y - v2.y }; }
+		friend constexpr FixedVector2 operator-(FixedVector2 v) { return { -v.x, -v.y }; }
+		friend constexpr FixedVector2 operator*(FixedVector2 v, F f) { return { v.x * f, v.y * f }; }
+		friend constexpr FixedVector2 operator*(F f, FixedVector2 v) { return { v.x * f, v.y * f }; }
+		friend constexpr FixedVector2 operator/(FixedVector2 v, F f) { return { v.x / f, v.y / f }; }
+		friend constexpr bool operator==(FixedVector2 v1, FixedVector2 v2) { return v1.x == v2.x && v1.y == v2.y; }
+	};
+
+	template <class F>
+	class FixedVector3
+	{
+	public:
+		F x;
+		F y;
+		F z;
+
+		constexpr FixedVector3() : x(), y(), z() {}
+		constexpr FixedVector3(F _x, F _y, F _z) : x(_x), y(_y), z(_z) {}
+
+		static FixedVector3 FromVector(const Vector3& v);
+		Vector3 ToVector() const;
+
+		static F DotProduct(FixedVector3 v1, FixedVector3 v2);
+		static FixedVector3 CrossProduct(FixedVector3 v1, FixedVector3 v2);
+		static F SquaredNorm(FixedVector3 v);
+		static F Norm(FixedVector3 v);
+		static FixedVector3 Normalize(FixedVector3 v); // the zero vector stays zero
+		static FixedVector3 Rotate(FixedVector3 p, F thetaX, F thetaY, F thetaZ); // rotates a point with the 3D rotation matrix
+
+		friend constexpr FixedVector3 operator+(FixedVector3 v1, FixedVector3 v2) { return { v1.x + v2.x, v1.y + v2.y, v1.z + v2.z }; }
+		friend constexpr FixedVector3 operator-(FixedVector3 v1, FixedVector3 v2) { return { v1.x - v2.x, v1.y - v2.y, v1.z - v2.z }; }
+		friend constexpr FixedVector3 operator-(FixedVector3 v) { return { -v.x, -v.y, -v.z }; }
+		friend constexpr FixedVector3 operator*(FixedVector3 v, F f) { return { v.x * f, v.y * f, v.z * f }; }
+		friend constexpr FixedVector3 operator*(F f, FixedVector3 v) { return { v.x * f, v.y * f, v.z * f }; }
+		friend constexpr FixedVector3 operator/(FixedVector3 v, F f) { return { v.x / f, v.y / f, v.z / f }; }
+		friend constexpr bool operator==(FixedVector3 v1, FixedVector3 v2) { return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z; }
+	};
+
+	template <class F>
+	class FixedMatrix2x2
+	{
+	public:
+		std::array<F, 4> elements; // row-major
+
+		constexpr FixedMatrix2x2(bool identity = false) : elements{ F(identity ? 1 : 0), F(), F(), F(identity ? 1 : 0) } {}
+		constexpr FixedMatrix2x2(std::array<F, 4> _elements) : elements(_elements) {}
+
+		static FixedMatrix2x2 FromMatrix(const Matrix2x2& m);
+		Matrix2x2 ToMatrix() const;
+
+		static FixedMatrix2x2 Multiply(const FixedMatrix2x2& mat1, const FixedMatrix2x2& mat2);
+		static FixedMatrix2x2 Rotation(F theta);
+
+		friend FixedMatrix2x2 operator*(const FixedMatrix2x2& mat1, const FixedMatrix2x2& mat2) { return Multiply(mat1, mat2); }
+		friend constexpr FixedVector2<F> operator*(const FixedMatrix2x2& m, FixedVector2<F> v)
+		{
+			return { m.elements[0] * v.x + m.elements[1] * v.y, m.elements[2] * v.x + m.elements[3] * v.y };
+		}
+	};
+
+	template <class F>
+	class FixedMatrix3x3
+	{
+	public:
+		std::array<F, 9> elements; // row-major
+
+		constexpr FixedMatrix3x3(bool identity = false) : elements{ F(identity ? 1 : 0), F(), F(), F(), F(identity ? 1 : 0), F(), F(), F(), F(identity ? 1 : 0) } {}
+		constexpr FixedMatrix3x3(std::array<F, 9> _elements) : elements(_elements) {}
+
+		static FixedMatrix3x3 FromMatrix(const Matrix3x3& m);
+		Matrix3x3 ToMatrix() const;
+
+		void Transpose();
+
+		static FixedMatrix3x3 Multiply(const FixedMatrix3x3& mat1, const FixedMatrix3x3& mat2);
+		// same conventions as the Matrix3x3 rotations
+		static FixedMatrix3x3 Rotation(F thetaX, F thetaY, F thetaZ);
+		static FixedMatrix3x3 RotationX(F thetaX);
+		static FixedMatrix3x3 RotationY(F thetaY);
+		static FixedMatrix3x3 RotationZ(F thetaZ);
+		// m * v for count vectors, SIMD for Fixed16 with the same bits as the scalar product, result may alias vectors
+		static void TransformVectors(const FixedMatrix3x3& m, const FixedVector3<F>* vectors, FixedVector3<F>* result, size_t count);
+
+		friend FixedMatrix3x3 operator*(const FixedMatrix3x3& mat1, const FixedMatrix3x3& mat2) { return Multiply(mat1, mat2); }
+		friend constexpr FixedVector3<F> operator*(const FixedMatrix3x3& m, FixedVector3<F> v)
+		{
+			return {
+				m.elements[0] * v.x + m.elements[1] * v.y + m.elements[2] * v.z,
+				m.elements[3] * v.x + m.elements[4] * v.y + m.elements[5] * v.z,
+				m.elements[6] * v.x + m.elements[7] * v.y + m.elements[8] * v.z };
+		}
+	};
+
+	extern template class Fixed<int32_t, 16>;
+	extern template class Fixed<int64_t, 32>;
+	extern template class FixedVector2<Fixed16>;
+	extern template class FixedVector2<Fixed32>;
+	extern template class FixedVector3<Fixed16>;
+	extern template class FixedVector3<Fixed32>;
+	extern template class FixedMatrix2x2<Fixed16>;
+	extern template class FixedMatrix2x2<Fixed32>;
+	extern template class FixedMatrix3x3<Fixed16>;
+	extern template class FixedMatrix3x3<Fixed32>;
+}
@@ -0,0 +1,154 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Hints.h"
+#include "Profile.h"
+
+namespace Baboon
+{
+	namespace
+	{
+		// cofactor matrix of the linear part, row-major, and its determinant
+		float Cofactors(const std::array<float, 12>& e, float* c)
+		{
+			c[0] = e[5] * e[10] - e[6] * e[9];
+			c[1] = e[6] * e[8] - e[4] * e[10];
+			c[2] = e[4] * e[9] - e[5] * e[8];
+			c[3] = e[2] * e[9] - e[1] * e[10];
+			c[4] = e[0] * e[10] - e[2] * e[8];
+			c[5] = e[1] * e[8] - e[0] * e[9];
+			c[6] = e[1] * e[6] - e[2] * e[5];
+			c[7] = e[2] * e[4] - e[0] * e[6];
+			c[8] = e[0] * e[5] - e[1] * e[4];
+			return e[0] * c[0] + e[1] * c[1] + e[2] * c[2];
+		}
+	}
+
+	void Affine3::Print()
+	{
+		std::array<Vector4, 3> lines = {
+			Vector4(elements[0], elements[1], elements[2], elements[3]),
+			Vector4(elements[4], elements[5], elements[6], elements[7]),
+			Vector4(elements[8], elements[9], elements[10], elements[11])
+		};
+		std::cout << "Affine 3x4 : " << std::endl;
+
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			lines[i].BlankPrint();
+		}
+
+		std::cout << std::endl;
+	}
+
+	bool Affine3::Inverse()
+	{
+		return Inverse(*this);
+	}
+
+	bool Affine3::Inverse(Affine3& result) const
+	{
+		BABOON_PROFILE_SCOPE("Affine3::Inverse");
+		float c[9];
+		float det = Cofactors(elements, c);
+		if (BABOON_UNLIKELY(det == 0))
+			return false;
+
+		// linear part C^T / det, translation -inverse * t
+		float invDet = 1.f / det;
+		float x = elements[3], y = elements[7], z = elements[11];
+		result.elements = {
+			c[0] * invDet, c[3] * invDet, c[6] * invDet, -(c[0] * x + c[3] * y + c[6] * z) * invDet,
+			c[1] * invDet, c[4] * invDet, c[7] * invDet, -(c[1] * x + c[4] * y + c[7] * z) * invDet,
+			c[2] * invDet, c[5] * invDet, c[8] * invDet, -(c[2] * x + c[5] * y + c[8] * z) * invDet
+		};
+		return true;
+	}
+
+	Affine3 Affine3::RigidInverse() const
+	{
+		BABOON_PROFILE_SCOPE("Affine3::RigidInverse");
+		const std::array<float, 12>& e = elements;
+		return Affine3({
+			e[0], e[4], e[8], -(e[0] * e[3] + e[4] * e[7] + e[8] * e[11]),
+			e[1], e[5], e[9], -(e[1] * e[3] + e[5] * e[7] + e[9] * e[11]),
+			e[2], e[6], e[10], -(e[2] * e[3] + e[6] * e[7] + e[10] * e[11])
+			});
+	}
+
+	float Affine3::Determinant() const
+	{
+		BABOON_PROFILE_SCOPE("Affine3::Determinant");
+		const std::array<float, 12>& e = elements;
+		return e[0] * (e[5] * e[10] - e[6] * e[9]) - e[1] * (e[4] * e[10] - e[6] * e[8]) + e[2] * (e[4] * e[9] - e[5] * e[8]);
+	}
+
+	Matrix3x3 Affine3::NormalMatrix() const
+	{
+		BABOON_PROFILE_SCOPE("Affine3::NormalMatrix");
+		// (L^-1)^T = C / det, C being the cofactor matrix : no inverse nor transpose
+		Matrix3x3 normal;
+		float det = Cofactors(elements, normal.elements.data());
+		if (BABOON_UNLIKELY(det == 0))
+			return normal;
+
+		float invDet = 1.f / det;
+		for (int i = 0; i < 9; i++)
+			normal.elements[i] *= invDet;
+		return normal;
+	}
+
+	Affine3 Affine3::Multiply(const Affine3& a1, const Affine3& a2)
+	{
+		BABOON_PROFILE_SCOPE("Affine3::Multiply");
+		// the implicit bottom rows (0, 0, 0, 1) only add a1's translation
+		const std::array<float, 12>& a = a1.elements;
+		const std::array<float, 12>& b = a2.elements;
+		Affine3 result;
+		for (int r = 0; r < 3; ++r) {
+			const float* row = a.data() + r * 4;
+			for (int c = 0; c < 4; ++c)
+				result.elements[r * 4 + c] = row[0] * b[c] + row[1] * b[4 + c] + row[2] * b[8 + c];
+			result.elements[r * 4 + 3] += row[3];
+		}
+		return result;
+	}
+
+	Vector3 Affine3::TransformPoint(const Affine3& a, const Vector3& p)
+	{
+		BABOON_PROFILE_SCOPE("Affine3::TransformPoint");
+		const std::array<float, 12>& e = a.elements;
+		return Vector3(
+			e[0] * p.x + e[1] * p.y + e[2] * p.z + e[3],
+			e[4] * p.x + e[5] * p.y + e[6] * p.z + e[7],
+			e[8] * p.x + e[9] * p.y + e[10] * p.z + e[11]);
+	}
+
+	Vector3 Affine3::TransformVector(const Affine3& a, const Vector3& v)
+	{
+		BABOON_PROFILE_SCOPE("Affine3::TransformVector");
+		const std::array<float, 12>& e = a.elements;
+		return Vector3(
+			e[0] * v.x + e[1] * v.y + e[2] * v.z,
+			e[4] * v.x + e[5] * v.y + e[6] * v.z,
+			e[8] * v.x + e[9] * v.y + e[10] * v.z);
+	}
+
+	void Affine3::TransformPoints(const Affine3& a, const Vector3* points, Vector3* result, size_t count)
+	{
+		BABOON_ZONE("Affine3::TransformPoints");
+		// the kernel sees the (0, 0, 0, 1) bottom row and skips the w division
+		Kernels().transformPoints(a.ToMatrix4x4(), points, result, count);
+	}
+
+	Affine3 operator*(const Affine3& a1, const Affine3& a2)
+	{
+		BABOON_PROFILE_SCOPE("Affine3::operator*");
+		return Affine3::Multiply(a1, a2);
+	}
+
+	Vector3 operator*(const Affine3& a, const Vector3& p)
+	{
+		BABOON_PROFILE_SCOPE("Affine3::operator*");
+		return Affine3::TransformPoint(a, p);
+	}
+}
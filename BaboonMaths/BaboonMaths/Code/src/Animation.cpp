@@ -0,0 +1,274 @@
+#include "BaboonMaths.h"
+#include "Hints.h"
+#include "Profile.h"
+#include <algorithm>
+
+namespace Baboon
+{
+	namespace
+	{
+		// keys stepped over linearly from the cursor before falling back to a binary search
+		constexpr int CursorSteps = 4;
+
+		// every interpolation mode is a weighted sum of four keys, values or tangents : the weights are computed
+		// once and each component of the vector summed on its own
+		template <class V>
+		float Sum(const V* const points[4], const float weights[4], float V::*component)
+		{
+			return weights[0] * (points[0]->*component) + weights[1] * (points[1]->*component)
+				+ weights[2] * (points[2]->*component) + weights[3] * (points[3]->*component);
+		}
+
+		Vector2 Blend(const Vector2* const points[4], const float weights[4])
+		{
+			return Vector2(Sum(points, weights, &Vector2::x), Sum(points, weights, &Vector2::y));
+		}
+
+		Vector3 Blend(const Vector3* const points[4], const float weights[4])
+		{
+			return Vector3(Sum(points, weights, &Vector3::x), Sum(points, weights, &Vector3::y), Sum(points, weights, &Vector3::z));
+		}
+
+		Vector4 Blend(const Vector4* const points[4], const float weights[4])
+		{
+			return Vector4(Sum(points, weights, &Vector4::x), Sum(points, weights, &Vector4::y), Sum(points, weights, &Vector4::z),
+				Sum(points, weights, &Vector4::w));
+		}
+
+		// cubic Hermite basis for p0, m0, p1 and m1
+		void HermiteWeights(float u, float* weights)
+		{
+			float u2 = u * u;
+			float u3 = u2 * u;
+			weights[0] = 2.f * u3 - 3.f * u2 + 1.f;
+			weights[1] = u3 - 2.f * u2 + u;
+			weights[2] = 3.f * u2 - 2.f * u3;
+			weights[3] = u3 - u2;
+		}
+	}
+
+	int TrackTimes::KeyCount() const
+	{
+		return (int)times.size();
+	}
+
+	float TrackTimes::StartTime() const
+	{
+		return times.empty() ? 0.f : times.front();
+	}
+
+	float TrackTimes::EndTime() const
+	{
+		return times.empty() ? 0.f : times.back();
+	}
+
+	int TrackTimes::Locate(float time, TrackCursor& cursor, float& u) const
+	{
+		int last = (int)times.size() - 1;
+		if (last <= 0 || time <= times[0]) {
+			u = 0.f;
+			cursor.key = 0;
+			return 0;
+		}
+		if (time >= times[last]) {
+			u = 1.f;
+			cursor.key = last - 1;
+			return last - 1;
+		}
+
+		// playback usually moves forward by less than a key per frame, so a few steps from the cursor are enough
+		int key = std::min(std::max(cursor.key, 0), last - 1);
+		if (times[key] <= time) {
+			for (int step = 0; step < CursorSteps && times[key + 1] <= time; step++)
+				key++;
+			if (times[key + 1] <= time)
+				key = (int)(std::upper_bound(times.begin() + key + 1, times.end(), time) - times.begin()) - 1;
+		}
+		else
+			key = (int)(std::upper_bound(times.begin(), times.begin() + key, time) - times.begin()) - 1;
+
+		cursor.key = key;
+		u = (time - times[key]) / (times[key + 1] - times[key]);
+		return key;
+	}
+
+	template <class V>
+	Track<V>::Track(Interpolation _interpolation) : interpolation(_interpolation) {}
+
+	template <class V>
+	bool Track<V>::HasTangents() const
+	{
+		return interpolation == Interpolation::CubicHermite || interpolation == Interpolation::Bezier;
+	}
+
+	template <class V>
+	void Track<V>::AddKey(float time, const V& value)
+	{
+		BABOON_PROFILE_SCOPE("Track::AddKey");
+		AddKey(time, value, V(), V());
+	}
+
+	template <class V>
+	void Track<V>::AddKey(float time, const V& value, const V& in, const V& out)
+	{
+		BABOON_PROFILE_SCOPE("Track::AddKey");
+		if (BABOON_UNLIKELY(!times.empty() && time <= times.back())) {
+			Warn("Cannot add a key before the last one");
+			return;
+		}
+
+		times.push_back(time);
+		values.push_back(value);
+		if (HasTangents()) {
+			tangents.push_back(in);
+			tangents.push_back(out);
+		}
+	}
+
+	template <class V>
+	V Track<V>::Sample(float time) const
+	{
+		BABOON_PROFILE_SCOPE("Track::Sample");
+		TrackCursor cursor;
+		return Sample(time, cursor);
+	}
+
+	template <class V>
+	V Track<V>::Sample(float time, TrackCursor& cursor) const
+	{
+		BABOON_PROFILE_SCOPE("Track::Sample");
+		if (values.empty())
+			return V();
+		if (values.size() == 1)
+			return values[0];
+
+		float u;
+		int k = Locate(time, cursor, u);
+		const V* points[4] = { &values[k], &values[k + 1], &values[k + 1], &values[k + 1] };
+		float weights[4] = { 1.f - u, u, 0.f, 0.f };
+
+		// a track switched to a tangent mode after its keys were added has none, it stays linear
+		Interpolation mode = interpolation;
+		if (tangents.size() < 2 * values.size() && HasTangents())
+			mode = Interpolation::Linear;
+
+		switch (mode)
+		{
+		case Interpolation::Step:
+			return u < 1.f ? values[k] : values[k + 1];
+
+		case Interpolation::Linear:
+			break;
+
+		case Interpolation::CubicHermite:
+		{
+			// the tangents are per second, the basis per segment
+			float duration = times[k + 1] - times[k];
+			float h[4];
+			HermiteWeights(u, h);
+			points[1] = &tangents[2 * k + 1];
+			points[2] = &values[k + 1];
+			points[3] = &tangents[2 * k + 2];
+			weights[0] = h[0];
+			weights[1] = h[1] * duration;
+			weights[2] = h[2];
+			weights[3] = h[3] * duration;
+			break;
+		}
+
+		case Interpolation::CatmullRom:
+		{
+			// non-uniform tangents m0 = (p1 - before) * s0 and m1 = (after - p0) * s1 from the neighbouring keys,
+			// one-sided at both ends of the track, expanded into the Hermite weights
+			int last = (int)values.size() - 1;
+			int before = std::max(k - 1, 0);
+			int after = std::min(k + 2, last);
+			float duration = times[k + 1] - times[k];
+			float s0 = duration / (times[k + 1] - times[before]);
+			float s1 = duration / (times[after] - times[k]);
+			float h[4];
+			HermiteWeights(u, h);
+			points[0] = &values[before];
+			points[1] = &values[k];
+			points[2] = &values[k + 1];
+			points[3] = &values[after];
+			weights[0] = -h[1] * s0;
+			weights[1] = h[0] - h[3] * s1;
+			weights[2] = h[2] + h[1] * s0;
+			weights[3] = h[3] * s1;
+			break;
+		}
+
+		case Interpolation::Bezier:
+		{
+			float v = 1.f - u;
+			points[1] = &tangents[2 * k + 1];
+			points[2] = &tangents[2 * k + 2];
+			weights[0] = v * v * v;
+			weights[1] = 3.f * v * v * u;
+			weights[2] = 3.f * v * u * u;
+			weights[3] = u * u * u;
+			break;
+		}
+		}
+
+		return Blend(points, weights);
+	}
+
+	template <class V>
+	void Track<V>::SampleBatch(const Track* tracks, const float* times, V* results, TrackCursor* cursors, int count)
+	{
+		BABOON_ZONE("Track::SampleBatch");
+		TrackCursor scratch;
+		for (int i = 0; i < count; i++)
+			results[i] = tracks[i].Sample(times[i], cursors ? cursors[i] : scratch);
+	}
+
+	template class Track<Vector2>;
+	template class Track<Vector3>;
+	template class Track<Vector4>;
+
+	RotationTrack::RotationTrack(Interpolation _interpolation) : interpolation(_interpolation) {}
+
+	void RotationTrack::AddKey(float time, const Quaternion& value)
+	{
+		BABOON_PROFILE_SCOPE("RotationTrack::AddKey");
+		if (BABOON_UNLIKELY(!times.empty() && time <= times.back())) {
+			Warn("Cannot add a key before the last one");
+			return;
+		}
+
+		times.push_back(time);
+		values.push_back(value);
+	}
+
+	Quaternion RotationTrack::Sample(float time) const
+	{
+		BABOON_PROFILE_SCOPE("RotationTrack::Sample");
+		TrackCursor cursor;
+		return Sample(time, cursor);
+	}
+
+	Quaternion RotationTrack::Sample(float time, TrackCursor& cursor) const
+	{
+		BABOON_PROFILE_SCOPE("RotationTrack::Sample");
+		if (values.empty())
+			return Quaternion();
+		if (values.size() == 1)
+			return values[0];
+
+		float u;
+		int k = Locate(time, cursor, u);
+		if (interpolation == Interpolation::Step)
+			return u < 1.f ? values[k] : values[k + 1];
+		return Quaternion::Slerp(values[k], values[k + 1], u);
+	}
+
+	void RotationTrack::SampleBatch(const RotationTrack* tracks, const float* times, Quaternion* results, TrackCursor* cursors, int count)
+	{
+		BABOON_ZONE("RotationTrack::SampleBatch");
+		TrackCursor scratch;
+		for (int i = 0; i < count; i++)
+			results[i] = tracks[i].Sample(times[i], cursors ? cursors[i] : scratch);
+	}
+}
@@ -0,0 +1,128 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Hints.h"
+#include "Profile.h"
+
+namespace Baboon
+{
+	Cholesky::Cholesky(const MatrixX& m) : l(m.rows, m.cols), positiveDefinite(true)
+	{
+		BABOON_ZONE("Cholesky::Cholesky");
+		if (BABOON_UNLIKELY(m.rows != m.cols))
+			Fail("Cannot compute the Cholesky factorization of a non-square matrix");
+
+		int n = m.rows;
+		for (int j = 0; j < n; ++j) {
+			float diagonal = m.At(j, j);
+			for (int k = 0; k < j; ++k)
+				diagonal -= l.At(j, k) * l.At(j, k);
+
+			if (diagonal <= 0.f) {
+				positiveDefinite = false;
+				return;
+			}
+
+			float ljj = sqrtf(diagonal);
+			float invLjj = 1.f / ljj;
+			l.At(j, j) = ljj;
+			for (int i = j + 1; i < n; ++i) {
+				float sum = m.At(i, j);
+				for (int k = 0; k < j; ++k)
+					sum -= l.At(i, k) * l.At(j, k);
+				l.At(i, j) = sum * invLjj;
+			}
+		}
+	}
+
+	Cholesky::Cholesky(const Matrix3x3& m) : Cholesky(MatrixX(m)) {}
+
+	Cholesky::Cholesky(const Matrix4x4& m) : Cholesky(MatrixX(m)) {}
+
+	bool Cholesky::IsPositiveDefinite() const
+	{
+		return positiveDefinite;
+	}
+
+	float Cholesky::Determinant() const
+	{
+		BABOON_PROFILE_SCOPE("Cholesky::Determinant");
+		if (!positiveDefinite)
+			return 0.f;
+
+		float det = 1.f;
+		for (int i = 0; i < l.rows; ++i)
+			det *= l.At(i, i) * l.At(i, i);
+		return det;
+	}
+
+	MatrixX Cholesky::Solve(const MatrixX& b) const
+	{
+		BABOON_ZONE("Cholesky::Solve");
+		if (BABOON_UNLIKELY(b.rows != l.rows))
+			Fail("Cannot solve a system with a right-hand side of a different size");
+
+		MatrixX x(b.rows, b.cols);
+		if (!positiveDefinite || b.cols == 0)
+			return x;
+
+		x = b;
+		int n = l.rows;
+		int nrhs = b.cols;
+		for (int i = 0; i < n; ++i) {
+			float* xi = &x.At(i, 0);
+			for (int k = 0; k < i; ++k) {
+				float lik = l.At(i, k);
+				const float* xk = &x.At(k, 0);
+				for (int j = 0; j < nrhs; ++j)
+					xi[j] -= lik * xk[j];
+			}
+			float invDiagonal = 1.f / l.At(i, i);
+			for (int j = 0; j < nrhs; ++j)
+				xi[j] *= invDiagonal;
+		}
+
+		for (int i = n - 1; i >= 0; --i) {
+			float* xi = &x.At(i, 0);
+			for (int k = i + 1; k < n; ++k) {
+				float lki = l.At(k, i);
+				const float* xk = &x.At(k, 0);
+				for (int j = 0; j < nrhs; ++j)
+					xi[j] -= lki * xk[j];
+			}
+			float invDiagonal = 1.f / l.At(i, i);
+			for (int j = 0; j < nrhs; ++j)
+				xi[j] *= invDiagonal;
+		}
+		return x;
+	}
+
+	Vector3 Cholesky::Solve(const Vector3& b) const
+	{
+		BABOON_ZONE("Cholesky::Solve");
+		MatrixX x = Solve(MatrixX(3, 1, { b.x, b.y, b.z }));
+		return Vector3(x.elements[0], x.elements[1], x.elements[2]);
+	}
+
+	Vector4 Cholesky::Solve(const Vector4& b) const
+	{
+		BABOON_ZONE("Cholesky::Solve");
+		MatrixX x = Solve(MatrixX(4, 1, { b.x, b.y, b.z, b.w }));
+		return Vector4(x.elements[0], x.elements[1], x.elements[2], x.elements[3]);
+	}
+
+	int Cholesky::SolveBatch(const Matrix3x3* m, const Vector3* b, Vector3* x, int count)
+	{
+		BABOON_ZONE("Cholesky::SolveBatch");
+		if (count <= 0)
+			return 0;
+		return (int)Kernels().solveCholesky3x3(m, b, x, (size_t)count);
+	}
+
+	int Cholesky::SolveBatch(const Matrix4x4* m, const Vector4* b, Vector4* x, int count)
+	{
+		BABOON_ZONE("Cholesky::SolveBatch");
+		if (count <= 0)
+			return 0;
+		return (int)Kernels().solveCholesky4x4(m, b, x, (size_t)count);
+	}
+}
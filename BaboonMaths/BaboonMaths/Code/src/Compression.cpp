@@ -0,0 +1,215 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Profile.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+namespace Baboon
+{
+	static_assert(sizeof(HalfVector3) == 6 && sizeof(QuantizedVector3) == 6, "packed vectors are three 16 bits fields");
+	static_assert(sizeof(PackedQuaternion48) == 6 && sizeof(PackedTransform) == 18, "packed transforms are 18 bytes");
+
+	namespace
+	{
+		constexpr size_t TransformChunk = 64; // transforms decomposed per pass of the bulk packers
+	}
+
+	uint16_t FloatToHalf(float f)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &f, sizeof(bits));
+		uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+		bits &= 0x7fffffff;
+
+		// too large for a half (from 65520 after rounding), infinity or NaN
+		if (bits >= 0x47800000)
+			return sign | (bits > 0x7f800000 ? 0x7e00 : 0x7c00);
+
+		// half denormals : adding 0.5 aligns the mantissa on the half's and rounds it in the FPU
+		if (bits < 0x38800000) {
+			float a;
+			std::memcpy(&a, &bits, sizeof(a));
+			a += 0.5f;
+			std::memcpy(&bits, &a, sizeof(bits));
+			return sign | (uint16_t)(bits - 0x3f000000);
+		}
+
+		// rebiases the exponent and rounds the 13 dropped mantissa bits to nearest even
+		uint32_t odd = (bits >> 13) & 1;
+		bits += 0xc8000fff + odd;
+		return sign | (uint16_t)(bits >> 13);
+	}
+
+	float HalfToFloat(uint16_t h)
+	{
+		uint32_t bits = (uint32_t)(h & 0x7fff) << 13;
+		uint32_t exponent = bits & 0x0f800000;
+		bits += (127 - 15) << 23;
+
+		if (exponent == 0x0f800000)
+			bits += (128 - 16) << 23; // infinity or NaN
+		else if (exponent == 0) {
+			// denormal, renormalized by the FPU
+			bits += 1 << 23;
+			float f, magic;
+			uint32_t magicBits = 113 << 23;
+			std::memcpy(&f, &bits, sizeof(f));
+			std::memcpy(&magic, &magicBits, sizeof(magic));
+			f -= magic;
+			std::memcpy(&bits, &f, sizeof(bits));
+		}
+
+		bits |= (uint32_t)(h & 0x8000) << 16;
+		float f;
+		std::memcpy(&f, &bits, sizeof(f));
+		return f;
+	}
+
+	void HalfVector3::Pack(const Vector3* vectors, HalfVector3* packed, size_t count)
+	{
+		BABOON_ZONE("HalfVector3::Pack");
+		Kernels().floatsToHalves(reinterpret_cast<const float*>(vectors), reinterpret_cast<uint16_t*>(packed), count * 3);
+	}
+
+	void HalfVector3::Unpack(const HalfVector3* packed, Vector3* vectors, size_t count)
+	{
+		BABOON_ZONE("HalfVector3::Unpack");
+		Kernels().halvesToFloats(reinterpret_cast<const uint16_t*>(packed), reinterpret_cast<float*>(vectors), count * 3);
+	}
+
+	void PackedQuaternion32::Pack(const Quaternion* quaternions, PackedQuaternion32* packed, size_t count)
+	{
+		BABOON_ZONE("PackedQuaternion32::Pack");
+		Kernels().packQuaternions32(quaternions, packed, count);
+	}
+
+	void PackedQuaternion32::Unpack(const PackedQuaternion32* packed, Quaternion* quaternions, size_t count)
+	{
+		BABOON_ZONE("PackedQuaternion32::Unpack");
+		Kernels().unpackQuaternions32(packed, quaternions, count);
+	}
+
+	void PackedQuaternion48::Pack(const Quaternion* quaternions, PackedQuaternion48* packed, size_t count)
+	{
+		BABOON_ZONE("PackedQuaternion48::Pack");
+		Kernels().packQuaternions48(quaternions, packed, count);
+	}
+
+	void PackedQuaternion48::Unpack(const PackedQuaternion48* packed, Quaternion* quaternions, size_t count)
+	{
+		BABOON_ZONE("PackedQuaternion48::Unpack");
+		Kernels().unpackQuaternions48(packed, quaternions, count);
+	}
+
+	QuantizationBounds QuantizationBounds::FromPoints(const Vector3* points, size_t count)
+	{
+		BABOON_ZONE("QuantizationBounds::FromPoints");
+		if (count == 0)
+			return { Vector3(), Vector3() };
+
+		QuantizationBounds bounds = { points[0], points[0] };
+		for (size_t i = 1; i < count; i++)
+		{
+			bounds.min = Vector3(std::min(bounds.min.x, points[i].x), std::min(bounds.min.y, points[i].y), std::min(bounds.min.z, points[i].z));
+			bounds.max = Vector3(std::max(bounds.max.x, points[i].x), std::max(bounds.max.y, points[i].y), std::max(bounds.max.z, points[i].z));
+		}
+		return bounds;
+	}
+
+	void QuantizedVector3::Pack(const Vector3* vectors, QuantizedVector3* packed, size_t count, const QuantizationBounds& bounds)
+	{
+		BABOON_ZONE("QuantizedVector3::Pack");
+		Kernels().quantizeVectors(vectors, packed, count, bounds);
+	}
+
+	void QuantizedVector3::Unpack(const QuantizedVector3* packed, Vector3* vectors, size_t count, const QuantizationBounds& bounds)
+	{
+		BABOON_ZONE("QuantizedVector3::Unpack");
+		Kernels().dequantizeVectors(packed, vectors, count, bounds);
+	}
+
+	void PackedTransform::Pack(const Matrix4x4* transforms, PackedTransform* packed, size_t count, const QuantizationBounds& translationBounds)
+	{
+		BABOON_ZONE("PackedTransform::Pack");
+		// decomposes a chunk of matrices, then hands each part to its bulk packer
+		Quaternion rotations[TransformChunk];
+		Vector3 translations[TransformChunk], scales[TransformChunk];
+		PackedQuaternion48 packedRotations[TransformChunk];
+		QuantizedVector3 packedTranslations[TransformChunk];
+		HalfVector3 packedScales[TransformChunk];
+
+		for (size_t start = 0; start < count; start += TransformChunk)
+		{
+			size_t n = std::min(TransformChunk, count - start);
+			for (size_t j = 0; j < n; j++)
+			{
+				const std::array<float, 16>& e = transforms[start + j].elements;
+				Vector3 columns[3] = { Vector3(e[0], e[4], e[8]), Vector3(e[1], e[5], e[9]), Vector3(e[2], e[6], e[10]) };
+				float scale[3];
+				for (int k = 0; k < 3; k++) {
+					scale[k] = Vector3::Norm(columns[k]);
+					columns[k] = columns[k] * (scale[k] > FLT_MIN ? 1.f / scale[k] : 0.f);
+				}
+
+				// a mirroring matrix keeps a rotation by carrying the reflection in the x scale
+				if (Vector3::DotProduct(Vector3::CrossProduct(columns[0], columns[1]), columns[2]) < 0.f) {
+					scale[0] = -scale[0];
+					columns[0] = columns[0] * -1.f;
+				}
+
+				rotations[j] = Quaternion::FromMatrix(Matrix3x3({
+					columns[0].x, columns[1].x, columns[2].x,
+					columns[0].y, columns[1].y, columns[2].y,
+					columns[0].z, columns[1].z, columns[2].z
+					}));
+				translations[j] = Vector3(e[3], e[7], e[11]);
+				scales[j] = Vector3(scale[0], scale[1], scale[2]);
+			}
+
+			PackedQuaternion48::Pack(rotations, packedRotations, n);
+			QuantizedVector3::Pack(translations, packedTranslations, n, translationBounds);
+			HalfVector3::Pack(scales, packedScales, n);
+			for (size_t j = 0; j < n; j++)
+				packed[start + j] = { packedRotations[j], packedTranslations[j], packedScales[j] };
+		}
+	}
+
+	void PackedTransform::Unpack(const PackedTransform* packed, Matrix4x4* transforms, size_t count, const QuantizationBounds& translationBounds)
+	{
+		BABOON_ZONE("PackedTransform::Unpack");
+		Quaternion rotations[TransformChunk];
+		Vector3 translations[TransformChunk], scales[TransformChunk];
+		PackedQuaternion48 packedRotations[TransformChunk];
+		QuantizedVector3 packedTranslations[TransformChunk];
+		HalfVector3 packedScales[TransformChunk];
+
+		for (size_t start = 0; start < count; start += TransformChunk)
+		{
+			size_t n = std::min(TransformChunk, count - start);
+			for (size_t j = 0; j < n; j++)
+			{
+				packedRotations[j] = packed[start + j].rotation;
+				packedTranslations[j] = packed[start + j].translation;
+				packedScales[j] = packed[start + j].scale;
+			}
+
+			PackedQuaternion48::Unpack(packedRotations, rotations, n);
+			QuantizedVector3::Unpack(packedTranslations, translations, n, translationBounds);
+			HalfVector3::Unpack(packedScales, scales, n);
+
+			for (size_t j = 0; j < n; j++)
+			{
+				const std::array<float, 9> r = Quaternion::ToMatrix(rotations[j]).elements;
+				const Vector3& s = scales[j];
+				const Vector3& t = translations[j];
+				transforms[start + j] = Matrix4x4({
+					r[0] * s.x, r[1] * s.y, r[2] * s.z, t.x,
+					r[3] * s.x, r[4] * s.y, r[5] * s.z, t.y,
+					r[6] * s.x, r[7] * s.y, r[8] * s.z, t.z,
+					0.f, 0.f, 0.f, 1.f
+					});
+			}
+		}
+	}
+}
@@ -0,0 +1,222 @@
+#pragma once
+#include "Lanes.h"
+
+namespace Baboon::BABOON_LANES_NAMESPACE
+{
+	namespace
+	{
+		using namespace Lanes;
+
+		constexpr float Sqrt1_2 = 0.707106781f; // bound of the three smallest components of a unit quaternion
+		// where the three smallest components go back, for each index of the dropped largest one
+		constexpr int SmallestSlots[4][3] = { { 1, 2, 3 }, { 0, 2, 3 }, { 0, 1, 3 }, { 0, 1, 2 } };
+
+		void FloatsToHalves(const float* f, uint16_t* h, size_t count)
+		{
+			size_t i = 0;
+#if defined(BABOON_LANES_AVX2) || defined(BABOON_LANES_AVX512)
+			for (; i + 8 <= count; i += 8)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(h + i), _mm256_cvtps_ph(_mm256_loadu_ps(f + i), _MM_FROUND_TO_NEAREST_INT));
+#endif
+			for (; i < count; i++)
+				h[i] = FloatToHalf(f[i]);
+		}
+
+		void HalvesToFloats(const uint16_t* h, float* f, size_t count)
+		{
+			size_t i = 0;
+#if defined(BABOON_LANES_AVX2) || defined(BABOON_LANES_AVX512)
+			for (; i + 8 <= count; i += 8)
+				_mm256_storeu_ps(f + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i))));
+#endif
+			for (; i < count; i++)
+				f[i] = HalfToFloat(h[i]);
+		}
+
+		// normalizes q and returns the index of its largest component and the three others quantized on
+		// [0, maxValue], still as floats rounded up by 0.5 so the conversion to integer rounds them
+		template <class P>
+		void SmallestThree(P x, P y, P z, P w, float maxValue, P& index, P* quantized)
+		{
+			P zero = Broadcast<P>(0.f);
+			P invNorm = Broadcast<P>(1.f) / Sqrt(x * x + y * y + z * z + w * w);
+
+			P largest = x;
+			P largestAbs = Abs(x);
+			index = zero;
+			const P others[3] = { y, z, w };
+			for (int k = 0; k < 3; k++) {
+				auto larger = Less(largestAbs, Abs(others[k]));
+				index = Select(larger, Broadcast<P>((float)(k + 1)), index);
+				largest = Select(larger, others[k], largest);
+				largestAbs = Select(larger, Abs(others[k]), largestAbs);
+			}
+
+			// drops the largest component, keeping the order of the remaining ones
+			P a = Select(Less(index, Broadcast<P>(0.5f)), y, x);
+			P b = Select(Less(index, Broadcast<P>(1.5f)), z, y);
+			P c = Select(Less(index, Broadcast<P>(2.5f)), w, z);
+
+			// [-1/sqrt(2), 1/sqrt(2)] -> [0, maxValue], negating q if its largest component is negative
+			P scale = Broadcast<P>(maxValue * Sqrt1_2) * invNorm;
+			scale = Select(Less(largest, zero), -scale, scale);
+			P offset = Broadcast<P>(0.5f * maxValue);
+			P top = Broadcast<P>(maxValue);
+			P half = Broadcast<P>(0.5f);
+
+			quantized[0] = Min(Max(a * scale + offset, zero), top) + half;
+			quantized[1] = Min(Max(b * scale + offset, zero), top) + half;
+			quantized[2] = Min(Max(c * scale + offset, zero), top) + half;
+		}
+
+		// inverse of SmallestThree : dequantizes the three components in place and rebuilds the largest one
+		template <class P>
+		void FromSmallestThree(P* components, float maxValue, P& largest)
+		{
+			P scale = Broadcast<P>(2.f * Sqrt1_2 / maxValue);
+			P offset = Broadcast<P>(Sqrt1_2);
+			for (int k = 0; k < 3; k++)
+				components[k] = components[k] * scale - offset;
+
+			P squared = components[0] * components[0] + components[1] * components[1] + components[2] * components[2];
+			largest = Sqrt(Max(Broadcast<P>(0.f), Broadcast<P>(1.f) - squared));
+		}
+
+		uint64_t ReadBits(const PackedQuaternion32& p) { return p.bits; }
+		uint64_t ReadBits(const PackedQuaternion48& p) { return p.bits[0] | (uint64_t)p.bits[1] << 16 | (uint64_t)p.bits[2] << 32; }
+		void WriteBits(PackedQuaternion32& p, uint64_t bits) { p.bits = (uint32_t)bits; }
+		void WriteBits(PackedQuaternion48& p, uint64_t bits)
+		{
+			p.bits[0] = (uint16_t)bits;
+			p.bits[1] = (uint16_t)(bits >> 16);
+			p.bits[2] = (uint16_t)(bits >> 32);
+		}
+
+		// index in the 2 bits above three Bits wide fields
+		template <int Bits, class Packed>
+		void PackQuaternions(const Quaternion* quaternions, Packed* packed, size_t count)
+		{
+			constexpr float maxValue = (float)((1 << Bits) - 1);
+			ForEachBlock(count, [&](size_t i, auto lane) {
+				using P = decltype(lane);
+				constexpr int n = LaneCount<P>();
+				float x[n], y[n], z[n], w[n], index[n], q[3][n];
+				for (int j = 0; j < n; j++) {
+					x[j] = quaternions[i + j].x;
+					y[j] = quaternions[i + j].y;
+					z[j] = quaternions[i + j].z;
+					w[j] = quaternions[i + j].w;
+				}
+
+				P pIndex, pQuantized[3];
+				SmallestThree(LoadAs<P>(x), LoadAs<P>(y), LoadAs<P>(z), LoadAs<P>(w), maxValue, pIndex, pQuantized);
+				Store(index, pIndex);
+				for (int k = 0; k < 3; k++)
+					Store(q[k], pQuantized[k]);
+
+				for (int j = 0; j < n; j++) {
+					// through int32, which converts in one instruction unlike uint64
+					uint64_t bits = (uint64_t)(int)index[j] << (3 * Bits) | (uint64_t)(int)q[0][j] << (2 * Bits)
+						| (uint64_t)(int)q[1][j] << Bits | (uint64_t)(int)q[2][j];
+					WriteBits(packed[i + j], bits);
+				}
+			});
+		}
+
+		template <int Bits, class Packed>
+		void UnpackQuaternions(const Packed* packed, Quaternion* quaternions, size_t count)
+		{
+			constexpr float maxValue = (float)((1 << Bits) - 1);
+			constexpr uint64_t mask = (1 << Bits) - 1;
+			ForEachBlock(count, [&](size_t i, auto lane) {
+				using P = decltype(lane);
+				constexpr int n = LaneCount<P>();
+				int index[n];
+				float q[3][n], largest[n];
+				for (int j = 0; j < n; j++) {
+					uint64_t bits = ReadBits(packed[i + j]);
+					index[j] = (int)(bits >> (3 * Bits)) & 3;
+					q[0][j] = (float)(int)((bits >> (2 * Bits)) & mask);
+					q[1][j] = (float)(int)((bits >> Bits) & mask);
+					q[2][j] = (float)(int)(bits & mask);
+				}
+
+				P components[3] = { LoadAs<P>(q[0]), LoadAs<P>(q[1]), LoadAs<P>(q[2]) };
+				P pLargest;
+				FromSmallestThree(components, maxValue, pLargest);
+				Store(largest, pLargest);
+				for (int k = 0; k < 3; k++)
+					Store(q[k], components[k]);
+
+				for (int j = 0; j < n; j++) {
+					// table driven so the random index does not cost branch mispredictions
+					float c[4];
+					c[index[j]] = largest[j];
+					for (int k = 0; k < 3; k++)
+						c[SmallestSlots[index[j]][k]] = q[k][j];
+					Quaternion& out = quaternions[i + j];
+					out.x = c[0];
+					out.y = c[1];
+					out.z = c[2];
+					out.w = c[3];
+				}
+			});
+		}
+
+		void QuantizeVectors(const Vector3* vectors, QuantizedVector3* packed, size_t count, const QuantizationBounds& bounds)
+		{
+			const float min[3] = { bounds.min.x, bounds.min.y, bounds.min.z };
+			const float extent[3] = { bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z };
+
+			ForEachBlock(count, [&](size_t i, auto lane) {
+				using P = decltype(lane);
+				constexpr int n = LaneCount<P>();
+				float axes[3][n];
+				for (int j = 0; j < n; j++) {
+					axes[0][j] = vectors[i + j].x;
+					axes[1][j] = vectors[i + j].y;
+					axes[2][j] = vectors[i + j].z;
+				}
+
+				for (int k = 0; k < 3; k++) {
+					// flat bounds store every value as 0
+					P invStep = Broadcast<P>(extent[k] > 0.f ? 65535.f / extent[k] : 0.f);
+					P q = (LoadAs<P>(axes[k]) - Broadcast<P>(min[k])) * invStep;
+					q = Min(Max(q, Broadcast<P>(0.f)), Broadcast<P>(65535.f)) + Broadcast<P>(0.5f);
+					Store(axes[k], q);
+				}
+
+				for (int j = 0; j < n; j++)
+					packed[i + j] = { (uint16_t)axes[0][j], (uint16_t)axes[1][j], (uint16_t)axes[2][j] };
+			});
+		}
+
+		void DequantizeVectors(const QuantizedVector3* packed, Vector3* vectors, size_t count, const QuantizationBounds& bounds)
+		{
+			const float min[3] = { bounds.min.x, bounds.min.y, bounds.min.z };
+			const float extent[3] = { bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z };
+
+			ForEachBlock(count, [&](size_t i, auto lane) {
+				using P = decltype(lane);
+				constexpr int n = LaneCount<P>();
+				float axes[3][n];
+				for (int j = 0; j < n; j++) {
+					axes[0][j] = packed[i + j].x;
+					axes[1][j] = packed[i + j].y;
+					axes[2][j] = packed[i + j].z;
+				}
+
+				for (int k = 0; k < 3; k++) {
+					P v = Broadcast<P>(min[k]) + LoadAs<P>(axes[k]) * Broadcast<P>(extent[k] / 65535.f);
+					Store(axes[k], v);
+				}
+
+				for (int j = 0; j < n; j++) {
+					vectors[i + j].x = axes[0][j];
+					vectors[i + j].y = axes[1][j];
+					vectors[i + j].z = axes[2][j];
+				}
+			});
+		}
+	}
+}
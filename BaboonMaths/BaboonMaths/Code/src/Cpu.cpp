@@ -0,0 +1,144 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#if defined(BABOON_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(BABOON_X86)
+#include <cpuid.h>
+#endif
+
+namespace Baboon
+{
+	std::atomic<const KernelTable*> ActiveKernels{ nullptr };
+
+	namespace
+	{
+		std::atomic<int> detectedLevel{ -1 };
+
+#if defined(BABOON_X86)
+		// eax, ebx, ecx and edx of a CPUID leaf
+		void CpuId(unsigned int leaf, unsigned int subleaf, unsigned int* registers)
+		{
+#if defined(_MSC_VER)
+			int r[4];
+			__cpuidex(r, (int)leaf, (int)subleaf);
+			for (int k = 0; k < 4; k++)
+				registers[k] = (unsigned int)r[k];
+#else
+			__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+		}
+
+		// registers the OS saves on context switches, an instruction set is only usable if its registers are
+		unsigned long long SavedRegisters()
+		{
+#if defined(_MSC_VER)
+			return _xgetbv(0);
+#else
+			unsigned int eax, edx;
+			__asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (unsigned long long)edx << 32 | eax;
+#endif
+		}
+
+		bool Has(unsigned int reg, int bit)
+		{
+			return (reg >> bit) & 1;
+		}
+#endif
+
+		SimdLevel DetectLevel()
+		{
+#if defined(BABOON_X86)
+			unsigned int leaf0[4], leaf1[4], leaf7[4] = {};
+			CpuId(0, 0, leaf0);
+			CpuId(1, 0, leaf1);
+			if (leaf0[0] >= 7)
+				CpuId(7, 0, leaf7);
+
+			if (!Has(leaf1[3], 26))
+				return SimdLevel::Scalar;
+
+			unsigned long long saved = Has(leaf1[2], 27) ? SavedRegisters() : 0;
+
+			// everything /arch:AVX2 may emit : AVX2, FMA, F16C, BMI1 and BMI2, with the ymm registers saved
+			bool avx2 = (saved & 0x6) == 0x6 && Has(leaf1[2], 28) && Has(leaf1[2], 12) && Has(leaf1[2], 29)
+				&& Has(leaf7[1], 5) && Has(leaf7[1], 3) && Has(leaf7[1], 8);
+			if (!avx2)
+				return SimdLevel::SSE;
+
+			// /arch:AVX512 : the foundation, CD, BW, DQ and VL, with the opmask and zmm registers saved
+			bool avx512 = (saved & 0xe6) == 0xe6 && Has(leaf7[1], 16) && Has(leaf7[1], 28) && Has(leaf7[1], 30)
+				&& Has(leaf7[1], 17) && Has(leaf7[1], 31);
+			return avx512 ? SimdLevel::AVX512 : SimdLevel::AVX2;
+#else
+			return SimdLevel::Scalar;
+#endif
+		}
+
+		const KernelTable& TableOf(SimdLevel level)
+		{
+			switch (level)
+			{
+#if defined(BABOON_X86)
+			case SimdLevel::AVX512:
+				return Avx512Kernels;
+			case SimdLevel::AVX2:
+				return Avx2Kernels;
+			case SimdLevel::SSE:
+				return SseKernels;
+#endif
+			default:
+				return ScalarKernels;
+			}
+		}
+	}
+
+	const KernelTable& SelectKernels()
+	{
+		// two threads may both get here, they pick the same table unless one is forcing another
+		const KernelTable* table = &TableOf(Cpu::Detected());
+		const KernelTable* expected = nullptr;
+		if (!ActiveKernels.compare_exchange_strong(expected, table))
+			return *expected;
+		return *table;
+	}
+
+	SimdLevel Cpu::Detected()
+	{
+		int level = detectedLevel.load(std::memory_order_relaxed);
+		if (level < 0) {
+			level = (int)DetectLevel();
+			detectedLevel.store(level, std::memory_order_relaxed);
+		}
+		return (SimdLevel)level;
+	}
+
+	SimdLevel Cpu::Active()
+	{
+		return Kernels().level;
+	}
+
+	bool Cpu::Force(SimdLevel level)
+	{
+		if (level > Detected())
+			return false;
+
+		ActiveKernels.store(&TableOf(level), std::memory_order_release);
+		return true;
+	}
+
+	const char* Cpu::Name(SimdLevel level)
+	{
+		switch (level)
+		{
+		case SimdLevel::SSE:
+			return "SSE";
+		case SimdLevel::AVX2:
+			return "AVX2";
+		case SimdLevel::AVX512:
+			return "AVX-512";
+		default:
+			return "Scalar";
+		}
+	}
+}
@@ -0,0 +1,342 @@
+#include "BaboonMaths.h"
+#include <algorithm>
+#include <cstring>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Baboon
+{
+	namespace
+	{
+		constexpr char Magic[8] = { 'B', 'A', 'B', 'O', 'O', 'N', 'D', 'S' };
+		constexpr uint32_t ByteOrderMark = 0x01020304; // reads differently on a machine of the other endianness
+		constexpr uint64_t DataAlignment = 64;
+
+		struct FileHeader
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t byteOrder;
+			uint64_t tableOffset;
+			uint32_t arrayCount;
+			uint32_t reserved[9];
+		};
+
+		static_assert(sizeof(FileHeader) == 64, "the dataset header is 64 bytes");
+		static_assert(sizeof(DatasetArray) == 64, "a dataset table entry is 64 bytes");
+		// items are mapped in place, so the types must be nothing but their floats
+		static_assert(sizeof(Vector2) == 2 * sizeof(float) && sizeof(Vector3) == 3 * sizeof(float)
+			&& sizeof(Vector4) == 4 * sizeof(float), "vectors are stored as plain floats");
+		static_assert(sizeof(Matrix2x2) == 4 * sizeof(float) && sizeof(Matrix3x3) == 9 * sizeof(float)
+			&& sizeof(Matrix4x4) == 16 * sizeof(float), "matrices are stored as plain floats");
+
+		uint64_t AlignUp(uint64_t value)
+		{
+			return (value + DataAlignment - 1) / DataAlignment * DataAlignment;
+		}
+	}
+
+	int DatasetComponents(DatasetType type)
+	{
+		switch (type)
+		{
+		case DatasetType::Float: return 1;
+		case DatasetType::Vector2: return 2;
+		case DatasetType::Vector3: return 3;
+		case DatasetType::Vector4: return 4;
+		case DatasetType::Matrix2x2: return 4;
+		case DatasetType::Matrix3x3: return 9;
+		case DatasetType::Matrix4x4: return 16;
+		}
+		return 0;
+	}
+
+	Dataset::~Dataset()
+	{
+		Close();
+	}
+
+	bool Dataset::Open(const std::string& path)
+	{
+		Close();
+
+#if defined(_WIN32)
+		HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (f == INVALID_HANDLE_VALUE)
+			return false;
+		file = f;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(f, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(FileHeader)) {
+			Close();
+			return false;
+		}
+		size = (size_t)fileSize.QuadPart;
+
+		mapping = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			Close();
+			return false;
+		}
+		base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+		file = reinterpret_cast<void*>((intptr_t)fd + 1); // + 1 so descriptor 0 is not mistaken for no file
+
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(FileHeader)) {
+			Close();
+			return false;
+		}
+		size = (size_t)info.st_size;
+
+		void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		base = view == MAP_FAILED ? nullptr : static_cast<const char*>(view);
+#endif
+		if (!base) {
+			Close();
+			return false;
+		}
+
+		FileHeader header;
+		std::memcpy(&header, base, sizeof(header));
+		if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.byteOrder != ByteOrderMark) {
+			std::cout << "Error : " << path << " is not a dataset of this machine's byte order" << std::endl;
+			Close();
+			return false;
+		}
+		if (header.version > DatasetVersion) {
+			std::cout << "Error : " << path << " was written by a newer version (" << header.version << ")" << std::endl;
+			Close();
+			return false;
+		}
+		if (header.tableOffset % alignof(DatasetArray) != 0 || header.tableOffset > size
+			|| header.arrayCount > (size - header.tableOffset) / sizeof(DatasetArray)) {
+			std::cout << "Error : " << path << " has a truncated table" << std::endl;
+			Close();
+			return false;
+		}
+
+		table = reinterpret_cast<const DatasetArray*>(base + header.tableOffset);
+		arrayCount = (int)header.arrayCount;
+
+		// every array must lie inside the file, so spans never read past the mapping
+		for (int i = 0; i < arrayCount; i++)
+		{
+			const DatasetArray& a = table[i];
+			int components = DatasetComponents(a.type);
+			uint64_t itemBytes = (uint64_t)components * sizeof(float);
+			bool valid = components > 0 && a.offset % DataAlignment == 0 && a.offset <= size
+				&& std::memchr(a.name, '\0', sizeof(a.name)) != nullptr;
+
+			if (valid && a.layout == DatasetLayout::AoS)
+				valid = a.count <= (size - a.offset) / itemBytes;
+			else if (valid && a.layout == DatasetLayout::SoA)
+				valid = a.laneStride % sizeof(float) == 0 && a.count <= a.laneStride / sizeof(float)
+					&& a.laneStride <= (size - a.offset) / components;
+			else
+				valid = false;
+
+			if (!valid) {
+				std::cout << "Error : " << path << " has a corrupted array " << i << std::endl;
+				Close();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void Dataset::Close()
+	{
+#if defined(_WIN32)
+		if (base)
+			UnmapViewOfFile(base);
+		if (mapping)
+			CloseHandle(mapping);
+		if (file)
+			CloseHandle(file);
+#else
+		if (base)
+			munmap(const_cast<char*>(base), size);
+		if (file)
+			close((int)(reinterpret_cast<intptr_t>(file) - 1));
+#endif
+		base = nullptr;
+		size = 0;
+		table = nullptr;
+		arrayCount = 0;
+		file = nullptr;
+		mapping = nullptr;
+	}
+
+	int Dataset::ArrayCount() const
+	{
+		return arrayCount;
+	}
+
+	const DatasetArray& Dataset::ArrayAt(int index) const
+	{
+		return table[index];
+	}
+
+	const DatasetArray* Dataset::Find(const std::string& name) const
+	{
+		for (int i = 0; i < arrayCount; i++)
+		{
+			if (name == table[i].name)
+				return &table[i];
+		}
+		return nullptr;
+	}
+
+	DatasetSpan<float> Dataset::Lane(const std::string& name, int component) const
+	{
+		const DatasetArray* a = Find(name);
+		if (!a || a->layout != DatasetLayout::SoA || component < 0 || component >= DatasetComponents(a->type))
+			return {};
+		return { reinterpret_cast<const float*>(base + a->offset + component * a->laneStride), (size_t)a->count };
+	}
+
+	DatasetWriter::~DatasetWriter()
+	{
+		if (stream.is_open())
+			Close();
+	}
+
+	bool DatasetWriter::Open(const std::string& path)
+	{
+		arrays.clear();
+		current = -1;
+		written = 0;
+
+		stream.open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+		if (!stream)
+			return false;
+
+		// the real header is written by Close, once the table's place is known
+		FileHeader header = {};
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		position = sizeof(header);
+		return (bool)stream;
+	}
+
+	void DatasetWriter::BeginArray(const std::string& name, DatasetType type, DatasetLayout layout, uint64_t count)
+	{
+		if (!stream.is_open() || current >= 0 || name.size() >= sizeof(DatasetArray::name)) {
+			std::cout << "Cannot begin the array " << name << std::endl;
+			return;
+		}
+
+		DatasetArray a = {};
+		std::memcpy(a.name, name.c_str(), name.size());
+		a.type = type;
+		a.layout = layout;
+		a.count = layout == DatasetLayout::SoA ? count : 0;
+		a.offset = AlignUp(position);
+		a.laneStride = layout == DatasetLayout::SoA ? AlignUp(count * sizeof(float)) : 0;
+		arrays.push_back(a);
+
+		current = (int)arrays.size() - 1;
+		written = 0;
+		PadTo(a.offset);
+	}
+
+	void DatasetWriter::AppendFloats(const float* items, size_t count)
+	{
+		if (current < 0) {
+			std::cout << "Cannot append items without an open array" << std::endl;
+			return;
+		}
+
+		DatasetArray& a = arrays[current];
+		int components = DatasetComponents(a.type);
+
+		if (a.layout == DatasetLayout::AoS) {
+			stream.write(reinterpret_cast<const char*>(items), (std::streamsize)(count * components * sizeof(float)));
+			written += count;
+			position += count * components * sizeof(float);
+			return;
+		}
+
+		if (written + count > a.count) {
+			std::cout << "Cannot append more items than the SoA array was created with" << std::endl;
+			return;
+		}
+
+		// gathers one lane at a time by chunks, so the write stays sequential inside each lane
+		constexpr size_t Chunk = 1024;
+		float lane[Chunk];
+		for (int c = 0; c < components; c++)
+		{
+			stream.seekp((std::streamoff)(a.offset + c * a.laneStride + written * sizeof(float)));
+			for (size_t start = 0; start < count; start += Chunk)
+			{
+				size_t n = std::min(Chunk, count - start);
+				for (size_t i = 0; i < n; i++)
+					lane[i] = items[(start + i) * components + c];
+				stream.write(reinterpret_cast<const char*>(lane), (std::streamsize)(n * sizeof(float)));
+			}
+		}
+		written += count;
+	}
+
+	void DatasetWriter::EndArray()
+	{
+		if (current < 0)
+			return;
+
+		DatasetArray& a = arrays[current];
+		if (a.layout == DatasetLayout::AoS)
+			a.count = written;
+		else {
+			if (written != a.count)
+				std::cout << "Warning : the SoA array " << a.name << " got " << written << " of its " << a.count << " items" << std::endl;
+			position = a.offset + DatasetComponents(a.type) * a.laneStride;
+		}
+		current = -1;
+	}
+
+	bool DatasetWriter::Close()
+	{
+		if (!stream.is_open())
+			return false;
+
+		EndArray();
+
+		FileHeader header = {};
+		std::memcpy(header.magic, Magic, sizeof(Magic));
+		header.version = DatasetVersion;
+		header.byteOrder = ByteOrderMark;
+		header.tableOffset = AlignUp(position);
+		header.arrayCount = (uint32_t)arrays.size();
+
+		PadTo(header.tableOffset);
+		stream.write(reinterpret_cast<const char*>(arrays.data()), (std::streamsize)(arrays.size() * sizeof(DatasetArray)));
+		stream.seekp(0);
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		bool ok = (bool)stream;
+		stream.close();
+		arrays.clear();
+		return ok;
+	}
+
+	void DatasetWriter::PadTo(uint64_t target)
+	{
+		static const char zeros[DataAlignment] = {};
+		stream.seekp((std::streamoff)position);
+		if (target > position)
+			stream.write(zeros, (std::streamsize)(target - position));
+		position = target;
+	}
+}
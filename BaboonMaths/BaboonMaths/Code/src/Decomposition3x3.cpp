@@ -0,0 +1,63 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Profile.h"
+
+namespace Baboon
+{
+	void Matrix3x3::SymmetricEigen(const Matrix3x3& m, Vector3& eigenvalues, Matrix3x3& eigenvectors)
+	{
+		BABOON_ZONE("Matrix3x3::SymmetricEigen");
+		// copies the input so the outputs may alias it
+		std::array<float, 9> a = m.elements;
+		float values[3];
+		Kernels().symmetricEigen3x3(a.data(), values, eigenvectors.elements.data());
+		eigenvalues = Vector3(values[0], values[1], values[2]);
+	}
+
+	void Matrix3x3::SVD(const Matrix3x3& m, Matrix3x3& u, Vector3& sigma, Matrix3x3& v)
+	{
+		BABOON_ZONE("Matrix3x3::SVD");
+		std::array<float, 9> a = m.elements;
+		float values[3];
+		Kernels().svd3x3(a.data(), u.elements.data(), values, v.elements.data());
+		sigma = Vector3(values[0], values[1], values[2]);
+	}
+
+	void Matrix3x3::PolarDecomposition(const Matrix3x3& m, Matrix3x3& rotation, Matrix3x3& stretch)
+	{
+		BABOON_ZONE("Matrix3x3::PolarDecomposition");
+		std::array<float, 9> a = m.elements;
+		Kernels().polar3x3(a.data(), rotation.elements.data(), stretch.elements.data());
+	}
+
+	void Matrix3x3Batch::SymmetricEigen(const Matrix3x3Batch& m, Vector3* eigenvalues, Matrix3x3Batch& eigenvectors)
+	{
+		BABOON_ZONE("Matrix3x3Batch::SymmetricEigen");
+		if (eigenvectors.count != m.count)
+			eigenvectors.Resize(m.count);
+
+		Kernels().batchSymmetricEigen(m, eigenvalues, eigenvectors);
+	}
+
+	void Matrix3x3Batch::SVD(const Matrix3x3Batch& m, Matrix3x3Batch& u, Vector3* sigma, Matrix3x3Batch& v)
+	{
+		BABOON_ZONE("Matrix3x3Batch::SVD");
+		if (u.count != m.count)
+			u.Resize(m.count);
+		if (v.count != m.count)
+			v.Resize(m.count);
+
+		Kernels().batchSVD(m, u, sigma, v);
+	}
+
+	void Matrix3x3Batch::PolarDecomposition(const Matrix3x3Batch& m, Matrix3x3Batch& rotation, Matrix3x3Batch& stretch)
+	{
+		BABOON_ZONE("Matrix3x3Batch::PolarDecomposition");
+		if (rotation.count != m.count)
+			rotation.Resize(m.count);
+		if (stretch.count != m.count)
+			stretch.Resize(m.count);
+
+		Kernels().batchPolarDecomposition(m, rotation, stretch);
+	}
+}
\ No newline at end of file
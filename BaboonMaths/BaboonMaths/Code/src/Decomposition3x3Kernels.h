@@ -0,0 +1,231 @@
+#pragma once
+#include "Lanes.h"
+
+namespace Baboon::BABOON_LANES_NAMESPACE
+{
+	// The kernels below are templated on the lane type : float for a single Matrix3x3,
+	// Lanes::Pack for Width matrices of a Matrix3x3Batch. They are branch-free for that reason.
+	namespace
+	{
+		using namespace Lanes;
+
+		// Jacobi converges quadratically, a fixed 5 sweeps reach float precision on 3x3 matrices
+		constexpr int JacobiSweeps = 5;
+		// off-diagonal entries below this fraction of the diagonal are considered converged, which
+		// also stops later sweeps from squaring them down into (very slow) denormals
+		constexpr float JacobiTolerance = 1e-9f;
+
+		// one Jacobi rotation cancelling apq, arp and arq are the entries shared with the remaining row r
+		template <class P>
+		void JacobiRotate(P& app, P& aqq, P& apq, P& arp, P& arq, P* v, int p, int q)
+		{
+			P zero = Broadcast<P>(0.f);
+			P one = Broadcast<P>(1.f);
+
+			auto done = Less(Abs(apq), Broadcast<P>(JacobiTolerance) * (Abs(app) + Abs(aqq)));
+			done = Or(done, Equal(apq, zero));
+			P theta = (aqq - app) / (Broadcast<P>(2.f) * Select(done, one, apq));
+			P t = one / (Abs(theta) + Sqrt(theta * theta + one));
+			t = Select(Less(theta, zero), -t, t);
+			t = Select(done, zero, t);
+			P c = one / Sqrt(t * t + one);
+			P s = t * c;
+
+			app = app - t * apq;
+			aqq = aqq + t * apq;
+			apq = zero;
+			P rp = c * arp - s * arq;
+			P rq = s * arp + c * arq;
+			arp = rp;
+			arq = rq;
+
+			for (int k = 0; k < 3; ++k) {
+				P vkp = v[k * 3 + p];
+				P vkq = v[k * 3 + q];
+				v[k * 3 + p] = c * vkp - s * vkq;
+				v[k * 3 + q] = s * vkp + c * vkq;
+			}
+		}
+
+		// orders values i and j decreasingly, negating one swapped column so v stays a rotation
+		template <class P>
+		void SortPair(P* values, P* v, int i, int j)
+		{
+			auto swap = Less(values[i], values[j]);
+			P vi = values[i];
+			P vj = values[j];
+			values[i] = Select(swap, vj, vi);
+			values[j] = Select(swap, vi, vj);
+
+			for (int k = 0; k < 3; ++k) {
+				P a = v[k * 3 + i];
+				P b = v[k * 3 + j];
+				v[k * 3 + i] = Select(swap, -b, a);
+				v[k * 3 + j] = Select(swap, a, b);
+			}
+		}
+
+		template <class P>
+		void EigenSymmetric(const P* a, P* values, P* v)
+		{
+			P a00 = a[0], a11 = a[4], a22 = a[8];
+			P a01 = a[1], a02 = a[2], a12 = a[5];
+
+			for (int k = 0; k < 9; ++k)
+				v[k] = Broadcast<P>(k % 4 == 0 ? 1.f : 0.f);
+
+			for (int sweep = 0; sweep < JacobiSweeps; ++sweep) {
+				JacobiRotate(a00, a11, a01, a02, a12, v, 0, 1);
+				JacobiRotate(a00, a22, a02, a01, a12, v, 0, 2);
+				JacobiRotate(a11, a22, a12, a01, a02, v, 1, 2);
+			}
+
+			values[0] = a00;
+			values[1] = a11;
+			values[2] = a22;
+			SortPair(values, v, 0, 1);
+			SortPair(values, v, 1, 2);
+			SortPair(values, v, 0, 1);
+		}
+
+		// rotates rows i and j of b to cancel b[j][i], accumulating the transposed rotation in the columns of u
+		template <class P>
+		void GivensRotate(P* b, P* u, int i, int j)
+		{
+			P zero = Broadcast<P>(0.f);
+			P one = Broadcast<P>(1.f);
+
+			P x = b[i * 3 + i];
+			P y = b[j * 3 + i];
+			P r = Sqrt(x * x + y * y);
+			auto degenerate = Equal(r, zero);
+			P invR = one / Select(degenerate, one, r);
+			P c = Select(degenerate, one, x * invR);
+			P s = Select(degenerate, zero, y * invR);
+
+			for (int k = 0; k < 3; ++k) {
+				P bi = b[i * 3 + k];
+				P bj = b[j * 3 + k];
+				b[i * 3 + k] = c * bi + s * bj;
+				b[j * 3 + k] = c * bj - s * bi;
+
+				P ui = u[k * 3 + i];
+				P uj = u[k * 3 + j];
+				u[k * 3 + i] = c * ui + s * uj;
+				u[k * 3 + j] = c * uj - s * ui;
+			}
+		}
+
+		// right singular vectors from the eigenvectors of transpose(a) * a, then a Givens QR of a * v
+		// gives u and the singular values without dividing by them, so rank deficient matrices are fine
+		template <class P>
+		void Svd(const P* a, P* u, P* sigma, P* v)
+		{
+			P ata[9];
+			for (int i = 0; i < 3; ++i) {
+				for (int j = 0; j < 3; ++j)
+					ata[i * 3 + j] = a[i] * a[j] + a[3 + i] * a[3 + j] + a[6 + i] * a[6 + j];
+			}
+
+			P values[3];
+			EigenSymmetric(ata, values, v);
+
+			P b[9];
+			for (int i = 0; i < 3; ++i) {
+				for (int j = 0; j < 3; ++j)
+					b[i * 3 + j] = a[i * 3] * v[j] + a[i * 3 + 1] * v[3 + j] + a[i * 3 + 2] * v[6 + j];
+			}
+
+			for (int k = 0; k < 9; ++k)
+				u[k] = Broadcast<P>(k % 4 == 0 ? 1.f : 0.f);
+
+			GivensRotate(b, u, 0, 1);
+			GivensRotate(b, u, 0, 2);
+			GivensRotate(b, u, 1, 2);
+
+			sigma[0] = b[0];
+			sigma[1] = b[4];
+			sigma[2] = b[8];
+		}
+
+		// rotation = u * transpose(v), stretch = v * diag(sigma) * transpose(v)
+		template <class P>
+		void Polar(const P* a, P* rotation, P* stretch)
+		{
+			P u[9], sigma[3], v[9];
+			Svd(a, u, sigma, v);
+
+			for (int i = 0; i < 3; ++i) {
+				for (int j = 0; j < 3; ++j) {
+					rotation[i * 3 + j] = u[i * 3] * v[j * 3] + u[i * 3 + 1] * v[j * 3 + 1] + u[i * 3 + 2] * v[j * 3 + 2];
+					stretch[i * 3 + j] = v[i * 3] * sigma[0] * v[j * 3] + v[i * 3 + 1] * sigma[1] * v[j * 3 + 1]
+						+ v[i * 3 + 2] * sigma[2] * v[j * 3 + 2];
+				}
+			}
+		}
+
+		void LoadLanes(const Matrix3x3Batch& m, int i, Pack* a)
+		{
+			for (int e = 0; e < 9; e++)
+				a[e] = Load(m.Element(e) + i);
+		}
+
+		void StoreLanes(Matrix3x3Batch& m, int i, const Pack* a)
+		{
+			for (int e = 0; e < 9; e++)
+				Store(m.Element(e) + i, a[e]);
+		}
+
+		// scatters three lane arrays to the Vector3 of the batch's real (non padding) matrices
+		void StoreVectors(const Pack* values, Vector3* out, int i, int count)
+		{
+			float x[Width], y[Width], z[Width];
+			Store(x, values[0]);
+			Store(y, values[1]);
+			Store(z, values[2]);
+
+			for (int j = 0; j < Width && i + j < count; j++) {
+				out[i + j].x = x[j];
+				out[i + j].y = y[j];
+				out[i + j].z = z[j];
+			}
+		}
+
+		void BatchSymmetricEigen(const Matrix3x3Batch& m, Vector3* eigenvalues, Matrix3x3Batch& eigenvectors)
+		{
+			for (int i = 0; i < m.stride; i += Width)
+			{
+				Pack a[9], values[3], v[9];
+				LoadLanes(m, i, a);
+				EigenSymmetric(a, values, v);
+				StoreLanes(eigenvectors, i, v);
+				StoreVectors(values, eigenvalues, i, m.count);
+			}
+		}
+
+		void BatchSVD(const Matrix3x3Batch& m, Matrix3x3Batch& u, Vector3* sigma, Matrix3x3Batch& v)
+		{
+			for (int i = 0; i < m.stride; i += Width)
+			{
+				Pack a[9], uLanes[9], values[3], vLanes[9];
+				LoadLanes(m, i, a);
+				Svd(a, uLanes, values, vLanes);
+				StoreLanes(u, i, uLanes);
+				StoreLanes(v, i, vLanes);
+				StoreVectors(values, sigma, i, m.count);
+			}
+		}
+
+		void BatchPolarDecomposition(const Matrix3x3Batch& m, Matrix3x3Batch& rotation, Matrix3x3Batch& stretch)
+		{
+			for (int i = 0; i < m.stride; i += Width)
+			{
+				Pack a[9], r[9], s[9];
+				LoadLanes(m, i, a);
+				Polar(a, r, s);
+				StoreLanes(rotation, i, r);
+				StoreLanes(stretch, i, s);
+			}
+		}
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "BaboonMaths.h"
+#include "Hints.h"
+#include <atomic>
+
+namespace Baboon
+{
+	// register tile of the GEMM micro kernel, the MatrixX packing lays the panels out for it
+	constexpr int GemmMR = 6;
+	constexpr int GemmNR = 16;
+
+	// The kernels built for one SimdLevel (by KernelsScalar.cpp, KernelsSSE.cpp... through Kernels.inl).
+	// The public functions keep the argument checks, resizing and threading, and call the active table.
+	struct KernelTable
+	{
+		SimdLevel level;
+
+		// row-major 4x4 products, result may alias an operand
+		void (*multiply4x4)(const float* mat1, const float* mat2, float* result);
+		void (*transform4x4)(const float* m, const float* v, float* result);
+		void (*transformPoints)(const Matrix4x4& m, const Vector3* points, Vector3* result, size_t count);
+		void (*projectToScreen)(const Matrix4x4& m, const Viewport& viewport, DepthRange range, const Vector3* points, Vector2* screen, uint8_t* clipFlags, size_t count);
+		float (*determinant4x4)(const float* m);
+		void (*determinants3x3)(const Matrix3x3* matrices, float* determinants, size_t count);
+		void (*determinants4x4)(const Matrix4x4* matrices, float* determinants, size_t count);
+		// result may be matrices, return the singular count
+		size_t (*inverses2x2)(const Matrix2x2* matrices, Matrix2x2* inverses, size_t count);
+		size_t (*inverses3x3)(const Matrix3x3* matrices, Matrix3x3* inverses, size_t count);
+		// x may be b, return the failed count (their x is zero)
+		size_t (*solveLU3x3)(const Matrix3x3* m, const Vector3* b, Vector3* x, size_t count);
+		size_t (*solveLU4x4)(const Matrix4x4* m, const Vector4* b, Vector4* x, size_t count);
+		size_t (*solveCholesky3x3)(const Matrix3x3* m, const Vector3* b, Vector3* x, size_t count);
+		size_t (*solveCholesky4x4)(const Matrix4x4* m, const Vector4* b, Vector4* x, size_t count);
+		// one row-major 3x3 matrix, the outputs must not alias a
+		void (*symmetricEigen3x3)(const float* a, float* eigenvalues, float* eigenvectors);
+		void (*svd3x3)(const float* a, float* u, float* sigma, float* v);
+		void (*polar3x3)(const float* a, float* rotation, float* stretch);
+
+		// batches already sized like their operands
+		void (*batchInverse)(Matrix3x3Batch& m);
+		void (*batchDeterminant)(const Matrix3x3Batch& m, float* determinants);
+		void (*batchMultiply)(const Matrix3x3Batch& mat1, const Matrix3x3Batch& mat2, Matrix3x3Batch& result);
+		void (*batchSymmetricEigen)(const Matrix3x3Batch& m, Vector3* eigenvalues, Matrix3x3Batch& eigenvectors);
+		void (*batchSVD)(const Matrix3x3Batch& m, Matrix3x3Batch& u, Vector3* sigma, Matrix3x3Batch& v);
+		void (*batchPolarDecomposition)(const Matrix3x3Batch& m, Matrix3x3Batch& rotation, Matrix3x3Batch& stretch);
+
+		// c += a * b for one GemmMR x GemmNR tile, a and b being packed micro panels of depth kc
+		void (*gemmMicroKernel)(int kc, const float* a, const float* b, float* c, int ldc);
+
+		void (*floatsToHalves)(const float* f, uint16_t* h, size_t count);
+		void (*halvesToFloats)(const uint16_t* h, float* f, size_t count);
+		void (*packQuaternions32)(const Quaternion* quaternions, PackedQuaternion32* packed, size_t count);
+		void (*unpackQuaternions32)(const PackedQuaternion32* packed, Quaternion* quaternions, size_t count);
+		void (*packQuaternions48)(const Quaternion* quaternions, PackedQuaternion48* packed, size_t count);
+		void (*unpackQuaternions48)(const PackedQuaternion48* packed, Quaternion* quaternions, size_t count);
+		void (*quantizeVectors)(const Vector3* vectors, QuantizedVector3* packed, size_t count, const QuantizationBounds& bounds);
+		void (*dequantizeVectors)(const QuantizedVector3* packed, Vector3* vectors, size_t count, const QuantizationBounds& bounds);
+
+		// vertices [first, end) of the mesh, first being a multiple of the lane width
+		void (*linearBlend)(const SkinStreams& mesh, const Matrix4x4* palette, Vector3* positions, Vector3* normals, int first, int end);
+		void (*dualQuaternionBlend)(const SkinStreams& mesh, const DualQuaternion* palette, Vector3* positions, Vector3* normals, int first, int end);
+
+		// particles [first, end), return the first index of a pack holding a killed particle, INT_MAX if none
+		int (*explicitEuler)(const ParticleStreams& particles, const ParticleForces& forces, float dt, int first, int end);
+		int (*semiImplicitEuler)(const ParticleStreams& particles, const ParticleForces& forces, float dt, int first, int end);
+		int (*verlet)(const ParticleStreams& particles, const ParticleForces& forces, float dt, int first, int end);
+
+		// Q16.16, integer lanes being exact every level gives the same bits
+		void (*transformFixedVectors)(const FixedMatrix3x3<Fixed16>& m, const FixedVector3<Fixed16>* vectors, FixedVector3<Fixed16>* result, size_t count);
+		void (*floatsToFixed16)(const float* f, Fixed16* fixed, size_t count);
+		void (*fixed16ToFloats)(const Fixed16* fixed, float* f, size_t count);
+
+		// GPU upload, transposed if columnMajor : mat4 from matrices of 12 or 16 floats, std140 mat3 from Matrix3x3
+		void (*packMatrices4x4)(const float* source, size_t sourceFloats, float* destination, size_t count, bool columnMajor);
+		void (*packMatrices3x3)(const Matrix3x3* matrices, float* destination, size_t count, bool columnMajor);
+	};
+
+	extern std::atomic<const KernelTable*> ActiveKernels;
+	const KernelTable& SelectKernels(); // detects the level on first use
+
+	// the table of the level Cpu::Active() reports, without any lock once picked
+	inline const KernelTable& Kernels()
+	{
+		const KernelTable* table = ActiveKernels.load(std::memory_order_acquire);
+		return BABOON_LIKELY(table != nullptr) ? *table : SelectKernels();
+	}
+
+	extern const KernelTable ScalarKernels;
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BABOON_X86
+	extern const KernelTable SseKernels;
+	extern const KernelTable Avx2Kernels;
+	extern const KernelTable Avx512Kernels;
+#endif
+}
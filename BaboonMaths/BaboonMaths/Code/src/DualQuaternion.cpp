@@ -0,0 +1,57 @@
+#include "BaboonMaths.h"
+#include "Profile.h"
+
+namespace Baboon
+{
+	DualQuaternion::DualQuaternion() : real(), dual(0.f, 0.f, 0.f, 0.f) {}
+
+	DualQuaternion::DualQuaternion(const Quaternion& rotation, const Vector3& translation)
+		: real(rotation), dual(Quaternion(translation.x, translation.y, translation.z, 0.f) * rotation)
+	{
+		dual = Quaternion(dual.x * 0.5f, dual.y * 0.5f, dual.z * 0.5f, dual.w * 0.5f);
+	}
+
+	DualQuaternion DualQuaternion::FromMatrix(const Matrix4x4& m)
+	{
+		BABOON_PROFILE_SCOPE("DualQuaternion::FromMatrix");
+		const std::array<float, 16>& e = m.elements;
+		Vector3 columns[3] = {
+			Vector3::Normalize(Vector3(e[0], e[4], e[8])),
+			Vector3::Normalize(Vector3(e[1], e[5], e[9])),
+			Vector3::Normalize(Vector3(e[2], e[6], e[10]))
+		};
+
+		Quaternion rotation = Quaternion::FromMatrix(Matrix3x3({
+			columns[0].x, columns[1].x, columns[2].x,
+			columns[0].y, columns[1].y, columns[2].y,
+			columns[0].z, columns[1].z, columns[2].z
+			}));
+		return DualQuaternion(Quaternion::Normalize(rotation), Vector3(e[3], e[7], e[11]));
+	}
+
+	void DualQuaternion::FromMatrices(const Matrix4x4* matrices, DualQuaternion* result, int count)
+	{
+		BABOON_ZONE("DualQuaternion::FromMatrices");
+		for (int i = 0; i < count; i++)
+			result[i] = FromMatrix(matrices[i]);
+	}
+
+	Vector3 DualQuaternion::TransformPoint(const DualQuaternion& dq, const Vector3& p)
+	{
+		BABOON_PROFILE_SCOPE("DualQuaternion::TransformPoint");
+		// translation = 2 * vector part of dual * conjugate(real)
+		const Quaternion& r = dq.real;
+		const Quaternion& d = dq.dual;
+		Vector3 t(
+			2.f * (r.w * d.x - d.w * r.x + r.y * d.z - r.z * d.y),
+			2.f * (r.w * d.y - d.w * r.y + r.z * d.x - r.x * d.z),
+			2.f * (r.w * d.z - d.w * r.z + r.x * d.y - r.y * d.x));
+		return Quaternion::Rotate(r, p) + t;
+	}
+
+	Vector3 DualQuaternion::TransformVector(const DualQuaternion& dq, const Vector3& v)
+	{
+		BABOON_PROFILE_SCOPE("DualQuaternion::TransformVector");
+		return Quaternion::Rotate(dq.real, v);
+	}
+}
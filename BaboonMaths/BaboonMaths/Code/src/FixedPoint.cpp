@@ -0,0 +1,469 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Profile.h"
+
+namespace Baboon
+{
+	namespace
+	{
+		// sine of the quarter wave in Q2.30, one step past pi / 2 so the interpolation never reads out of the table.
+		// Built at compile time from the double precision series, which every compiler evaluates with the same
+		// IEEE operations : the table, and so the trigonometry, is the same in every build.
+		constexpr int QuarterSteps = 4096;
+		constexpr int StepBits = 18; // 2^30 / QuarterSteps
+
+		struct SineTable
+		{
+			int32_t values[QuarterSteps + 2];
+		};
+
+		constexpr SineTable BuildSineTable()
+		{
+			SineTable table{};
+			for (int i = 0; i < QuarterSteps + 2; i++) {
+				double angle = i * (1.57079632679489661923 / QuarterSteps);
+				double s = angle <= 0.78539816339744830962 ? SinPolynomial(angle) : CosPolynomial(1.57079632679489661923 - angle);
+				table.values[i] = (int32_t)(s * 1073741824. + 0.5);
+			}
+			return table;
+		}
+
+		constexpr SineTable QuarterSine = BuildSineTable();
+
+		// round(2^32 / (2 pi)) and round(2^64 / (2 pi)) : radians to 32 bit turns, 2^32 being a whole turn
+		constexpr int64_t TurnsPerRadian = 683565276;
+		constexpr uint64_t TurnsPerRadian64 = 2935890503282001226u;
+
+		template <class Raw, int FractionBits>
+		uint32_t Turns(Fixed<Raw, FractionBits> angle)
+		{
+			if constexpr (sizeof(Raw) <= 4) {
+				return (uint32_t)(((int64_t)angle.raw * TurnsPerRadian) >> FractionBits);
+			}
+			else {
+				// high half of the 128 bit raw * TurnsPerRadian64, modulo 2^32 : only its low 32 bits are needed
+				static_assert(FractionBits == 32, "the Q32.32 turns are the high half of the 128 bit product");
+				uint64_t a = (uint64_t)angle.raw;
+				uint64_t al = a & 0xffffffffu, ah = a >> 32, kl = TurnsPerRadian64 & 0xffffffffu, kh = TurnsPerRadian64 >> 32;
+				uint64_t middle = ((al * kl) >> 32) + (al * kh & 0xffffffffu) + (ah * kl & 0xffffffffu);
+				uint64_t high = ah * kh + ((al * kh) >> 32) + ((ah * kl) >> 32) + (middle >> 32);
+				if (angle.raw < 0)
+					high -= TurnsPerRadian64;
+				return (uint32_t)high;
+			}
+		}
+
+		// sine in Q2.30 of a 32 bit turn, linearly interpolated in the table
+		int64_t SineQ30(uint32_t turns)
+		{
+			uint32_t quadrant = turns >> 30;
+			uint32_t position = turns & 0x3fffffffu;
+			if (quadrant & 1)
+				position = 0x40000000u - position;
+
+			uint32_t index = position >> StepBits, fraction = position & ((1u << StepBits) - 1);
+			int64_t a = QuarterSine.values[index], b = QuarterSine.values[index + 1];
+			int64_t s = a + (((b - a) * fraction) >> StepBits);
+			return quadrant & 2 ? -s : s;
+		}
+
+		template <class Raw, int FractionBits>
+		Fixed<Raw, FractionBits> FromQ30(int64_t s)
+		{
+			if constexpr (FractionBits < 30)
+				return Fixed<Raw, FractionBits>::FromRaw((Raw)((s + (1 << (29 - FractionBits))) >> (30 - FractionBits)));
+			else
+				return Fixed<Raw, FractionBits>::FromRaw((Raw)(s * ((int64_t)1 << (FractionBits - 30))));
+		}
+
+		// floor of the square root of high * 2^64 + low, one result bit at a time
+		uint64_t SquareRoot128(uint64_t high, uint64_t low)
+		{
+			uint64_t root = 0;
+			for (int bit = 63; bit >= 0; bit--)
+			{
+				uint64_t candidate = root | ((uint64_t)1 << bit);
+				uint64_t cl = candidate & 0xffffffffu, ch = candidate >> 32;
+				uint64_t ll = cl * cl, lh = cl * ch, hh = ch * ch;
+				uint64_t middle = (ll >> 32) + 2 * (lh & 0xffffffffu);
+				uint64_t squareLow = (middle << 32) | (ll & 0xffffffffu);
+				uint64_t squareHigh = hh + 2 * (lh >> 32) + (middle >> 32);
+				if (squareHigh < high || (squareHigh == high && squareLow <= low))
+					root = candidate;
+			}
+			return root;
+		}
+
+		uint64_t SquareRoot64(uint64_t n)
+		{
+			uint64_t root = 0;
+			for (int bit = 31; bit >= 0; bit--)
+			{
+				uint64_t candidate = root | ((uint64_t)1 << bit);
+				if (candidate * candidate <= n)
+					root = candidate;
+			}
+			return root;
+		}
+	}
+
+	template <class Raw, int FractionBits>
+	void Fixed<Raw, FractionBits>::FromFloats(const float* f, Fixed* fixed, size_t count)
+	{
+		BABOON_ZONE("Fixed::FromFloats");
+		if constexpr (sizeof(Raw) <= 4)
+			Kernels().floatsToFixed16(f, fixed, count);
+		else {
+			for (size_t i = 0; i < count; i++)
+				fixed[i] = FromFloat(f[i]);
+		}
+	}
+
+	template <class Raw, int FractionBits>
+	void Fixed<Raw, FractionBits>::ToFloats(const Fixed* fixed, float* f, size_t count)
+	{
+		BABOON_ZONE("Fixed::ToFloats");
+		if constexpr (sizeof(Raw) <= 4)
+			Kernels().fixed16ToFloats(fixed, f, count);
+		else {
+			for (size_t i = 0; i < count; i++)
+				f[i] = fixed[i].ToFloat();
+		}
+	}
+
+	template <class Raw, int FractionBits>
+	Fixed<Raw, FractionBits> Sin(Fixed<Raw, FractionBits> angle)
+	{
+		BABOON_PROFILE_SCOPE("Fixed::Sin");
+		return FromQ30<Raw, FractionBits>(SineQ30(Turns(angle)));
+	}
+
+	template <class Raw, int FractionBits>
+	Fixed<Raw, FractionBits> Cos(Fixed<Raw, FractionBits> angle)
+	{
+		BABOON_PROFILE_SCOPE("Fixed::Cos");
+		return FromQ30<Raw, FractionBits>(SineQ30(Turns(angle) + 0x40000000u));
+	}
+
+	template <class Raw, int FractionBits>
+	void SinCos(Fixed<Raw, FractionBits> angle, Fixed<Raw, FractionBits>& sine, Fixed<Raw, FractionBits>& cosine)
+	{
+		BABOON_PROFILE_SCOPE("Fixed::SinCos");
+		uint32_t turns = Turns(angle);
+		sine = FromQ30<Raw, FractionBits>(SineQ30(turns));
+		cosine = FromQ30<Raw, FractionBits>(SineQ30(turns + 0x40000000u));
+	}
+
+	template <class Raw, int FractionBits>
+	Fixed<Raw, FractionBits> Sqrt(Fixed<Raw, FractionBits> x)
+	{
+		BABOON_PROFILE_SCOPE("Fixed::Sqrt");
+		if (x.raw <= 0)
+			return Fixed<Raw, FractionBits>();
+
+		// sqrt(raw / 2^n) * 2^n = sqrt(raw * 2^n)
+		uint64_t raw = (uint64_t)x.raw;
+		if constexpr (sizeof(Raw) <= 4)
+			return Fixed<Raw, FractionBits>::FromRaw((Raw)SquareRoot64(raw << FractionBits));
+		else
+			return Fixed<Raw, FractionBits>::FromRaw((Raw)SquareRoot128(raw >> (64 - FractionBits), raw << FractionBits));
+	}
+
+	template <class Raw, int FractionBits>
+	Fixed<Raw, FractionBits> Abs(Fixed<Raw, FractionBits> x)
+	{
+		BABOON_PROFILE_SCOPE("Fixed::Abs");
+		return x.raw < 0 ? -x : x;
+	}
+
+	template <class F>
+	FixedVector2<F> FixedVector2<F>::FromVector(const Vector2& v)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector2::FromVector");
+		return FixedVector2(F::FromFloat(v.x), F::FromFloat(v.y));
+	}
+
+	template <class F>
+	Vector2 FixedVector2<F>::ToVector() const
+	{
+		BABOON_PROFILE_SCOPE("FixedVector2::ToVector");
+		return Vector2(x.ToFloat(), y.ToFloat());
+	}
+
+	template <class F>
+	F FixedVector2<F>::DotProduct(FixedVector2 v1, FixedVector2 v2)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector2::DotProduct");
+		return v1.x * v2.x + v1.y * v2.y;
+	}
+
+	template <class F>
+	F FixedVector2<F>::CrossProduct(FixedVector2 v1, FixedVector2 v2)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector2::CrossProduct");
+		return v1.x * v2.y - v1.y * v2.x;
+	}
+
+	template <class F>
+	F FixedVector2<F>::SquaredNorm(FixedVector2 v)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector2::SquaredNorm");
+		return DotProduct(v, v);
+	}
+
+	template <class F>
+	F FixedVector2<F>::Norm(FixedVector2 v)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector2::Norm");
+		return Sqrt(SquaredNorm(v));
+	}
+
+	template <class F>
+	FixedVector2<F> FixedVector2<F>::Normalize(FixedVector2 v)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector2::Normalize");
+		F norm = Norm(v);
+		if (norm == F())
+			return v;
+
+		return v / norm;
+	}
+
+	template <class F>
+	FixedVector2<F> FixedVector2<F>::Rotate(FixedVector2 p, F theta, FixedVector2 anchor)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector2::Rotate");
+		F s, c;
+		SinCos(theta, s, c);
+
+		FixedVector2 pTemp = p - anchor;
+		return FixedVector2(pTemp.x * c - pTemp.y * s, pTemp.x * s + pTemp.y * c) + anchor;
+	}
+
+	template <class F>
+	FixedVector3<F> FixedVector3<F>::FromVector(const Vector3& v)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector3::FromVector");
+		return FixedVector3(F::FromFloat(v.x), F::FromFloat(v.y), F::FromFloat(v.z));
+	}
+
+	template <class F>
+	Vector3 FixedVector3<F>::ToVector() const
+	{
+		BABOON_PROFILE_SCOPE("FixedVector3::ToVector");
+		return Vector3(x.ToFloat(), y.ToFloat(), z.ToFloat());
+	}
+
+	template <class F>
+	F FixedVector3<F>::DotProduct(FixedVector3 v1, FixedVector3 v2)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector3::DotProduct");
+		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+	}
+
+	template <class F>
+	FixedVector3<F> FixedVector3<F>::CrossProduct(FixedVector3 v1, FixedVector3 v2)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector3::CrossProduct");
+		return FixedVector3(v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x);
+	}
+
+	template <class F>
+	F FixedVector3<F>::SquaredNorm(FixedVector3 v)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector3::SquaredNorm");
+		return DotProduct(v, v);
+	}
+
+	template <class F>
+	F FixedVector3<F>::Norm(FixedVector3 v)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector3::Norm");
+		return Sqrt(SquaredNorm(v));
+	}
+
+	template <class F>
+	FixedVector3<F> FixedVector3<F>::Normalize(FixedVector3 v)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector3::Normalize");
+		F norm = Norm(v);
+		if (norm == F())
+			return v;
+
+		return v / norm;
+	}
+
+	template <class F>
+	FixedVector3<F> FixedVector3<F>::Rotate(FixedVector3 p, F thetaX, F thetaY, F thetaZ)
+	{
+		BABOON_PROFILE_SCOPE("FixedVector3::Rotate");
+		return FixedMatrix3x3<F>::Rotation(thetaX, thetaY, thetaZ) * p;
+	}
+
+	template <class F>
+	FixedMatrix2x2<F> FixedMatrix2x2<F>::FromMatrix(const Matrix2x2& m)
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix2x2::FromMatrix");
+		FixedMatrix2x2 f;
+		for (int i = 0; i < 4; i++)
+			f.elements[i] = F::FromFloat(m.elements[i]);
+		return f;
+	}
+
+	template <class F>
+	Matrix2x2 FixedMatrix2x2<F>::ToMatrix() const
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix2x2::ToMatrix");
+		Matrix2x2 m;
+		for (int i = 0; i < 4; i++)
+			m.elements[i] = elements[i].ToFloat();
+		return m;
+	}
+
+	template <class F>
+	FixedMatrix2x2<F> FixedMatrix2x2<F>::Multiply(const FixedMatrix2x2& mat1, const FixedMatrix2x2& mat2)
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix2x2::Multiply");
+		FixedMatrix2x2 m;
+		for (int i = 0; i < 2; ++i) {
+			for (int j = 0; j < 2; ++j)
+				m.elements[i * 2 + j] = mat1.elements[i * 2] * mat2.elements[j] + mat1.elements[i * 2 + 1] * mat2.elements[2 + j];
+		}
+		return m;
+	}
+
+	template <class F>
+	FixedMatrix2x2<F> FixedMatrix2x2<F>::Rotation(F theta)
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix2x2::Rotation");
+		F s, c;
+		SinCos(theta, s, c);
+		return FixedMatrix2x2({
+			c, -s,
+			s, c
+			});
+	}
+
+	template <class F>
+	FixedMatrix3x3<F> FixedMatrix3x3<F>::FromMatrix(const Matrix3x3& m)
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix3x3::FromMatrix");
+		FixedMatrix3x3 f;
+		for (int i = 0; i < 9; i++)
+			f.elements[i] = F::FromFloat(m.elements[i]);
+		return f;
+	}
+
+	template <class F>
+	Matrix3x3 FixedMatrix3x3<F>::ToMatrix() const
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix3x3::ToMatrix");
+		Matrix3x3 m;
+		for (int i = 0; i < 9; i++)
+			m.elements[i] = elements[i].ToFloat();
+		return m;
+	}
+
+	template <class F>
+	void FixedMatrix3x3<F>::Transpose()
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix3x3::Transpose");
+		std::swap(elements[1], elements[3]);
+		std::swap(elements[2], elements[6]);
+		std::swap(elements[5], elements[7]);
+	}
+
+	template <class F>
+	FixedMatrix3x3<F> FixedMatrix3x3<F>::Multiply(const FixedMatrix3x3& mat1, const FixedMatrix3x3& mat2)
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix3x3::Multiply");
+		FixedMatrix3x3 m;
+		for (int i = 0; i < 3; ++i) {
+			for (int j = 0; j < 3; ++j) {
+				m.elements[i * 3 + j] = mat1.elements[i * 3] * mat2.elements[j] + mat1.elements[i * 3 + 1] * mat2.elements[3 + j]
+					+ mat1.elements[i * 3 + 2] * mat2.elements[6 + j];
+			}
+		}
+		return m;
+	}
+
+	template <class F>
+	FixedMatrix3x3<F> FixedMatrix3x3<F>::Rotation(F thetaX, F thetaY, F thetaZ)
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix3x3::Rotation");
+		return RotationZ(thetaZ) * RotationY(thetaY) * RotationX(thetaX);
+	}
+
+	template <class F>
+	FixedMatrix3x3<F> FixedMatrix3x3<F>::RotationX(F thetaX)
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix3x3::RotationX");
+		F s, c;
+		SinCos(thetaX, s, c);
+		return FixedMatrix3x3({
+			F(1), F(), F(),
+			F(), c, -s,
+			F(), s, c
+			});
+	}
+
+	template <class F>
+	FixedMatrix3x3<F> FixedMatrix3x3<F>::RotationY(F thetaY)
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix3x3::RotationY");
+		F s, c;
+		SinCos(thetaY, s, c);
+		return FixedMatrix3x3({
+			c, F(), s,
+			F(), F(1), F(),
+			-s, F(), c
+			});
+	}
+
+	template <class F>
+	FixedMatrix3x3<F> FixedMatrix3x3<F>::RotationZ(F thetaZ)
+	{
+		BABOON_PROFILE_SCOPE("FixedMatrix3x3::RotationZ");
+		F s, c;
+		SinCos(thetaZ, s, c);
+		return FixedMatrix3x3({
+			c, -s, F(),
+			s, c, F(),
+			F(), F(), F(1)
+			});
+	}
+
+	template <class F>
+	void FixedMatrix3x3<F>::TransformVectors(const FixedMatrix3x3& m, const FixedVector3<F>* vectors, FixedVector3<F>* result, size_t count)
+	{
+		BABOON_ZONE("FixedMatrix3x3::TransformVectors");
+		if constexpr (std::is_same_v<F, Fixed16>)
+			Kernels().transformFixedVectors(m, vectors, result, count);
+		else {
+			for (size_t i = 0; i < count; i++)
+				result[i] = m * vectors[i];
+		}
+	}
+
+	template class Fixed<int32_t, 16>;
+	template class Fixed<int64_t, 32>;
+	template class FixedVector2<Fixed16>;
+	template class FixedVector2<Fixed32>;
+	template class FixedVector3<Fixed16>;
+	template class FixedVector3<Fixed32>;
+	template class FixedMatrix2x2<Fixed16>;
+	template class FixedMatrix2x2<Fixed32>;
+	template class FixedMatrix3x3<Fixed16>;
+	template class FixedMatrix3x3<Fixed32>;
+
+	template Fixed16 Sin(Fixed16 angle);
+	template Fixed32 Sin(Fixed32 angle);
+	template Fixed16 Cos(Fixed16 angle);
+	template Fixed32 Cos(Fixed32 angle);
+	template void SinCos(Fixed16 angle, Fixed16& sine, Fixed16& cosine);
+	template void SinCos(Fixed32 angle, Fixed32& sine, Fixed32& cosine);
+	template Fixed16 Sqrt(Fixed16 x);
+	template Fixed32 Sqrt(Fixed32 x);
+	template Fixed16 Abs(Fixed16 x);
+	template Fixed32 Abs(Fixed32 x);
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include "Lanes.h"
+
+namespace Baboon::BABOON_LANES_NAMESPACE
+{
+	namespace
+	{
+		using namespace Lanes;
+
+		// Q16.16 lanes : a product keeps bits 16 to 47 of the 64 bit product, as the arithmetic shift of the scalar
+		// code does. Only AVX2 and AVX-512 have the signed 32 x 32 -> 64 bit products, SSE2 converts only.
+#if defined(BABOON_LANES_AVX512)
+		using FixedPack = __m512i;
+		inline FixedPack LoadFixed(const int32_t* p) { return _mm512_loadu_si512(p); }
+		inline void StoreFixed(int32_t* p, FixedPack a) { _mm512_storeu_si512(p, a); }
+		inline FixedPack BroadcastFixed(int32_t r) { return _mm512_set1_epi32(r); }
+		inline FixedPack AddFixed(FixedPack a, FixedPack b) { return _mm512_add_epi32(a, b); }
+		inline FixedPack MultiplyFixed(FixedPack a, FixedPack b)
+		{
+			// even lanes shifted down in place, odd lanes products shifted up into the high half
+			__m512i even = _mm512_srli_epi64(_mm512_mul_epi32(a, b), 16);
+			__m512i odd = _mm512_slli_epi64(_mm512_mul_epi32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32)), 16);
+			return _mm512_mask_blend_epi32(0xAAAA, even, odd);
+		}
+		inline FixedPack ToFixed(Pack f)
+		{
+			// the conversion gives INT32_MIN out of range and for NaN, the values above the range become INT32_MAX, NaN 0
+			__m512 scaled = _mm512_mul_ps(f.v, _mm512_set1_ps(65536.f));
+			__m512i r = _mm512_cvtps_epi32(scaled);
+			r = _mm512_mask_mov_epi32(r, _mm512_cmp_ps_mask(scaled, _mm512_set1_ps(2147483648.f), _CMP_GE_OQ), _mm512_set1_epi32(INT32_MAX));
+			return _mm512_maskz_mov_epi32(_mm512_cmp_ps_mask(scaled, scaled, _CMP_ORD_Q), r);
+		}
+		inline Pack FromFixed(FixedPack a) { return { _mm512_mul_ps(_mm512_cvtepi32_ps(a), _mm512_set1_ps(1.f / 65536.f)) }; }
+#elif defined(BABOON_LANES_AVX2)
+		using FixedPack = __m256i;
+		inline FixedPack LoadFixed(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+		inline void StoreFixed(int32_t* p, FixedPack a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a); }
+		inline FixedPack BroadcastFixed(int32_t r) { return _mm256_set1_epi32(r); }
+		inline FixedPack AddFixed(FixedPack a, FixedPack b) { return _mm256_add_epi32(a, b); }
+		inline FixedPack MultiplyFixed(FixedPack a, FixedPack b)
+		{
+			__m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, b), 16);
+			__m256i odd = _mm256_slli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)), 16);
+			return _mm256_blend_epi32(even, odd, 0xAA);
+		}
+		inline FixedPack ToFixed(Pack f)
+		{
+			// INT32_MIN flipped to INT32_MAX above the range, NaN lanes cleared
+			__m256 scaled = _mm256_mul_ps(f.v, _mm256_set1_ps(65536.f));
+			__m256i r = _mm256_cvtps_epi32(scaled);
+			r = _mm256_xor_si256(r, _mm256_castps_si256(_mm256_cmp_ps(scaled, _mm256_set1_ps(2147483648.f), _CMP_GE_OQ)));
+			return _mm256_and_si256(r, _mm256_castps_si256(_mm256_cmp_ps(scaled, scaled, _CMP_ORD_Q)));
+		}
+		inline Pack FromFixed(FixedPack a) { return { _mm256_mul_ps(_mm256_cvtepi32_ps(a), _mm256_set1_ps(1.f / 65536.f)) }; }
+#elif defined(BABOON_LANES_SSE)
+		using FixedPack = __m128i;
+		inline FixedPack LoadFixed(const int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+		inline void StoreFixed(int32_t* p, FixedPack a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a); }
+		inline FixedPack ToFixed(Pack f)
+		{
+			// as AVX2
+			__m128 scaled = _mm_mul_ps(f.v, _mm_set1_ps(65536.f));
+			__m128i r = _mm_cvtps_epi32(scaled);
+			r = _mm_xor_si128(r, _mm_castps_si128(_mm_cmpge_ps(scaled, _mm_set1_ps(2147483648.f))));
+			return _mm_and_si128(r, _mm_castps_si128(_mm_cmpord_ps(scaled, scaled)));
+		}
+		inline Pack FromFixed(FixedPack a) { return { _mm_mul_ps(_mm_cvtepi32_ps(a), _mm_set1_ps(1.f / 65536.f)) }; }
+#endif
+		// the scalar tails compute on the raw integers too, the Fixed operators are shared with the whole library
+		inline int32_t MultiplyFixed(int32_t a, int32_t b) { return (int32_t)(((int64_t)a * b) >> 16); }
+		inline int32_t AddFixed(int32_t a, int32_t b) { return (int32_t)((uint32_t)a + (uint32_t)b); }
+		// Fixed16::FromFloat : nearest, saturated, 0 for NaN
+		inline int32_t ToFixed(float f)
+		{
+			double r = nearbyint((double)f * 65536.);
+			if (r != r)
+				return 0;
+			return r >= 2147483648. ? INT32_MAX : r <= -2147483648. ? INT32_MIN : (int32_t)r;
+		}
+
+		void TransformFixedVectors(const FixedMatrix3x3<Fixed16>& m, const FixedVector3<Fixed16>* vectors, FixedVector3<Fixed16>* result, size_t count)
+		{
+			size_t i = 0;
+#if defined(BABOON_LANES_AVX2) || defined(BABOON_LANES_AVX512)
+			FixedPack lanes[9];
+			for (int k = 0; k < 9; k++)
+				lanes[k] = BroadcastFixed(m.elements[k].raw);
+
+			for (; i + Width <= count; i += Width)
+			{
+				int32_t x[Width], y[Width], z[Width];
+				for (int j = 0; j < Width; j++) {
+					x[j] = vectors[i + j].x.raw;
+					y[j] = vectors[i + j].y.raw;
+					z[j] = vectors[i + j].z.raw;
+				}
+
+				FixedPack px = LoadFixed(x), py = LoadFixed(y), pz = LoadFixed(z);
+				StoreFixed(x, AddFixed(AddFixed(MultiplyFixed(lanes[0], px), MultiplyFixed(lanes[1], py)), MultiplyFixed(lanes[2], pz)));
+				StoreFixed(y, AddFixed(AddFixed(MultiplyFixed(lanes[3], px), MultiplyFixed(lanes[4], py)), MultiplyFixed(lanes[5], pz)));
+				StoreFixed(z, AddFixed(AddFixed(MultiplyFixed(lanes[6], px), MultiplyFixed(lanes[7], py)), MultiplyFixed(lanes[8], pz)));
+
+				for (int j = 0; j < Width; j++) {
+					result[i + j].x.raw = x[j];
+					result[i + j].y.raw = y[j];
+					result[i + j].z.raw = z[j];
+				}
+			}
+#endif
+			for (; i < count; i++)
+			{
+				const int32_t x = vectors[i].x.raw, y = vectors[i].y.raw, z = vectors[i].z.raw;
+				int32_t r[3];
+				for (int k = 0; k < 3; k++)
+					r[k] = AddFixed(AddFixed(MultiplyFixed(m.elements[3 * k].raw, x), MultiplyFixed(m.elements[3 * k + 1].raw, y)), MultiplyFixed(m.elements[3 * k + 2].raw, z));
+				result[i].x.raw = r[0];
+				result[i].y.raw = r[1];
+				result[i].z.raw = r[2];
+			}
+		}
+
+		static_assert(sizeof(Fixed16) == sizeof(int32_t), "a Fixed16 array is an int32_t array");
+
+		void FloatsToFixed16(const float* f, Fixed16* fixed, size_t count)
+		{
+			size_t i = 0;
+#if !defined(BABOON_LANES_SCALAR)
+			for (; i + Width <= count; i += Width)
+				StoreFixed(reinterpret_cast<int32_t*>(fixed + i), ToFixed(Load(f + i)));
+#endif
+			for (; i < count; i++)
+				fixed[i].raw = ToFixed(f[i]);
+		}
+
+		void Fixed16ToFloats(const Fixed16* fixed, float* f, size_t count)
+		{
+			size_t i = 0;
+#if !defined(BABOON_LANES_SCALAR)
+			for (; i + Width <= count; i += Width)
+				Store(f + i, FromFixed(LoadFixed(reinterpret_cast<const int32_t*>(fixed + i))));
+#endif
+			for (; i < count; i++)
+				f[i] = (float)fixed[i].raw * (1.f / 65536.f);
+		}
+	}
+}
@@ -0,0 +1,90 @@
+#include "BaboonMaths.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace Baboon
+{
+	namespace
+	{
+		// the buffer is aligned for the widest SIMD registers and a cache line
+		constexpr size_t BufferAlignment = 64;
+	}
+
+	FrameArena::FrameArena(size_t _capacity, std::pmr::memory_resource* _upstream)
+		: upstream(_upstream), buffer(nullptr), capacity(_capacity), offset(0), overflowBytes(0)
+	{
+		if (capacity > 0)
+			buffer = static_cast<char*>(upstream->allocate(capacity, BufferAlignment));
+	}
+
+	FrameArena::~FrameArena()
+	{
+		for (const Overflow& o : overflows)
+			upstream->deallocate(o.p, o.bytes, o.alignment);
+
+		if (buffer)
+			upstream->deallocate(buffer, capacity, BufferAlignment);
+	}
+
+	void FrameArena::Reset()
+	{
+		// when the frame did not fit, the buffer grows to hold all of it, so Reset stays a rewind from then on
+		if (!overflows.empty())
+		{
+			for (const Overflow& o : overflows)
+				upstream->deallocate(o.p, o.bytes, o.alignment);
+			overflows.clear();
+
+			size_t newCapacity = std::max(capacity * 2, offset + overflowBytes);
+			if (buffer)
+				upstream->deallocate(buffer, capacity, BufferAlignment);
+			buffer = static_cast<char*>(upstream->allocate(newCapacity, BufferAlignment));
+			capacity = newCapacity;
+			overflowBytes = 0;
+		}
+
+		offset = 0;
+	}
+
+	size_t FrameArena::Capacity() const
+	{
+		return capacity;
+	}
+
+	size_t FrameArena::Used() const
+	{
+		return offset + overflowBytes;
+	}
+
+	void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+	{
+		if (buffer)
+		{
+			uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+			uintptr_t start = (base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+			size_t end = (size_t)(start - base) + bytes;
+			if (end <= capacity)
+			{
+				offset = end;
+				return reinterpret_cast<void*>(start);
+			}
+		}
+
+		void* p = upstream->allocate(bytes, alignment);
+		overflows.push_back({ p, bytes, alignment });
+		overflowBytes += bytes + alignment;
+		return p;
+	}
+
+	void FrameArena::do_deallocate(void* p, size_t bytes, size_t)
+	{
+		// only the latest allocation is given back, which is enough for a growing vector to reuse its old space
+		if (buffer && static_cast<char*>(p) + bytes == buffer + offset)
+			offset = (size_t)(static_cast<char*>(p) - buffer);
+	}
+
+	bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+	{
+		return this == &other;
+	}
+}
@@ -0,0 +1,26 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Profile.h"
+
+namespace Baboon
+{
+	void GpuUpload::PackMatrices(const Matrix4x4* matrices, void* destination, size_t count, MatrixLayout layout)
+	{
+		BABOON_ZONE("GpuUpload::PackMatrices");
+		static_assert(sizeof(Matrix4x4) == 16 * sizeof(float), "Matrix4x4 arrays are read as packed floats");
+		Kernels().packMatrices4x4(reinterpret_cast<const float*>(matrices), 16, (float*)destination, count, layout == MatrixLayout::ColumnMajor);
+	}
+
+	void GpuUpload::PackMatrices(const Affine3* transforms, void* destination, size_t count, MatrixLayout layout)
+	{
+		BABOON_ZONE("GpuUpload::PackMatrices");
+		static_assert(sizeof(Affine3) == 12 * sizeof(float), "Affine3 arrays are read as packed floats");
+		Kernels().packMatrices4x4(reinterpret_cast<const float*>(transforms), 12, (float*)destination, count, layout == MatrixLayout::ColumnMajor);
+	}
+
+	void GpuUpload::PackMatrices(const Matrix3x3* matrices, void* destination, size_t count, MatrixLayout layout)
+	{
+		BABOON_ZONE("GpuUpload::PackMatrices");
+		Kernels().packMatrices3x3(matrices, (float*)destination, count, layout == MatrixLayout::ColumnMajor);
+	}
+}
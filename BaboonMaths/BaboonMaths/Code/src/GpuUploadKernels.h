@@ -0,0 +1,112 @@
+#pragma once
+#include "Lanes.h"
+
+namespace Baboon::BABOON_LANES_NAMESPACE
+{
+	namespace
+	{
+		using namespace Lanes;
+
+		// Upload buffers are usually write-combined : never read, written once in full 16 byte pieces. Every level
+		// writes them a row or a column (one SSE register) at a time, with non-temporal stores when the destination
+		// is 16 byte aligned, then fences so the stores are visible before the caller hands the buffer over.
+#if !defined(BABOON_LANES_SCALAR)
+		template <bool Stream>
+		inline void StoreRow(float* p, __m128 row)
+		{
+			if constexpr (Stream)
+				_mm_stream_ps(p, row);
+			else
+				_mm_storeu_ps(p, row);
+		}
+
+		template <bool Stream>
+		void PackMatrices4x4Rows(const float* source, size_t sourceFloats, float* destination, size_t count, bool columnMajor)
+		{
+			const __m128 bottom = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+			for (size_t i = 0; i < count; i++, source += sourceFloats, destination += 16)
+			{
+				__m128 r0 = _mm_loadu_ps(source), r1 = _mm_loadu_ps(source + 4), r2 = _mm_loadu_ps(source + 8);
+				__m128 r3 = sourceFloats == 16 ? _mm_loadu_ps(source + 12) : bottom;
+				if (columnMajor)
+					_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+				StoreRow<Stream>(destination, r0);
+				StoreRow<Stream>(destination + 4, r1);
+				StoreRow<Stream>(destination + 8, r2);
+				StoreRow<Stream>(destination + 12, r3);
+			}
+		}
+
+		template <bool Stream>
+		void PackMatrices3x3Rows(const Matrix3x3* matrices, float* destination, size_t count, bool columnMajor)
+		{
+			// the third row is loaded from element 5 so nothing is read past the matrix, the padding floats are 0
+			const __m128 keep3 = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+			for (size_t i = 0; i < count; i++, destination += 12)
+			{
+				const float* m = matrices[i].elements.data();
+				__m128 r0 = _mm_loadu_ps(m), r1 = _mm_loadu_ps(m + 3), r2 = _mm_loadu_ps(m + 5);
+				r2 = _mm_shuffle_ps(r2, r2, _MM_SHUFFLE(0, 3, 2, 1));
+				if (columnMajor) {
+					__m128 r3 = _mm_setzero_ps();
+					_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+				}
+				else {
+					r0 = _mm_and_ps(r0, keep3);
+					r1 = _mm_and_ps(r1, keep3);
+					r2 = _mm_and_ps(r2, keep3);
+				}
+				StoreRow<Stream>(destination, r0);
+				StoreRow<Stream>(destination + 4, r1);
+				StoreRow<Stream>(destination + 8, r2);
+			}
+		}
+#endif
+
+		// count matrices of 3 or 4 rows, sourceFloats apart, as mat4 : the missing bottom row is (0, 0, 0, 1)
+		void PackMatrices4x4(const float* source, size_t sourceFloats, float* destination, size_t count, bool columnMajor)
+		{
+#if defined(BABOON_LANES_SCALAR)
+			for (size_t i = 0; i < count; i++, source += sourceFloats, destination += 16)
+			{
+				for (int r = 0; r < 4; ++r) {
+					for (int c = 0; c < 4; ++c) {
+						float e = r < 3 || sourceFloats == 16 ? source[r * 4 + c] : (c == 3 ? 1.f : 0.f);
+						destination[columnMajor ? c * 4 + r : r * 4 + c] = e;
+					}
+				}
+			}
+#else
+			if (((uintptr_t)destination & 15) == 0) {
+				PackMatrices4x4Rows<true>(source, sourceFloats, destination, count, columnMajor);
+				_mm_sfence();
+			}
+			else
+				PackMatrices4x4Rows<false>(source, sourceFloats, destination, count, columnMajor);
+#endif
+		}
+
+		// count Matrix3x3 as std140 mat3 : 3 rows or columns padded to 4 floats
+		void PackMatrices3x3(const Matrix3x3* matrices, float* destination, size_t count, bool columnMajor)
+		{
+#if defined(BABOON_LANES_SCALAR)
+			for (size_t i = 0; i < count; i++, destination += 12)
+			{
+				const std::array<float, 9>& m = matrices[i].elements;
+				for (int r = 0; r < 3; ++r) {
+					for (int c = 0; c < 3; ++c)
+						destination[columnMajor ? c * 4 + r : r * 4 + c] = m[r * 3 + c];
+					destination[r * 4 + 3] = 0.f;
+				}
+			}
+#else
+			if (((uintptr_t)destination & 15) == 0) {
+				PackMatrices3x3Rows<true>(matrices, destination, count, columnMajor);
+				_mm_sfence();
+			}
+			else
+				PackMatrices3x3Rows<false>(matrices, destination, count, columnMajor);
+#endif
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdlib>
+#include <iostream>
+
+// Branch and code layout hints for the hot paths. C++17 has no [[likely]] : the builtins give GCC and Clang the same
+// block layout, MSVC keeps the blocks in the written order, which already puts the error branch out of the way.
+// Error paths call the cold functions below, so their stream code leaves the hot functions' cache lines.
+#if defined(__GNUC__) || defined(__clang__)
+#define BABOON_LIKELY(x) __builtin_expect(!!(x), 1)
+#define BABOON_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#define BABOON_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define BABOON_LIKELY(x) (x)
+#define BABOON_UNLIKELY(x) (x)
+#define BABOON_COLD __declspec(noinline)
+#else
+#define BABOON_LIKELY(x) (x)
+#define BABOON_UNLIKELY(x) (x)
+#define BABOON_COLD
+#endif
+
+namespace Baboon
+{
+	// prints the message and ends the program, for the size mismatches nothing can recover from
+	[[noreturn]] BABOON_COLD inline void Fail(const char* message)
+	{
+		std::cout << message << std::endl;
+		exit(1);
+	}
+
+	// prints the message, the caller then returns without doing anything
+	BABOON_COLD inline void Warn(const char* message)
+	{
+		std::cout << message << std::endl;
+	}
+}
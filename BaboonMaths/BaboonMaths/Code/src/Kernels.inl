@@ -0,0 +1,111 @@
+// Body of the KernelsScalar.cpp, KernelsSSE.cpp, KernelsAVX2.cpp and KernelsAVX512.cpp translation units : each
+// defines the BABOON_LANES_ instruction set it is built for, then includes this file to build its KernelTable.
+// MSVC gets the instruction set from the file's /arch in the project, GCC and Clang from the pragmas below, which
+// come after the standard headers so nothing but the kernels is built for it.
+// Everything defined here has internal linkage (or lives in the Lanes namespace of its instruction set) : an AVX
+// copy of an inline function must never be the one the linker keeps for the rest of the library, so the kernels
+// write Vector3, Quaternion and Fixed16 outputs through their members (Code/tests/CheckKernelSymbols.sh checks it).
+// The kernel headers open the namespace of their instruction set, so profilers and debuggers tell the builds apart :
+// Baboon::Avx2::(anonymous namespace)::BatchInverse is the kernel the AVX2 table runs.
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include <climits>
+
+#if defined(BABOON_LANES_AVX512)
+#define BABOON_KERNEL_TABLE Avx512Kernels
+#define BABOON_KERNEL_LEVEL SimdLevel::AVX512
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f,avx512cd,avx512bw,avx512dq,avx512vl,avx2,fma,f16c,bmi,bmi2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC target("avx512f,avx512cd,avx512bw,avx512dq,avx512vl,avx2,fma,f16c,bmi,bmi2")
+// avx512fintrin.h starts masked intrinsics from a self-initialised __Y vector, which GCC 12 reports once inlined
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#elif defined(BABOON_LANES_AVX2)
+#define BABOON_KERNEL_TABLE Avx2Kernels
+#define BABOON_KERNEL_LEVEL SimdLevel::AVX2
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma,f16c,bmi,bmi2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC target("avx2,fma,f16c,bmi,bmi2")
+#endif
+#elif defined(BABOON_LANES_SSE)
+#define BABOON_KERNEL_TABLE SseKernels
+#define BABOON_KERNEL_LEVEL SimdLevel::SSE
+#elif defined(BABOON_LANES_SCALAR)
+#define BABOON_KERNEL_TABLE ScalarKernels
+#define BABOON_KERNEL_LEVEL SimdLevel::Scalar
+#else
+#error "define the BABOON_LANES_ instruction set before including Kernels.inl"
+#endif
+
+#include "Lanes.h"
+#include "Matrix2x2Kernels.h"
+#include "Matrix4x4Kernels.h"
+#include "Matrix3x3BatchKernels.h"
+#include "LinearSolveKernels.h"
+#include "Decomposition3x3Kernels.h"
+#include "MatrixXKernels.h"
+#include "CompressionKernels.h"
+#include "SkinningKernels.h"
+#include "ParticlesKernels.h"
+#include "FixedPointKernels.h"
+#include "GpuUploadKernels.h"
+
+namespace Baboon
+{
+	using namespace BABOON_LANES_NAMESPACE;
+
+	extern const KernelTable BABOON_KERNEL_TABLE = {
+		BABOON_KERNEL_LEVEL,
+		&Multiply4x4,
+		&Transform4x4,
+		&TransformPoints,
+		&ProjectToScreen,
+		&Determinant4x4,
+		&Determinants3x3,
+		&Determinants4x4,
+		&Inverses2x2,
+		&Inverses3x3,
+		&SolveSystems3x3<SmallSolver::LU>,
+		&SolveSystems4x4<SmallSolver::LU>,
+		&SolveSystems3x3<SmallSolver::Cholesky>,
+		&SolveSystems4x4<SmallSolver::Cholesky>,
+		&EigenSymmetric<float>,
+		&Svd<float>,
+		&Polar<float>,
+		&BatchInverse,
+		&BatchDeterminant,
+		&BatchMultiply,
+		&BatchSymmetricEigen,
+		&BatchSVD,
+		&BatchPolarDecomposition,
+		&GemmMicroKernel,
+		&FloatsToHalves,
+		&HalvesToFloats,
+		&PackQuaternions<10, PackedQuaternion32>,
+		&UnpackQuaternions<10, PackedQuaternion32>,
+		&PackQuaternions<15, PackedQuaternion48>,
+		&UnpackQuaternions<15, PackedQuaternion48>,
+		&QuantizeVectors,
+		&DequantizeVectors,
+		&LinearBlendRange,
+		&DualQuaternionBlendRange,
+		&IntegrateParticles<Integrator::ExplicitEuler>,
+		&IntegrateParticles<Integrator::SemiImplicitEuler>,
+		&IntegrateParticles<Integrator::Verlet>,
+		&TransformFixedVectors,
+		&FloatsToFixed16,
+		&Fixed16ToFloats,
+		&PackMatrices4x4,
+		&PackMatrices3x3,
+	};
+}
+
+#if defined(__clang__) && (defined(BABOON_LANES_AVX512) || defined(BABOON_LANES_AVX2))
+#pragma clang attribute pop
+#elif defined(__GNUC__) && defined(BABOON_LANES_AVX512)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,5 @@
+// AVX-512 build of the kernels, compiled with /arch:AVX512 (see the project file)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BABOON_LANES_AVX512
+#include "Kernels.inl"
+#endif
@@ -0,0 +1,5 @@
+// SSE2 build of the kernels, the baseline of every x64 CPU
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BABOON_LANES_SSE
+#include "Kernels.inl"
+#endif
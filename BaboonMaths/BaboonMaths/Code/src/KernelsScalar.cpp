@@ -0,0 +1,3 @@
+// Plain float build of the kernels, for every target and for Cpu::Force(SimdLevel::Scalar)
+#define BABOON_LANES_SCALAR
+#include "Kernels.inl"
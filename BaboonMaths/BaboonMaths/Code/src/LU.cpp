@@ -0,0 +1,170 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Hints.h"
+#include "Profile.h"
+#include <algorithm>
+#include <cfloat>
+
+namespace Baboon
+{
+	namespace
+	{
+		// pivots smaller than this fraction of the matrix's largest element are treated as zero
+		float SingularTolerance(const float* a, int count, int n)
+		{
+			float scale = 0.f;
+			for (int i = 0; i < count; ++i)
+				scale = std::max(scale, fabsf(a[i]));
+			return n * FLT_EPSILON * scale;
+		}
+
+		// applies the permutation and both triangular solves to a n x nrhs row-major block
+		void SolveInPlace(const MatrixX& lu, const std::vector<int>& pivots, const float* b, float* x, int nrhs)
+		{
+			int n = lu.rows;
+			for (int i = 0; i < n; ++i)
+				std::copy(b + (size_t)pivots[i] * nrhs, b + (size_t)(pivots[i] + 1) * nrhs, x + (size_t)i * nrhs);
+
+			for (int i = 0; i < n; ++i) {
+				float* xi = x + (size_t)i * nrhs;
+				for (int k = 0; k < i; ++k) {
+					float l = lu.At(i, k);
+					const float* xk = x + (size_t)k * nrhs;
+					for (int j = 0; j < nrhs; ++j)
+						xi[j] -= l * xk[j];
+				}
+			}
+
+			for (int i = n - 1; i >= 0; --i) {
+				float* xi = x + (size_t)i * nrhs;
+				for (int k = i + 1; k < n; ++k) {
+					float u = lu.At(i, k);
+					const float* xk = x + (size_t)k * nrhs;
+					for (int j = 0; j < nrhs; ++j)
+						xi[j] -= u * xk[j];
+				}
+				float invPivot = 1.f / lu.At(i, i);
+				for (int j = 0; j < nrhs; ++j)
+					xi[j] *= invPivot;
+			}
+		}
+	}
+
+	LU::LU(const MatrixX& m) : lu(m), pivots(m.rows), pivotSign(1), singular(false)
+	{
+		BABOON_ZONE("LU::LU");
+		if (BABOON_UNLIKELY(m.rows != m.cols))
+			Fail("Cannot compute the LU factorization of a non-square matrix");
+
+		int n = lu.rows;
+		float tolerance = SingularTolerance(lu.elements.data(), (int)lu.elements.size(), n);
+		for (int i = 0; i < n; ++i)
+			pivots[i] = i;
+
+		for (int k = 0; k < n; ++k) {
+			int p = k;
+			for (int i = k + 1; i < n; ++i) {
+				if (fabsf(lu.At(i, k)) > fabsf(lu.At(p, k)))
+					p = i;
+			}
+
+			if (p != k) {
+				for (int j = 0; j < n; ++j)
+					std::swap(lu.At(k, j), lu.At(p, j));
+				std::swap(pivots[k], pivots[p]);
+				pivotSign = -pivotSign;
+			}
+
+			float pivot = lu.At(k, k);
+			if (fabsf(pivot) <= tolerance) {
+				singular = true;
+				continue;
+			}
+
+			float invPivot = 1.f / pivot;
+			for (int i = k + 1; i < n; ++i) {
+				float l = lu.At(i, k) * invPivot;
+				lu.At(i, k) = l;
+				for (int j = k + 1; j < n; ++j)
+					lu.At(i, j) -= l * lu.At(k, j);
+			}
+		}
+	}
+
+	LU::LU(const Matrix2x2& m) : LU(MatrixX(m)) {}
+
+	LU::LU(const Matrix3x3& m) : LU(MatrixX(m)) {}
+
+	LU::LU(const Matrix4x4& m) : LU(MatrixX(m)) {}
+
+	bool LU::IsSingular() const
+	{
+		return singular;
+	}
+
+	float LU::Determinant() const
+	{
+		BABOON_PROFILE_SCOPE("LU::Determinant");
+		float det = (float)pivotSign;
+		for (int i = 0; i < lu.rows; ++i)
+			det *= lu.At(i, i);
+		return det;
+	}
+
+	MatrixX LU::Inverse() const
+	{
+		BABOON_ZONE("LU::Inverse");
+		return Solve(MatrixX(lu.rows, lu.rows, true));
+	}
+
+	MatrixX LU::Solve(const MatrixX& b) const
+	{
+		BABOON_ZONE("LU::Solve");
+		if (BABOON_UNLIKELY(b.rows != lu.rows))
+			Fail("Cannot solve a system with a right-hand side of a different size");
+
+		MatrixX x(b.rows, b.cols);
+		if (singular)
+			return x;
+
+		SolveInPlace(lu, pivots, b.elements.data(), x.elements.data(), b.cols);
+		return x;
+	}
+
+	Vector2 LU::Solve(const Vector2& b) const
+	{
+		BABOON_ZONE("LU::Solve");
+		MatrixX x = Solve(MatrixX(2, 1, { b.x, b.y }));
+		return Vector2(x.elements[0], x.elements[1]);
+	}
+
+	Vector3 LU::Solve(const Vector3& b) const
+	{
+		BABOON_ZONE("LU::Solve");
+		MatrixX x = Solve(MatrixX(3, 1, { b.x, b.y, b.z }));
+		return Vector3(x.elements[0], x.elements[1], x.elements[2]);
+	}
+
+	Vector4 LU::Solve(const Vector4& b) const
+	{
+		BABOON_ZONE("LU::Solve");
+		MatrixX x = Solve(MatrixX(4, 1, { b.x, b.y, b.z, b.w }));
+		return Vector4(x.elements[0], x.elements[1], x.elements[2], x.elements[3]);
+	}
+
+	int LU::SolveBatch(const Matrix3x3* m, const Vector3* b, Vector3* x, int count)
+	{
+		BABOON_ZONE("LU::SolveBatch");
+		if (count <= 0)
+			return 0;
+		return (int)Kernels().solveLU3x3(m, b, x, (size_t)count);
+	}
+
+	int LU::SolveBatch(const Matrix4x4* m, const Vector4* b, Vector4* x, int count)
+	{
+		BABOON_ZONE("LU::SolveBatch");
+		if (count <= 0)
+			return 0;
+		return (int)Kernels().solveLU4x4(m, b, x, (size_t)count);
+	}
+}
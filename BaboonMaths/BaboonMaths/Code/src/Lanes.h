@@ -0,0 +1,302 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+// The kernel translation units (see Kernels.inl) choose their instruction set with one of BABOON_LANES_SCALAR,
+// BABOON_LANES_SSE, BABOON_LANES_AVX2 or BABOON_LANES_AVX512, any other file gets what its compiler flags allow
+#if !defined(BABOON_LANES_SCALAR) && !defined(BABOON_LANES_SSE) && !defined(BABOON_LANES_AVX2) && !defined(BABOON_LANES_AVX512)
+#if defined(__AVX512F__)
+#define BABOON_LANES_AVX512
+#elif defined(__AVX2__)
+#define BABOON_LANES_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BABOON_LANES_SSE
+#else
+#define BABOON_LANES_SCALAR
+#endif
+#endif
+
+#if defined(BABOON_LANES_AVX512)
+#define BABOON_LANES_NAMESPACE Avx512
+#elif defined(BABOON_LANES_AVX2)
+#define BABOON_LANES_NAMESPACE Avx2
+#elif defined(BABOON_LANES_SSE)
+#define BABOON_LANES_NAMESPACE Sse
+#else
+#define BABOON_LANES_NAMESPACE Scalar
+#endif
+
+#if !defined(BABOON_LANES_SCALAR)
+#include <immintrin.h>
+#endif
+
+namespace Baboon
+{
+	// Thin wrapper over a float register, so batch kernels are written once and built for each instruction set.
+	// Batches keep their lane arrays padded to BatchAlignment floats, which every Width divides.
+	// Every operation also exists for plain floats, so templated kernels serve single matrices as well.
+	namespace Lanes
+	{
+		// one namespace per instruction set : an inline function built with AVX must never be picked by the
+		// linker for a caller built without it
+		inline namespace BABOON_LANES_NAMESPACE
+		{
+			constexpr int BatchAlignment = 16;
+
+			inline int PaddedCount(int count)
+			{
+				return (count + BatchAlignment - 1) / BatchAlignment * BatchAlignment;
+			}
+
+			template <class P>
+			constexpr int LaneCount() { return (int)(sizeof(P) / sizeof(float)); }
+
+			template <class P> P Broadcast(float f);
+			template <> inline float Broadcast<float>(float f) { return f; }
+			template <class P> P LoadAs(const float* p); // Load for a lane type chosen by the caller
+			template <> inline float LoadAs<float>(const float* p) { return *p; }
+			inline void Store(float* p, float a) { *p = a; }
+			template <class P> P GatherAs(const float* base, const int* offsets); // lane j reads base[offsets[j]]
+			template <> inline float GatherAs<float>(const float* base, const int* offsets) { return base[offsets[0]]; }
+
+			inline float MultiplyAdd(float a, float b, float c) { return a * b + c; }
+			// the float Sqrt is the one of the kernel namespace below
+			inline float Abs(float a) { return fabsf(a); }
+			inline float Min(float a, float b) { return a < b ? a : b; }
+			inline float Max(float a, float b) { return a > b ? a : b; }
+
+			inline bool Equal(float a, float b) { return a == b; }
+			inline bool Less(float a, float b) { return a < b; }
+			inline float Select(bool m, float ifTrue, float ifFalse) { return m ? ifTrue : ifFalse; }
+			inline bool Or(bool a, bool b) { return a || b; }
+			inline bool Any(bool m) { return m; }
+
+#if defined(BABOON_LANES_AVX512)
+			constexpr int Width = 16;
+
+			struct Pack { __m512 v; };
+			struct Mask { __mmask16 v; };
+
+			inline Pack Load(const float* p) { return { _mm512_loadu_ps(p) }; }
+			inline void Store(float* p, Pack a) { _mm512_storeu_ps(p, a.v); }
+			template <> inline Pack Broadcast<Pack>(float f) { return { _mm512_set1_ps(f) }; }
+			template <> inline Pack LoadAs<Pack>(const float* p) { return Load(p); }
+			template <> inline Pack GatherAs<Pack>(const float* base, const int* offsets)
+			{
+				return { _mm512_i32gather_ps(_mm512_loadu_si512(offsets), base, 4) };
+			}
+
+			inline Pack operator+(Pack a, Pack b) { return { _mm512_add_ps(a.v, b.v) }; }
+			inline Pack operator-(Pack a, Pack b) { return { _mm512_sub_ps(a.v, b.v) }; }
+			inline Pack operator*(Pack a, Pack b) { return { _mm512_mul_ps(a.v, b.v) }; }
+			inline Pack operator/(Pack a, Pack b) { return { _mm512_div_ps(a.v, b.v) }; }
+			// the float xor needs AVX-512 DQ, the integer one is in the foundation
+			inline Pack operator-(Pack a) { return { _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(INT32_MIN))) }; }
+
+			inline Pack MultiplyAdd(Pack a, Pack b, Pack c) { return { _mm512_fmadd_ps(a.v, b.v, c.v) }; }
+			inline Pack Sqrt(Pack a) { return { _mm512_sqrt_ps(a.v) }; }
+			inline Pack Abs(Pack a) { return { _mm512_abs_ps(a.v) }; }
+			inline Pack Min(Pack a, Pack b) { return { _mm512_min_ps(a.v, b.v) }; }
+			inline Pack Max(Pack a, Pack b) { return { _mm512_max_ps(a.v, b.v) }; }
+
+			inline Mask Equal(Pack a, Pack b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ) }; }
+			inline Mask Less(Pack a, Pack b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ) }; }
+			inline Pack Select(Mask m, Pack ifTrue, Pack ifFalse) { return { _mm512_mask_blend_ps(m.v, ifFalse.v, ifTrue.v) }; }
+			inline Mask Or(Mask a, Mask b) { return { (__mmask16)(a.v | b.v) }; }
+			inline bool Any(Mask m) { return m.v != 0; }
+
+			// lane j of c0..c3 gets the 4 floats at p + j * stride : a 4x4 transpose in each 128 bits
+			inline void LoadTransposed4(const float* p, size_t stride, Pack& c0, Pack& c1, Pack& c2, Pack& c3)
+			{
+				auto rows = [&](size_t j) {
+					__m512 a = _mm512_castps128_ps512(_mm_loadu_ps(p + j * stride));
+					a = _mm512_insertf32x4(a, _mm_loadu_ps(p + (j + 4) * stride), 1);
+					a = _mm512_insertf32x4(a, _mm_loadu_ps(p + (j + 8) * stride), 2);
+					return _mm512_insertf32x4(a, _mm_loadu_ps(p + (j + 12) * stride), 3);
+				};
+				__m512 a0 = rows(0), a1 = rows(1), a2 = rows(2), a3 = rows(3);
+				__m512 t0 = _mm512_unpacklo_ps(a0, a1), t1 = _mm512_unpackhi_ps(a0, a1);
+				__m512 t2 = _mm512_unpacklo_ps(a2, a3), t3 = _mm512_unpackhi_ps(a2, a3);
+				c0 = { _mm512_shuffle_ps(t0, t2, 0x44) };
+				c1 = { _mm512_shuffle_ps(t0, t2, 0xee) };
+				c2 = { _mm512_shuffle_ps(t1, t3, 0x44) };
+				c3 = { _mm512_shuffle_ps(t1, t3, 0xee) };
+			}
+
+			// the reverse : lane j of c0..c3 goes to the 4 floats at p + j * stride, lanes stored in order
+			inline void StoreTransposed4(float* p, size_t stride, Pack c0, Pack c1, Pack c2, Pack c3)
+			{
+				__m512 t0 = _mm512_unpacklo_ps(c0.v, c1.v), t1 = _mm512_unpackhi_ps(c0.v, c1.v);
+				__m512 t2 = _mm512_unpacklo_ps(c2.v, c3.v), t3 = _mm512_unpackhi_ps(c2.v, c3.v);
+				__m512 r0 = _mm512_shuffle_ps(t0, t2, 0x44), r1 = _mm512_shuffle_ps(t0, t2, 0xee);
+				__m512 r2 = _mm512_shuffle_ps(t1, t3, 0x44), r3 = _mm512_shuffle_ps(t1, t3, 0xee);
+				auto rows = [&](size_t j, __m128 a0, __m128 a1, __m128 a2, __m128 a3) {
+					_mm_storeu_ps(p + j * stride, a0);
+					_mm_storeu_ps(p + (j + 1) * stride, a1);
+					_mm_storeu_ps(p + (j + 2) * stride, a2);
+					_mm_storeu_ps(p + (j + 3) * stride, a3);
+				};
+				rows(0, _mm512_castps512_ps128(r0), _mm512_castps512_ps128(r1), _mm512_castps512_ps128(r2), _mm512_castps512_ps128(r3));
+				rows(4, _mm512_extractf32x4_ps(r0, 1), _mm512_extractf32x4_ps(r1, 1), _mm512_extractf32x4_ps(r2, 1), _mm512_extractf32x4_ps(r3, 1));
+				rows(8, _mm512_extractf32x4_ps(r0, 2), _mm512_extractf32x4_ps(r1, 2), _mm512_extractf32x4_ps(r2, 2), _mm512_extractf32x4_ps(r3, 2));
+				rows(12, _mm512_extractf32x4_ps(r0, 3), _mm512_extractf32x4_ps(r1, 3), _mm512_extractf32x4_ps(r2, 3), _mm512_extractf32x4_ps(r3, 3));
+			}
+#elif defined(BABOON_LANES_AVX2)
+			constexpr int Width = 8;
+
+			struct Pack { __m256 v; };
+			struct Mask { __m256 v; };
+
+			inline Pack Load(const float* p) { return { _mm256_loadu_ps(p) }; }
+			inline void Store(float* p, Pack a) { _mm256_storeu_ps(p, a.v); }
+			template <> inline Pack Broadcast<Pack>(float f) { return { _mm256_set1_ps(f) }; }
+			template <> inline Pack LoadAs<Pack>(const float* p) { return Load(p); }
+			template <> inline Pack GatherAs<Pack>(const float* base, const int* offsets)
+			{
+				return { _mm256_i32gather_ps(base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets)), 4) };
+			}
+
+			inline Pack operator+(Pack a, Pack b) { return { _mm256_add_ps(a.v, b.v) }; }
+			inline Pack operator-(Pack a, Pack b) { return { _mm256_sub_ps(a.v, b.v) }; }
+			inline Pack operator*(Pack a, Pack b) { return { _mm256_mul_ps(a.v, b.v) }; }
+			inline Pack operator/(Pack a, Pack b) { return { _mm256_div_ps(a.v, b.v) }; }
+			inline Pack operator-(Pack a) { return { _mm256_xor_ps(a.v, _mm256_set1_ps(-0.f)) }; }
+
+			inline Pack MultiplyAdd(Pack a, Pack b, Pack c) { return { _mm256_fmadd_ps(a.v, b.v, c.v) }; }
+			inline Pack Sqrt(Pack a) { return { _mm256_sqrt_ps(a.v) }; }
+			inline Pack Abs(Pack a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.f), a.v) }; }
+			inline Pack Min(Pack a, Pack b) { return { _mm256_min_ps(a.v, b.v) }; }
+			inline Pack Max(Pack a, Pack b) { return { _mm256_max_ps(a.v, b.v) }; }
+
+			inline Mask Equal(Pack a, Pack b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ) }; }
+			inline Mask Less(Pack a, Pack b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+			inline Pack Select(Mask m, Pack ifTrue, Pack ifFalse) { return { _mm256_blendv_ps(ifFalse.v, ifTrue.v, m.v) }; }
+			inline Mask Or(Mask a, Mask b) { return { _mm256_or_ps(a.v, b.v) }; }
+			inline bool Any(Mask m) { return _mm256_movemask_ps(m.v) != 0; }
+
+			inline void LoadTransposed4(const float* p, size_t stride, Pack& c0, Pack& c1, Pack& c2, Pack& c3)
+			{
+				auto rows = [&](size_t j) {
+					return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + j * stride)), _mm_loadu_ps(p + (j + 4) * stride), 1);
+				};
+				__m256 a0 = rows(0), a1 = rows(1), a2 = rows(2), a3 = rows(3);
+				__m256 t0 = _mm256_unpacklo_ps(a0, a1), t1 = _mm256_unpackhi_ps(a0, a1);
+				__m256 t2 = _mm256_unpacklo_ps(a2, a3), t3 = _mm256_unpackhi_ps(a2, a3);
+				c0 = { _mm256_shuffle_ps(t0, t2, 0x44) };
+				c1 = { _mm256_shuffle_ps(t0, t2, 0xee) };
+				c2 = { _mm256_shuffle_ps(t1, t3, 0x44) };
+				c3 = { _mm256_shuffle_ps(t1, t3, 0xee) };
+			}
+
+			inline void StoreTransposed4(float* p, size_t stride, Pack c0, Pack c1, Pack c2, Pack c3)
+			{
+				__m256 t0 = _mm256_unpacklo_ps(c0.v, c1.v), t1 = _mm256_unpackhi_ps(c0.v, c1.v);
+				__m256 t2 = _mm256_unpacklo_ps(c2.v, c3.v), t3 = _mm256_unpackhi_ps(c2.v, c3.v);
+				__m256 r0 = _mm256_shuffle_ps(t0, t2, 0x44), r1 = _mm256_shuffle_ps(t0, t2, 0xee);
+				__m256 r2 = _mm256_shuffle_ps(t1, t3, 0x44), r3 = _mm256_shuffle_ps(t1, t3, 0xee);
+				_mm_storeu_ps(p, _mm256_castps256_ps128(r0));
+				_mm_storeu_ps(p + stride, _mm256_castps256_ps128(r1));
+				_mm_storeu_ps(p + 2 * stride, _mm256_castps256_ps128(r2));
+				_mm_storeu_ps(p + 3 * stride, _mm256_castps256_ps128(r3));
+				_mm_storeu_ps(p + 4 * stride, _mm256_extractf128_ps(r0, 1));
+				_mm_storeu_ps(p + 5 * stride, _mm256_extractf128_ps(r1, 1));
+				_mm_storeu_ps(p + 6 * stride, _mm256_extractf128_ps(r2, 1));
+				_mm_storeu_ps(p + 7 * stride, _mm256_extractf128_ps(r3, 1));
+			}
+#elif defined(BABOON_LANES_SSE)
+			constexpr int Width = 4;
+
+			struct Pack { __m128 v; };
+			struct Mask { __m128 v; };
+
+			inline Pack Load(const float* p) { return { _mm_loadu_ps(p) }; }
+			inline void Store(float* p, Pack a) { _mm_storeu_ps(p, a.v); }
+			template <> inline Pack Broadcast<Pack>(float f) { return { _mm_set1_ps(f) }; }
+			template <> inline Pack LoadAs<Pack>(const float* p) { return Load(p); }
+			template <> inline Pack GatherAs<Pack>(const float* base, const int* offsets)
+			{
+				return { _mm_set_ps(base[offsets[3]], base[offsets[2]], base[offsets[1]], base[offsets[0]]) };
+			}
+
+			inline Pack operator+(Pack a, Pack b) { return { _mm_add_ps(a.v, b.v) }; }
+			inline Pack operator-(Pack a, Pack b) { return { _mm_sub_ps(a.v, b.v) }; }
+			inline Pack operator*(Pack a, Pack b) { return { _mm_mul_ps(a.v, b.v) }; }
+			inline Pack operator/(Pack a, Pack b) { return { _mm_div_ps(a.v, b.v) }; }
+			inline Pack operator-(Pack a) { return { _mm_xor_ps(a.v, _mm_set1_ps(-0.f)) }; }
+
+			inline Pack MultiplyAdd(Pack a, Pack b, Pack c) { return { _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v) }; }
+			inline Pack Sqrt(Pack a) { return { _mm_sqrt_ps(a.v) }; }
+			inline Pack Abs(Pack a) { return { _mm_andnot_ps(_mm_set1_ps(-0.f), a.v) }; }
+			inline Pack Min(Pack a, Pack b) { return { _mm_min_ps(a.v, b.v) }; }
+			inline Pack Max(Pack a, Pack b) { return { _mm_max_ps(a.v, b.v) }; }
+
+			inline Mask Equal(Pack a, Pack b) { return { _mm_cmpeq_ps(a.v, b.v) }; }
+			inline Mask Less(Pack a, Pack b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+			// SSE2 has no blend, masks being all ones or all zeros per lane they select bitwise
+			inline Pack Select(Mask m, Pack ifTrue, Pack ifFalse) { return { _mm_or_ps(_mm_and_ps(m.v, ifTrue.v), _mm_andnot_ps(m.v, ifFalse.v)) }; }
+			inline Mask Or(Mask a, Mask b) { return { _mm_or_ps(a.v, b.v) }; }
+			inline bool Any(Mask m) { return _mm_movemask_ps(m.v) != 0; }
+
+			inline void LoadTransposed4(const float* p, size_t stride, Pack& c0, Pack& c1, Pack& c2, Pack& c3)
+			{
+				__m128 a0 = _mm_loadu_ps(p), a1 = _mm_loadu_ps(p + stride), a2 = _mm_loadu_ps(p + 2 * stride), a3 = _mm_loadu_ps(p + 3 * stride);
+				_MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+				c0 = { a0 };
+				c1 = { a1 };
+				c2 = { a2 };
+				c3 = { a3 };
+			}
+
+			inline void StoreTransposed4(float* p, size_t stride, Pack c0, Pack c1, Pack c2, Pack c3)
+			{
+				_MM_TRANSPOSE4_PS(c0.v, c1.v, c2.v, c3.v);
+				_mm_storeu_ps(p, c0.v);
+				_mm_storeu_ps(p + stride, c1.v);
+				_mm_storeu_ps(p + 2 * stride, c2.v);
+				_mm_storeu_ps(p + 3 * stride, c3.v);
+			}
+#else
+			constexpr int Width = 1;
+
+			using Pack = float;
+			using Mask = bool;
+
+			inline Pack Load(const float* p) { return *p; }
+
+			inline void LoadTransposed4(const float* p, size_t, Pack& c0, Pack& c1, Pack& c2, Pack& c3)
+			{
+				c0 = p[0];
+				c1 = p[1];
+				c2 = p[2];
+				c3 = p[3];
+			}
+
+			inline void StoreTransposed4(float* p, size_t, Pack c0, Pack c1, Pack c2, Pack c3)
+			{
+				p[0] = c0;
+				p[1] = c1;
+				p[2] = c2;
+				p[3] = c3;
+			}
+#endif
+
+			// runs kernel on blocks of Width items as Pack, then on the remaining ones as plain floats
+			template <class Kernel>
+			void ForEachBlock(size_t count, Kernel kernel)
+			{
+				size_t i = 0;
+				for (; i + Width <= count; i += Width)
+					kernel(i, Pack());
+				for (; i < count; i++)
+					kernel(i, 0.f);
+			}
+		}
+	}
+
+	// Baboon::Sqrt(float) is an inline function of the whole library, the kernels of an instruction set take this
+	// one, found before it, while the Pack overloads come from the Lanes namespace by argument dependent lookup
+	namespace BABOON_LANES_NAMESPACE
+	{
+		inline float Sqrt(float a) { return sqrtf(a); }
+	}
+}
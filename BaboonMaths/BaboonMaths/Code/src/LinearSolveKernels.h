@@ -0,0 +1,188 @@
+#pragma once
+#include "Lanes.h"
+#include <cfloat>
+
+namespace Baboon::BABOON_LANES_NAMESPACE
+{
+	namespace
+	{
+		using namespace Lanes;
+
+		enum class SmallSolver { LU, Cholesky };
+
+		// solves the lanes' N x N systems a * x = b by LU with partial pivoting, x left in b. Rows are swapped with
+		// Select so each lane follows its own pivots, and a lane is singular when one of its pivots is within
+		// N * FLT_EPSILON of the matrix's largest element, LU's tolerance. Returns the regular lanes.
+		template <int N, class P>
+		auto SolveLULanes(P* a, P* b)
+		{
+			P scale = Abs(a[0]);
+			for (int e = 1; e < N * N; e++)
+				scale = Max(scale, Abs(a[e]));
+			P tolerance = scale * Broadcast<P>(N * FLT_EPSILON);
+			P margin = Broadcast<P>(FLT_MAX);
+
+			for (int k = 0; k < N; ++k) {
+				for (int i = k + 1; i < N; ++i) {
+					auto larger = Less(Abs(a[k * N + k]), Abs(a[i * N + k]));
+					for (int j = k; j < N; ++j) {
+						P top = a[k * N + j];
+						a[k * N + j] = Select(larger, a[i * N + j], top);
+						a[i * N + j] = Select(larger, top, a[i * N + j]);
+					}
+					P top = b[k];
+					b[k] = Select(larger, b[i], top);
+					b[i] = Select(larger, top, b[i]);
+				}
+
+				// singular lanes go on with whatever they divide by, their x is discarded
+				margin = Min(margin, Abs(a[k * N + k]) - tolerance);
+				P invPivot = Broadcast<P>(1.f) / a[k * N + k];
+				for (int i = k + 1; i < N; ++i) {
+					P l = a[i * N + k] * invPivot;
+					for (int j = k + 1; j < N; ++j)
+						a[i * N + j] = a[i * N + j] - l * a[k * N + j];
+					b[i] = b[i] - l * b[k];
+				}
+			}
+
+			for (int i = N - 1; i >= 0; --i) {
+				P sum = b[i];
+				for (int j = i + 1; j < N; ++j)
+					sum = sum - a[i * N + j] * b[j];
+				b[i] = sum / a[i * N + i];
+			}
+			return Less(Broadcast<P>(0.f), margin);
+		}
+
+		// solves the lanes' symmetric positive definite N x N systems a * x = b, x left in b, by factoring a into
+		// L * transpose(L) then solving both triangles. Returns the lanes whose diagonal stayed positive.
+		template <int N, class P>
+		auto SolveCholeskyLanes(const P* a, P* b)
+		{
+			P l[N * N];
+			P margin = Broadcast<P>(FLT_MAX);
+			for (int j = 0; j < N; ++j) {
+				P diagonal = a[j * N + j];
+				for (int k = 0; k < j; ++k)
+					diagonal = diagonal - l[j * N + k] * l[j * N + k];
+
+				// failed lanes take the root of a negative number, their x is discarded
+				margin = Min(margin, diagonal);
+				P ljj = Sqrt(diagonal);
+				P invLjj = Broadcast<P>(1.f) / ljj;
+				l[j * N + j] = ljj;
+				for (int i = j + 1; i < N; ++i) {
+					P sum = a[i * N + j];
+					for (int k = 0; k < j; ++k)
+						sum = sum - l[i * N + k] * l[j * N + k];
+					l[i * N + j] = sum * invLjj;
+				}
+			}
+
+			for (int i = 0; i < N; ++i) {
+				for (int k = 0; k < i; ++k)
+					b[i] = b[i] - l[i * N + k] * b[k];
+				b[i] = b[i] / l[i * N + i];
+			}
+			for (int i = N - 1; i >= 0; --i) {
+				for (int k = i + 1; k < N; ++k)
+					b[i] = b[i] - l[k * N + i] * b[k];
+				b[i] = b[i] / l[i * N + i];
+			}
+			return Less(Broadcast<P>(0.f), margin);
+		}
+
+		template <SmallSolver Solver, int N, class P>
+		auto SolveLanes(P* a, P* b)
+		{
+			if constexpr (Solver == SmallSolver::LU)
+				return SolveLULanes<N>(a, b);
+			else
+				return SolveCholeskyLanes<N>(a, b);
+		}
+
+		// one system per lane, failed lanes get x = 0, returns their count. x may be b.
+		template <SmallSolver Solver>
+		size_t SolveSystems3x3(const Matrix3x3* matrices, const Vector3* b, Vector3* x, size_t count)
+		{
+			// Matrix3x3 and Vector3 being packed floats, rows are loaded 4 floats at a time like in Determinants3x3 and
+			// the last system is left to the scalar loop. The store of x puts b's next float back, so x may be b.
+			size_t i = 0, failed = 0;
+#if !defined(BABOON_LANES_SCALAR)
+			Pack failedLanes = Broadcast<Pack>(0.f);
+			for (; i + Width < count; i += Width)
+			{
+				const float* m = matrices[i].elements.data();
+				Pack a[9], v[3], next;
+				LoadTransposed4(m, 9, a[0], a[1], a[2], next);
+				LoadTransposed4(m + 3, 9, a[3], a[4], a[5], next);
+				LoadTransposed4(m + 6, 9, a[6], a[7], a[8], next);
+				LoadTransposed4(&b[i].x, 3, v[0], v[1], v[2], next);
+				Mask regular = SolveLanes<Solver, 3>(a, v);
+				Pack zero = Broadcast<Pack>(0.f);
+				StoreTransposed4(&x[i].x, 3, Select(regular, v[0], zero), Select(regular, v[1], zero), Select(regular, v[2], zero), next);
+				failedLanes = failedLanes + Select(regular, zero, Broadcast<Pack>(1.f));
+			}
+			float lanes[Width];
+			Store(lanes, failedLanes);
+			for (int j = 0; j < Width; j++)
+				failed += (size_t)lanes[j];
+#endif
+			for (; i < count; i++)
+			{
+				std::array<float, 9> a = matrices[i].elements;
+				float v[3] = { b[i].x, b[i].y, b[i].z };
+				if (!SolveLanes<Solver, 3>(a.data(), v)) {
+					v[0] = v[1] = v[2] = 0.f;
+					++failed;
+				}
+				x[i].x = v[0];
+				x[i].y = v[1];
+				x[i].z = v[2];
+			}
+			return failed;
+		}
+
+		template <SmallSolver Solver>
+		size_t SolveSystems4x4(const Matrix4x4* matrices, const Vector4* b, Vector4* x, size_t count)
+		{
+			size_t i = 0, failed = 0;
+#if !defined(BABOON_LANES_SCALAR)
+			Pack failedLanes = Broadcast<Pack>(0.f);
+			for (; i + Width <= count; i += Width)
+			{
+				const float* m = matrices[i].elements.data();
+				Pack a[16], v[4];
+				LoadTransposed4(m, 16, a[0], a[1], a[2], a[3]);
+				LoadTransposed4(m + 4, 16, a[4], a[5], a[6], a[7]);
+				LoadTransposed4(m + 8, 16, a[8], a[9], a[10], a[11]);
+				LoadTransposed4(m + 12, 16, a[12], a[13], a[14], a[15]);
+				LoadTransposed4(&b[i].x, 4, v[0], v[1], v[2], v[3]);
+				Mask regular = SolveLanes<Solver, 4>(a, v);
+				Pack zero = Broadcast<Pack>(0.f);
+				StoreTransposed4(&x[i].x, 4, Select(regular, v[0], zero), Select(regular, v[1], zero), Select(regular, v[2], zero), Select(regular, v[3], zero));
+				failedLanes = failedLanes + Select(regular, zero, Broadcast<Pack>(1.f));
+			}
+			float lanes[Width];
+			Store(lanes, failedLanes);
+			for (int j = 0; j < Width; j++)
+				failed += (size_t)lanes[j];
+#endif
+			for (; i < count; i++)
+			{
+				std::array<float, 16> a = matrices[i].elements;
+				float v[4] = { b[i].x, b[i].y, b[i].z, b[i].w };
+				if (!SolveLanes<Solver, 4>(a.data(), v)) {
+					v[0] = v[1] = v[2] = v[3] = 0.f;
+					++failed;
+				}
+				x[i].x = v[0];
+				x[i].y = v[1];
+				x[i].z = v[2];
+				x[i].w = v[3];
+			}
+			return failed;
+		}
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "Lanes.h"
+
+namespace Baboon::BABOON_LANES_NAMESPACE
+{
+	namespace
+	{
+		using namespace Lanes;
+
+		// inverts the lanes of a into inv, singular lanes keep their matrix, returns them
+		template <class P>
+		auto Inverse2x2Lanes(const P* a, P* inv)
+		{
+			P det = a[0] * a[3] - a[1] * a[2];
+			auto singular = Equal(det, Broadcast<P>(0.f));
+			P invDet = Broadcast<P>(1.f) / Select(singular, Broadcast<P>(1.f), det);
+			P r0 = Select(singular, a[0], a[3] * invDet);
+			P r1 = Select(singular, a[1], -a[1] * invDet);
+			P r2 = Select(singular, a[2], -a[2] * invDet);
+			P r3 = Select(singular, a[3], a[0] * invDet);
+			// a and inv may be the same array
+			inv[0] = r0; inv[1] = r1; inv[2] = r2; inv[3] = r3;
+			return singular;
+		}
+
+		size_t Inverses2x2(const Matrix2x2* matrices, Matrix2x2* inverses, size_t count)
+		{
+			// Matrix2x2 being 4 packed floats, a block of Width matrices is one transposed load and store
+			size_t i = 0, singular = 0;
+#if !defined(BABOON_LANES_SCALAR)
+			Pack singularLanes = Broadcast<Pack>(0.f);
+			for (; i + Width <= count; i += Width)
+			{
+				Pack a[4], inv[4];
+				LoadTransposed4(matrices[i].elements.data(), 4, a[0], a[1], a[2], a[3]);
+				Mask m = Inverse2x2Lanes(a, inv);
+				StoreTransposed4(inverses[i].elements.data(), 4, inv[0], inv[1], inv[2], inv[3]);
+				singularLanes = singularLanes + Select(m, Broadcast<Pack>(1.f), Broadcast<Pack>(0.f));
+			}
+			float lanes[Width];
+			Store(lanes, singularLanes);
+			for (int j = 0; j < Width; j++)
+				singular += (size_t)lanes[j];
+#endif
+			for (; i < count; i++)
+				singular += Inverse2x2Lanes(matrices[i].elements.data(), inverses[i].elements.data()) ? 1 : 0;
+			return singular;
+		}
+	}
+}
@@ -0,0 +1,110 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Hints.h"
+#include "Lanes.h"
+#include "Profile.h"
+#include <algorithm>
+
+namespace Baboon
+{
+	using namespace Lanes;
+
+	Matrix3x3Batch::Matrix3x3Batch(int _count, std::pmr::memory_resource* resource) : count(0), stride(0), elements(resource)
+	{
+		Resize(_count);
+	}
+
+	Matrix3x3Batch::Matrix3x3Batch(const Matrix3x3* matrices, int _count, std::pmr::memory_resource* resource)
+		: count(0), stride(0), elements(resource)
+	{
+		Resize(_count);
+
+		for (int i = 0; i < _count; i++)
+		{
+			Set(i, matrices[i]);
+		}
+	}
+
+	void Matrix3x3Batch::Resize(int _count)
+	{
+		if (BABOON_UNLIKELY(_count < 0))
+			abort();
+
+		// copies the lanes over since the stride, and so every element's offset, may change
+		int newStride = PaddedCount(_count);
+		std::pmr::vector<float> newElements((size_t)9 * newStride, 0.f, elements.get_allocator());
+		int kept = std::min(count, _count);
+		for (int e = 0; e < 9; e++)
+		{
+			std::copy(elements.begin() + (size_t)e * stride, elements.begin() + (size_t)e * stride + kept,
+				newElements.begin() + (size_t)e * newStride);
+		}
+
+		count = _count;
+		stride = newStride;
+		elements = std::move(newElements);
+	}
+
+	void Matrix3x3Batch::Set(int index, const Matrix3x3& m)
+	{
+		for (int e = 0; e < 9; e++)
+		{
+			elements[(size_t)e * stride + index] = m.elements[e];
+		}
+	}
+
+	Matrix3x3 Matrix3x3Batch::Get(int index) const
+	{
+		Matrix3x3 m;
+		for (int e = 0; e < 9; e++)
+		{
+			m.elements[e] = elements[(size_t)e * stride + index];
+		}
+		return m;
+	}
+
+	float* Matrix3x3Batch::Element(int e)
+	{
+		return elements.data() + (size_t)e * stride;
+	}
+
+	const float* Matrix3x3Batch::Element(int e) const
+	{
+		return elements.data() + (size_t)e * stride;
+	}
+
+	void Matrix3x3Batch::Inverse()
+	{
+		BABOON_ZONE("Matrix3x3Batch::Inverse");
+		Kernels().batchInverse(*this);
+	}
+
+	void Matrix3x3Batch::Transpose()
+	{
+		BABOON_ZONE("Matrix3x3Batch::Transpose");
+		// in element-major storage a transpose is just swapping whole lane arrays
+		for (int i = 0; i < 3; ++i) {
+			for (int j = i + 1; j < 3; ++j) {
+				std::swap_ranges(Element(i * 3 + j), Element(i * 3 + j) + stride, Element(j * 3 + i));
+			}
+		}
+	}
+
+	void Matrix3x3Batch::Determinant(float* determinants) const
+	{
+		BABOON_ZONE("Matrix3x3Batch::Determinant");
+		Kernels().batchDeterminant(*this, determinants);
+	}
+
+	void Matrix3x3Batch::Multiply(const Matrix3x3Batch& mat1, const Matrix3x3Batch& mat2, Matrix3x3Batch& result)
+	{
+		BABOON_ZONE("Matrix3x3Batch::Multiply");
+		if (BABOON_UNLIKELY(mat1.count != mat2.count))
+			Fail("Cannot multiply batches of different sizes");
+
+		if (result.count != mat1.count)
+			result.Resize(mat1.count);
+
+		Kernels().batchMultiply(mat1, mat2, result);
+	}
+}
\ No newline at end of file
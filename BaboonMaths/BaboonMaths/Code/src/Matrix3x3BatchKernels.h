@@ -0,0 +1,178 @@
+#pragma once
+#include "Lanes.h"
+
+namespace Baboon::BABOON_LANES_NAMESPACE
+{
+	namespace
+	{
+		using namespace Lanes;
+
+		// inverts the lanes of a into inv, singular lanes keep their matrix, returns them
+		template <class P>
+		auto Inverse3x3Lanes(const P* a, P* inv)
+		{
+			// cofactors of the first row, reused by the determinant
+			P c0 = a[4] * a[8] - a[5] * a[7];
+			P c3 = a[5] * a[6] - a[3] * a[8];
+			P c6 = a[3] * a[7] - a[4] * a[6];
+			P det = a[0] * c0 + a[1] * c3 + a[2] * c6;
+
+			auto singular = Equal(det, Broadcast<P>(0.f));
+			P invDet = Broadcast<P>(1.f) / Select(singular, Broadcast<P>(1.f), det);
+			P r0 = Select(singular, a[0], c0 * invDet);
+			P r1 = Select(singular, a[1], (a[2] * a[7] - a[1] * a[8]) * invDet);
+			P r2 = Select(singular, a[2], (a[1] * a[5] - a[2] * a[4]) * invDet);
+			P r3 = Select(singular, a[3], c3 * invDet);
+			P r4 = Select(singular, a[4], (a[0] * a[8] - a[2] * a[6]) * invDet);
+			P r5 = Select(singular, a[5], (a[2] * a[3] - a[0] * a[5]) * invDet);
+			P r6 = Select(singular, a[6], c6 * invDet);
+			P r7 = Select(singular, a[7], (a[1] * a[6] - a[0] * a[7]) * invDet);
+			P r8 = Select(singular, a[8], (a[0] * a[4] - a[1] * a[3]) * invDet);
+			// a and inv may be the same array
+			inv[0] = r0; inv[1] = r1; inv[2] = r2;
+			inv[3] = r3; inv[4] = r4; inv[5] = r5;
+			inv[6] = r6; inv[7] = r7; inv[8] = r8;
+			return singular;
+		}
+
+		void BatchInverse(Matrix3x3Batch& batch)
+		{
+			float* m[9];
+			for (int e = 0; e < 9; e++)
+				m[e] = batch.Element(e);
+
+			for (int i = 0; i < batch.stride; i += Width)
+			{
+				Pack a0 = Load(m[0] + i), a1 = Load(m[1] + i), a2 = Load(m[2] + i);
+				Pack a3 = Load(m[3] + i), a4 = Load(m[4] + i), a5 = Load(m[5] + i);
+				Pack a6 = Load(m[6] + i), a7 = Load(m[7] + i), a8 = Load(m[8] + i);
+
+				// cofactors of the first row, reused by the determinant
+				Pack c0 = a4 * a8 - a5 * a7;
+				Pack c3 = a5 * a6 - a3 * a8;
+				Pack c6 = a3 * a7 - a4 * a6;
+				Pack det = a0 * c0 + a1 * c3 + a2 * c6;
+
+				// singular lanes (and the zero padding) keep their matrix, like Matrix3x3::Inverse
+				Mask singular = Equal(det, Broadcast<Pack>(0.f));
+				Pack invDet = Broadcast<Pack>(1.f) / Select(singular, Broadcast<Pack>(1.f), det);
+
+				Store(m[0] + i, Select(singular, a0, c0 * invDet));
+				Store(m[1] + i, Select(singular, a1, (a2 * a7 - a1 * a8) * invDet));
+				Store(m[2] + i, Select(singular, a2, (a1 * a5 - a2 * a4) * invDet));
+				Store(m[3] + i, Select(singular, a3, c3 * invDet));
+				Store(m[4] + i, Select(singular, a4, (a0 * a8 - a2 * a6) * invDet));
+				Store(m[5] + i, Select(singular, a5, (a2 * a3 - a0 * a5) * invDet));
+				Store(m[6] + i, Select(singular, a6, c6 * invDet));
+				Store(m[7] + i, Select(singular, a7, (a1 * a6 - a0 * a7) * invDet));
+				Store(m[8] + i, Select(singular, a8, (a0 * a4 - a1 * a3) * invDet));
+			}
+		}
+
+		void BatchDeterminant(const Matrix3x3Batch& batch, float* determinants)
+		{
+			const float* m[9];
+			for (int e = 0; e < 9; e++)
+				m[e] = batch.Element(e);
+
+			float tail[BatchAlignment];
+			for (int i = 0; i < batch.stride; i += Width)
+			{
+				Pack a0 = Load(m[0] + i), a1 = Load(m[1] + i), a2 = Load(m[2] + i);
+				Pack a3 = Load(m[3] + i), a4 = Load(m[4] + i), a5 = Load(m[5] + i);
+				Pack a6 = Load(m[6] + i), a7 = Load(m[7] + i), a8 = Load(m[8] + i);
+
+				Pack det = a0 * (a4 * a8 - a5 * a7) - a1 * (a3 * a8 - a5 * a6) + a2 * (a3 * a7 - a4 * a6);
+
+				// the caller's array only holds count values, the padded lanes go through a scratch buffer
+				if (i + Width <= batch.count)
+					Store(determinants + i, det);
+				else
+				{
+					Store(tail, det);
+					for (int j = i; j < batch.count; j++)
+						determinants[j] = tail[j - i];
+				}
+			}
+		}
+
+		template <class P>
+		P Determinant3x3Lanes(const P* a)
+		{
+			return a[0] * (a[4] * a[8] - a[5] * a[7]) - a[1] * (a[3] * a[8] - a[5] * a[6]) + a[2] * (a[3] * a[7] - a[4] * a[6]);
+		}
+
+		void Determinants3x3(const Matrix3x3* matrices, float* determinants, size_t count)
+		{
+			// Matrix3x3 being 9 packed floats, each row is loaded with the next row's first float : the last matrix,
+			// whose 4th float may be past the caller's array, is left to the scalar loop
+			size_t i = 0;
+#if !defined(BABOON_LANES_SCALAR)
+			for (; i + Width < count; i += Width)
+			{
+				const float* m = matrices[i].elements.data();
+				Pack a[9], next;
+				LoadTransposed4(m, 9, a[0], a[1], a[2], next);
+				LoadTransposed4(m + 3, 9, a[3], a[4], a[5], next);
+				LoadTransposed4(m + 6, 9, a[6], a[7], a[8], next);
+				Store(determinants + i, Determinant3x3Lanes(a));
+			}
+#endif
+			for (; i < count; i++)
+				determinants[i] = Determinant3x3Lanes(matrices[i].elements.data());
+		}
+
+		size_t Inverses3x3(const Matrix3x3* matrices, Matrix3x3* inverses, size_t count)
+		{
+			// Rows are loaded and stored 4 floats at a time like in Determinants3x3. The last row's store writes the
+			// loaded first float of the next matrix back, before the first rows' stores give it its own value, so
+			// inverses may be matrices. The last matrix is again left to the scalar loop.
+			size_t i = 0, singular = 0;
+#if !defined(BABOON_LANES_SCALAR)
+			Pack singularLanes = Broadcast<Pack>(0.f);
+			for (; i + Width < count; i += Width)
+			{
+				const float* m = matrices[i].elements.data();
+				float* r = inverses[i].elements.data();
+				Pack a[9], inv[9], next;
+				LoadTransposed4(m, 9, a[0], a[1], a[2], a[3]);
+				LoadTransposed4(m + 3, 9, a[3], a[4], a[5], a[6]);
+				LoadTransposed4(m + 6, 9, a[6], a[7], a[8], next);
+				Mask s = Inverse3x3Lanes(a, inv);
+				StoreTransposed4(r + 6, 9, inv[6], inv[7], inv[8], next);
+				StoreTransposed4(r, 9, inv[0], inv[1], inv[2], inv[3]);
+				StoreTransposed4(r + 3, 9, inv[3], inv[4], inv[5], inv[6]);
+				singularLanes = singularLanes + Select(s, Broadcast<Pack>(1.f), Broadcast<Pack>(0.f));
+			}
+			float lanes[Width];
+			Store(lanes, singularLanes);
+			for (int j = 0; j < Width; j++)
+				singular += (size_t)lanes[j];
+#endif
+			for (; i < count; i++)
+				singular += Inverse3x3Lanes(matrices[i].elements.data(), inverses[i].elements.data()) ? 1 : 0;
+			return singular;
+		}
+
+		void BatchMultiply(const Matrix3x3Batch& mat1, const Matrix3x3Batch& mat2, Matrix3x3Batch& result)
+		{
+			// result may alias an operand, every lane block is fully loaded before anything is stored
+			for (int i = 0; i < mat1.stride; i += Width)
+			{
+				Pack a[9], b[9];
+				for (int e = 0; e < 9; e++)
+				{
+					a[e] = Load(mat1.Element(e) + i);
+					b[e] = Load(mat2.Element(e) + i);
+				}
+
+				for (int r = 0; r < 3; ++r) {
+					for (int c = 0; c < 3; ++c) {
+						Pack sum = a[r * 3] * b[c] + a[r * 3 + 1] * b[3 + c] + a[r * 3 + 2] * b[6 + c];
+						Store(result.Element(r * 3 + c) + i, sum);
+					}
+				}
+			}
+		}
+	}
+}
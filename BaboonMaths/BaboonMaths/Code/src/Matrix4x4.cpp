@@ -1,46 +1,18 @@
 #include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Hints.h"
+#include "Profile.h"
 
 namespace Baboon
 {
-	Matrix4x4::Matrix4x4(bool identity)
-	{
-		switch (identity)
-		{
-		case false:
-			elements = {
-				0.f, 0.f, 0.f, 0.f,
-				0.f, 0.f, 0.f, 0.f,
-				0.f, 0.f, 0.f, 0.f,
-				0.f, 0.f, 0.f, 0.f
-			};
-			break;
-
-		case true:
-			elements = {
-				1.f, 0.f, 0.f, 0.f,
-				0.f, 1.f, 0.f, 0.f,
-				0.f, 0.f, 1.f, 0.f,
-				0.f, 0.f, 0.f, 1.f
-			};
-			break;
-		}
-	}
-
-	Matrix4x4::Matrix4x4(std::array<float, 16> _elements)
-	{
-		if (_elements.size() > 16)
-			abort();
-
-		elements = _elements;
-	}
-
 	void Matrix4x4::Print()
 	{
-		std::vector<Vector4> lines;
-		lines.push_back({ elements[0], elements[1], elements[2], elements[3] });
-		lines.push_back({ elements[4], elements[5], elements[6], elements[7] });
-		lines.push_back({ elements[8], elements[9], elements[10], elements[11] });
-		lines.push_back({ elements[12], elements[13], elements[14], elements[15] });
+		std::array<Vector4, 4> lines = {
+			Vector4(elements[0], elements[1], elements[2], elements[3]),
+			Vector4(elements[4], elements[5], elements[6], elements[7]),
+			Vector4(elements[8], elements[9], elements[10], elements[11]),
+			Vector4(elements[12], elements[13], elements[14], elements[15])
+		};
 		std::cout << "Matrix 4x4 : " << std::endl;
 
 		for (int i = 0; i < lines.size(); i++)
@@ -49,25 +21,26 @@ namespace Baboon
 		}
 
 		std::cout << std::endl;
-		lines.clear();
 	}
 
 	Vector4 Matrix4x4::Diagonal()
 	{
+		BABOON_PROFILE_SCOPE("Matrix4x4::Diagonal");
 		return Vector4(elements[0], elements[5], elements[10], elements[15]);
 	}
 
 	float Matrix4x4::Trace()
 	{
+		BABOON_PROFILE_SCOPE("Matrix4x4::Trace");
 		Vector4 diagonal = Diagonal();
 		return diagonal.x + diagonal.y + diagonal.z + diagonal.w;
 	}
 
 	float Matrix4x4::operator[](int index)
 	{
-		if (index < 0 || index > 15)
+		if (BABOON_UNLIKELY(index < 0 || index > 15))
 		{
-			std::cout << "Error : overflow" << std::endl;
+			Warn("Error : overflow");
 			return NULL;
 		}
 
@@ -76,6 +49,7 @@ namespace Baboon
 
 	void Matrix4x4::Opposite()
 	{
+		BABOON_PROFILE_SCOPE("Matrix4x4::Opposite");
 		for (int i = 0; i < elements.size(); i++)
 		{
 			elements[i] *= -1;
@@ -84,11 +58,10 @@ namespace Baboon
 
 	void Matrix4x4::Inverse()
 	{
+		BABOON_ZONE("Matrix4x4::Inverse");
 		float det = Determinant();
-		if (det == 0) {
-			std::cout << "Cannot invert 4x4 matrix" << std::endl;
-			exit(1);
-		}
+		if (BABOON_UNLIKELY(det == 0))
+			Fail("Cannot invert 4x4 matrix");
 
 		Matrix4x4 cofactorMatrix = Comatrix();
 		cofactorMatrix.Transpose();
@@ -99,6 +72,7 @@ namespace Baboon
 
 	void Matrix4x4::Transpose()
 	{
+		BABOON_PROFILE_SCOPE("Matrix4x4::Transpose");
 		float temp;
 		for (int i = 0; i < 4; ++i) {
 			for (int j = i + 1; j < 4; ++j) {
@@ -111,6 +85,7 @@ namespace Baboon
 
 	void Matrix4x4::GaussJordan()
 	{
+		BABOON_ZONE("Matrix4x4::GaussJordan");
 		std::array<float, 16> newElements = elements;
 
 		int lead = 0;
@@ -150,232 +125,83 @@ namespace Baboon
 		elements = newElements;
 	}
 
-	float Matrix4x4::Determinant()
+	float Matrix4x4::Determinant() const
 	{
-		float det = 0;
-		Matrix3x3 mat1({
-			elements[5], elements[6], elements[7],
-			elements[9], elements[10], elements[11],
-			elements[13], elements[14], elements[15]
-			});
-		Matrix3x3 mat2({
-			elements[4], elements[6], elements[7],
-			elements[8], elements[10], elements[11],
-			elements[12], elements[14], elements[15]
-			});
-		Matrix3x3 mat3({
-			elements[4], elements[5], elements[7],
-			elements[8], elements[9], elements[11],
-			elements[12], elements[13], elements[15]
-			});
-		Matrix3x3 mat4({
-			elements[4], elements[5], elements[6],
-			elements[8], elements[9], elements[10],
-			elements[12], elements[13], elements[14]
-			});
-		det += elements[0] * mat1.Determinant();
-		det -= elements[1] * mat2.Determinant();
-		det += elements[2] * mat3.Determinant();
-		det -= elements[3] * mat4.Determinant();
-		return det;
+		BABOON_PROFILE_SCOPE("Matrix4x4::Determinant");
+		return Kernels().determinant4x4(elements.data());
 	}
 
 	Matrix4x4 Matrix4x4::Comatrix() const
 	{
-		Matrix4x4 solution;
-
-		for (size_t i = 0; i < 4; ++i) {
-			for (size_t j = 0; j < 4; ++j) {
-				Matrix3x3 subMatrix;
-				int p = 0, q = 0;
-				for (size_t x = 0; x < 4; ++x) {
-					if (x == i) continue;
-					q = 0;
-					for (size_t y = 0; y < 4; ++y) {
-						if (y == j) continue;
-						subMatrix.elements[p * 3 + q] = elements[x * 4 + y];
-						++q;
-					}
-					++p;
-				}
-				float cofactorSign = ((i + j) % 2 == 0) ? 1.f : -1.f;
-				solution.elements[i * 4 + j] = cofactorSign * subMatrix.Determinant();
-			}
-		}
+		BABOON_PROFILE_SCOPE("Matrix4x4::Comatrix");
+		const float* a = elements.data();
 
-		return solution;
-	}
+		// the 2x2 minors of rows 0-1 and of rows 2-3, each cofactor weights three of them
+		float s0 = a[0] * a[5] - a[4] * a[1], s1 = a[0] * a[6] - a[4] * a[2], s2 = a[0] * a[7] - a[4] * a[3];
+		float s3 = a[1] * a[6] - a[5] * a[2], s4 = a[1] * a[7] - a[5] * a[3], s5 = a[2] * a[7] - a[6] * a[3];
+		float c0 = a[8] * a[13] - a[12] * a[9], c1 = a[8] * a[14] - a[12] * a[10], c2 = a[8] * a[15] - a[12] * a[11];
+		float c3 = a[9] * a[14] - a[13] * a[10], c4 = a[9] * a[15] - a[13] * a[11], c5 = a[10] * a[15] - a[14] * a[11];
 
-	Matrix4x4 Matrix4x4::Homogeneous(Matrix3x3 m)
-	{
 		return Matrix4x4({
-			m.elements[0], m.elements[1], m.elements[2], 0.f,
-			m.elements[3], m.elements[4], m.elements[5], 0.f,
-			m.elements[6], m.elements[7], m.elements[8], 0.f,
-			0.f, 0.f, 0.f, 1.f
+			a[5] * c5 - a[6] * c4 + a[7] * c3, -a[4] * c5 + a[6] * c2 - a[7] * c1, a[4] * c4 - a[5] * c2 + a[7] * c0, -a[4] * c3 + a[5] * c1 - a[6] * c0,
+			-a[1] * c5 + a[2] * c4 - a[3] * c3, a[0] * c5 - a[2] * c2 + a[3] * c1, -a[0] * c4 + a[1] * c2 - a[3] * c0, a[0] * c3 - a[1] * c1 + a[2] * c0,
+			a[13] * s5 - a[14] * s4 + a[15] * s3, -a[12] * s5 + a[14] * s2 - a[15] * s1, a[12] * s4 - a[13] * s2 + a[15] * s0, -a[12] * s3 + a[13] * s1 - a[14] * s0,
+			-a[9] * s5 + a[10] * s4 - a[11] * s3, a[8] * s5 - a[10] * s2 + a[11] * s1, -a[8] * s4 + a[9] * s2 - a[11] * s0, a[8] * s3 - a[9] * s1 + a[10] * s0
 			});
 	}
 
-	Matrix4x4 Matrix4x4::Add(Matrix4x4 mat1, Matrix4x4 mat2)
+	void Matrix4x4::Determinants(const Matrix4x4* matrices, float* determinants, size_t count)
 	{
-		Matrix4x4 m;
-		for (int i = 0; i < 16; i++)
-		{
-			m.elements[i] = mat1[i] + mat2[i];
-		}
-		return m;
-	}
-
-	Matrix4x4 Matrix4x4::MultiplyNumber(Matrix4x4 mat, float number)
-	{
-		Matrix4x4 m;
-		for (int i = 0; i < 16; i++)
-		{
-			m.elements[i] = mat[i] * number;
-		}
-		return m;
+		BABOON_ZONE("Matrix4x4::Determinants");
+		Kernels().determinants4x4(matrices, determinants, count);
 	}
 
 	Matrix4x4 Matrix4x4::Multiply(Matrix4x4 mat1, Matrix4x4 mat2)
 	{
-		std::array<float, 16> result;
-
-		for (int i = 0; i < 4; ++i) {
-			for (int j = 0; j < 4; ++j) {
-				float sum = 0;
-				for (int k = 0; k < 4; ++k) {
-					sum += mat1.elements[i * 4 + k] * mat2.elements[k * 4 + j];
-				}
-				result[i * 4 + j] = sum;
-			}
-		}
-		Matrix4x4 m(result);
-		return m;
-	}
-
-	Matrix4x4 Matrix4x4::TRS(Vector3 translation, Vector3 rotation, Vector3 scaling)
-	{
-		Matrix4x4 translate({
-			1.f, 0.f, 0.f, translation.x,
-			0.f, 1.f, 0.f, translation.y,
-			0.f, 0.f, 1.f, translation.z,
-			0.f, 0.f, 0.f, 1.f
-			});
-
-		Matrix4x4 rotate = Matrix4x4::Homogeneous(Matrix3x3::Rotation(rotation.x, rotation.y, rotation.z));
-
-		Matrix4x4 scale({
-			scaling.x, 0.f, 0.f, 0.f,
-			0.f, scaling.y, 0.f, 0.f,
-			0.f, 0.f, scaling.z, 0.f,
-			0.f, 0.f, 0.f, 1.f
-			});
-
-		Matrix4x4 TRS = translate * (rotate * scale);
-
-		return TRS;
-	}
-
-	Matrix4x4 Matrix4x4::View(Vector3 up, Vector3 center, Vector3 eye)
-	{
-		Vector3 f = Vector3::Normalize(center - eye);
-		Vector3 r = Vector3::Normalize(Vector3::CrossProduct(f, up));
-		Vector3 u = Vector3::CrossProduct(r, f);
-
-		Matrix4x4 view({
-			r.x, r.y, r.z, -1.f * Vector3::DotProduct(r, eye),
-			u.x, u.y, u.z, -1.f * Vector3::DotProduct(u, eye),
-			-f.x, -f.y, -f.z, Vector3::DotProduct(f, eye),
-			0.f, 0.f, 0.f, 1.f
-			});
-
-		return view;
-	}
-
-	Matrix4x4 Matrix4x4::Perspective(float fovY, float aspect, float near, float far)
-	{
-		return Matrix4x4({
-			1.f / (aspect * tanf(fovY / 2.f)), 0.f, 0.f, 0.f,
-			0.f, 1.f / (tanf(fovY / 2.f)), 0.f, 0.f,
-			0.f, 0.f, -1.f * (far + near) / (far - near), -1.f * (2.f * far * near) / (far - near),
-			0.f, 0.f, -1.f, 0.f
-			});
-	}
-
-	Matrix4x4 Matrix4x4::Orthographic(float top, float bottom, float right, float left, float far, float near)
-	{
-		return Matrix4x4({
-			2.f / (right - left), 0.f, 0.f, -1.f * ((right + left) / (right - left)),
-			0.f, 2.f / (top - bottom), 0.f, -1.f * ((top + bottom) / (top - bottom)),
-			0.f, 0.f, -2.f / (far - near), -1.f * ((far + near) / (far - near)),
-			0.f, 0.f, 0.f, 1.f
-			});
-	}
-
-	Matrix4x4 operator+(const Matrix4x4& mat1, const Matrix4x4& mat2)
-	{
+		BABOON_PROFILE_SCOPE("Matrix4x4::Multiply");
 		Matrix4x4 m;
-		m = Matrix4x4::Add(mat1, mat2);
-		return m;
-	}
-
-	Matrix4x4 operator-(const Matrix4x4& mat1, const Matrix4x4& mat2)
-	{
-		Matrix4x4 m = mat2;
-		m.Opposite();
-		m = Matrix4x4::Add(mat1, mat2);
+		Kernels().multiply4x4(mat1.elements.data(), mat2.elements.data(), m.elements.data());
 		return m;
 	}
 
 	Matrix4x4 operator*(const Matrix4x4& mat1, const Matrix4x4& mat2)
 	{
-		Matrix4x4 m;
-		m = Matrix4x4::Multiply(mat1, mat2);
-		return m;
-	}
-
-	Matrix4x4 operator*(const Matrix4x4& m, const float& f)
-	{
-		Matrix4x4 mat = Matrix4x4::MultiplyNumber(m, f);
-		return mat;
-	}
-
-	Matrix4x4 operator*(const float& f, const Matrix4x4& m)
-	{
-		Matrix4x4 mat = Matrix4x4::MultiplyNumber(m, f);
-		return mat;
+		BABOON_PROFILE_SCOPE("Matrix4x4::operator*");
+		return Matrix4x4::Multiply(mat1, mat2);
 	}
 
 	Vector4 operator*(const Matrix4x4& m, const Vector4& v)
 	{
-		Vector4 vR;
-		vR.x = (m.elements[0] * v.x) + (m.elements[1] * v.y) + (m.elements[2] * v.z) + (m.elements[3] * v.w);
-		vR.y = (m.elements[4] * v.x) + (m.elements[5] * v.y) + (m.elements[6] * v.z) + (m.elements[7] * v.w);
-		vR.z = (m.elements[8] * v.x) + (m.elements[9] * v.y) + (m.elements[10] * v.z) + (m.elements[11] * v.w);
-		vR.w = (m.elements[12] * v.x) + (m.elements[13] * v.y) + (m.elements[14] * v.z) + (m.elements[15] * v.w);
-		return vR;
+		BABOON_PROFILE_SCOPE("Matrix4x4::operator*");
+		float components[4] = { v.x, v.y, v.z, v.w };
+		Kernels().transform4x4(m.elements.data(), components, components);
+		return Vector4(components[0], components[1], components[2], components[3]);
 	}
 
 	Matrix4x4 operator+=(Matrix4x4& mat1, Matrix4x4& mat2)
 	{
+		BABOON_PROFILE_SCOPE("Matrix4x4::operator+=");
 		mat1 = mat1 + mat2;
 		return mat1;
 	}
 
 	Matrix4x4 operator-=(Matrix4x4& mat1, Matrix4x4& mat2)
 	{
+		BABOON_PROFILE_SCOPE("Matrix4x4::operator-=");
 		mat1 = mat1 - mat2;
 		return mat1;
 	}
 
 	Matrix4x4 operator*=(Matrix4x4& mat1, Matrix4x4& mat2)
 	{
+		BABOON_PROFILE_SCOPE("Matrix4x4::operator*=");
 		mat1 = mat1 * mat2;
 		return mat1;
 	}
 
 	Matrix4x4 operator*=(Matrix4x4& m, float& f)
 	{
+		BABOON_PROFILE_SCOPE("Matrix4x4::operator*=");
 		m = m * f;
 		return m;
 	}
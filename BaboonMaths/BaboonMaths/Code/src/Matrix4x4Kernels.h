@@ -0,0 +1,277 @@
+#pragma once
+#include "Lanes.h"
+#include <cfloat>
+
+namespace Baboon::BABOON_LANES_NAMESPACE
+{
+	namespace
+	{
+		using namespace Lanes;
+
+#if !defined(BABOON_LANES_SCALAR)
+		// a 4x4 row fits a SSE register whatever the level, the wider ones only bring FMA
+		inline __m128 MultiplyAdd4(__m128 a, __m128 b, __m128 c)
+		{
+#if defined(BABOON_LANES_AVX2) || defined(BABOON_LANES_AVX512)
+			return _mm_fmadd_ps(a, b, c);
+#else
+			return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+		}
+#endif
+
+		void Multiply4x4(const float* mat1, const float* mat2, float* result)
+		{
+#if defined(BABOON_LANES_SCALAR)
+			float r[16];
+			for (int i = 0; i < 4; ++i) {
+				for (int j = 0; j < 4; ++j)
+					r[i * 4 + j] = mat1[i * 4] * mat2[j] + mat1[i * 4 + 1] * mat2[4 + j] + mat1[i * 4 + 2] * mat2[8 + j] + mat1[i * 4 + 3] * mat2[12 + j];
+			}
+			for (int e = 0; e < 16; e++)
+				result[e] = r[e];
+#else
+			// row i of the product is the rows of mat2 weighted by the elements of row i of mat1
+			__m128 b0 = _mm_loadu_ps(mat2), b1 = _mm_loadu_ps(mat2 + 4), b2 = _mm_loadu_ps(mat2 + 8), b3 = _mm_loadu_ps(mat2 + 12);
+			__m128 rows[4];
+			for (int i = 0; i < 4; ++i) {
+				const float* a = mat1 + i * 4;
+				__m128 row = _mm_mul_ps(_mm_set1_ps(a[0]), b0);
+				row = MultiplyAdd4(_mm_set1_ps(a[1]), b1, row);
+				row = MultiplyAdd4(_mm_set1_ps(a[2]), b2, row);
+				rows[i] = MultiplyAdd4(_mm_set1_ps(a[3]), b3, row);
+			}
+			for (int i = 0; i < 4; ++i)
+				_mm_storeu_ps(result + i * 4, rows[i]);
+#endif
+		}
+
+		void Transform4x4(const float* m, const float* v, float* result)
+		{
+#if defined(BABOON_LANES_SCALAR)
+			float r[4];
+			for (int i = 0; i < 4; ++i)
+				r[i] = m[i * 4] * v[0] + m[i * 4 + 1] * v[1] + m[i * 4 + 2] * v[2] + m[i * 4 + 3] * v[3];
+			for (int i = 0; i < 4; ++i)
+				result[i] = r[i];
+#else
+			// the columns weighted by the components of v
+			__m128 c0 = _mm_loadu_ps(m), c1 = _mm_loadu_ps(m + 4), c2 = _mm_loadu_ps(m + 8), c3 = _mm_loadu_ps(m + 12);
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			__m128 r = _mm_mul_ps(c0, _mm_set1_ps(v[0]));
+			r = MultiplyAdd4(c1, _mm_set1_ps(v[1]), r);
+			r = MultiplyAdd4(c2, _mm_set1_ps(v[2]), r);
+			r = MultiplyAdd4(c3, _mm_set1_ps(v[3]), r);
+			_mm_storeu_ps(result, r);
+#endif
+		}
+
+		// Laplace expansion along the first two rows : the 2x2 minors of rows 0-1 (s) weighted by the complementary
+		// minors of rows 2-3 (c), 30 flops against the 4 Matrix3x3 temporaries of the cofactor expansion
+		template <class P>
+		P Determinant4x4Lanes(const P* e)
+		{
+			P s0 = e[0] * e[5] - e[4] * e[1];
+			P s1 = e[0] * e[6] - e[4] * e[2];
+			P s2 = e[0] * e[7] - e[4] * e[3];
+			P s3 = e[1] * e[6] - e[5] * e[2];
+			P s4 = e[1] * e[7] - e[5] * e[3];
+			P s5 = e[2] * e[7] - e[6] * e[3];
+
+			P c0 = e[8] * e[13] - e[12] * e[9];
+			P c1 = e[8] * e[14] - e[12] * e[10];
+			P c2 = e[8] * e[15] - e[12] * e[11];
+			P c3 = e[9] * e[14] - e[13] * e[10];
+			P c4 = e[9] * e[15] - e[13] * e[11];
+			P c5 = e[10] * e[15] - e[14] * e[11];
+
+			return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+		}
+
+		float Determinant4x4(const float* m)
+		{
+#if defined(BABOON_LANES_SCALAR)
+			return Determinant4x4Lanes(m);
+#else
+			// the same minors, four at a time : s0..s3 are row0.xxxy * row1.yzwz - row1.xxxy * row0.yzwz,
+			// s4 and s5 row0.yz * row1.ww - row1.yz * row0.ww, the c likewise from rows 2 and 3
+			__m128 r0 = _mm_loadu_ps(m), r1 = _mm_loadu_ps(m + 4), r2 = _mm_loadu_ps(m + 8), r3 = _mm_loadu_ps(m + 12);
+			auto minors = [](__m128 a, __m128 b, __m128& low, __m128& high) {
+				__m128 ax = _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 0, 0)), ay = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 2, 1));
+				__m128 bx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 0, 0)), by = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 2, 1));
+				low = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(bx, ay));
+				__m128 az = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 1, 2, 1)), aw = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3));
+				__m128 bz = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 1, 2, 1)), bw = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 3, 3));
+				high = _mm_sub_ps(_mm_mul_ps(az, bw), _mm_mul_ps(bz, aw));
+			};
+			__m128 s, sHigh, c, cHigh;
+			minors(r0, r1, s, sHigh); // s0 s1 s2 s3, s4 s5 s4 s5
+			minors(r2, r3, c, cHigh); // c0 c1 c2 c3, c4 c5 c4 c5
+
+			// s0 c5 - s1 c4 + s2 c3 + s3 c2, then - s4 c1 + s5 c0 in the two low lanes
+			__m128 terms = _mm_mul_ps(_mm_mul_ps(s, _mm_shuffle_ps(cHigh, c, _MM_SHUFFLE(2, 3, 0, 1))), _mm_set_ps(1.f, 1.f, -1.f, 1.f));
+			terms = MultiplyAdd4(_mm_mul_ps(sHigh, _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 1, 0, 1))), _mm_set_ps(0.f, 0.f, 1.f, -1.f), terms);
+			__m128 sum = _mm_add_ps(terms, _mm_movehl_ps(terms, terms));
+			sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+			return _mm_cvtss_f32(sum);
+#endif
+		}
+
+		void Determinants4x4(const Matrix4x4* matrices, float* determinants, size_t count)
+		{
+			size_t i = 0;
+#if !defined(BABOON_LANES_SCALAR)
+			for (; i + Width <= count; i += Width)
+			{
+				// element k of the Width matrices in lanes e[k], Matrix4x4 being 16 packed floats
+				const float* m = matrices[i].elements.data();
+				Pack e[16];
+				LoadTransposed4(m, 16, e[0], e[1], e[2], e[3]);
+				LoadTransposed4(m + 4, 16, e[4], e[5], e[6], e[7]);
+				LoadTransposed4(m + 8, 16, e[8], e[9], e[10], e[11]);
+				LoadTransposed4(m + 12, 16, e[12], e[13], e[14], e[15]);
+				Store(determinants + i, Determinant4x4Lanes(e));
+			}
+#endif
+			for (; i < count; i++)
+				determinants[i] = Determinant4x4(matrices[i].elements.data());
+		}
+
+		// transforms Width points held as x, y and z lanes by the broadcast matrix m
+		template <class P>
+		void TransformLanes(const P* m, P& x, P& y, P& z, bool projective)
+		{
+			P rx = m[0] * x + m[1] * y + m[2] * z + m[3];
+			P ry = m[4] * x + m[5] * y + m[6] * z + m[7];
+			P rz = m[8] * x + m[9] * y + m[10] * z + m[11];
+
+			if (projective) {
+				P invW = Broadcast<P>(1.f) / (m[12] * x + m[13] * y + m[14] * z + m[15]);
+				rx = rx * invW;
+				ry = ry * invW;
+				rz = rz * invW;
+			}
+			x = rx;
+			y = ry;
+			z = rz;
+		}
+
+		void TransformPoints(const Matrix4x4& m, const Vector3* points, Vector3* result, size_t count)
+		{
+			const float* e = m.elements.data();
+			bool projective = e[12] != 0.f || e[13] != 0.f || e[14] != 0.f || e[15] != 1.f;
+
+			Pack lanes[16];
+			for (int k = 0; k < 16; k++)
+				lanes[k] = Broadcast<Pack>(e[k]);
+
+			size_t i = 0;
+			for (; i + Width <= count; i += Width)
+			{
+				// the compiler turns these copies into shuffles, Vector3 being three packed floats
+				float x[Width], y[Width], z[Width];
+				for (int j = 0; j < Width; j++) {
+					x[j] = points[i + j].x;
+					y[j] = points[i + j].y;
+					z[j] = points[i + j].z;
+				}
+
+				Pack px = Load(x), py = Load(y), pz = Load(z);
+				TransformLanes(lanes, px, py, pz, projective);
+				Store(x, px);
+				Store(y, py);
+				Store(z, pz);
+
+				for (int j = 0; j < Width; j++) {
+					result[i + j].x = x[j];
+					result[i + j].y = y[j];
+					result[i + j].z = z[j];
+				}
+			}
+
+			for (; i < count; i++)
+			{
+				float x = points[i].x, y = points[i].y, z = points[i].z;
+				TransformLanes(e, x, y, z, projective);
+				result[i].x = x;
+				result[i].y = y;
+				result[i].z = z;
+			}
+		}
+
+		// projects Width points held as x, y and z lanes to the screen, v holding the viewport lanes (half width,
+		// minus half height, centre x, centre y) and the low end of the depth range ; flags is the sum of the ClipFlag bits
+		template <class P>
+		void ProjectLanes(const P* m, const P* v, bool reverse, P x, P y, P z, P& sx, P& sy, P& flags)
+		{
+			P cx = m[0] * x + m[1] * y + m[2] * z + m[3];
+			P cy = m[4] * x + m[5] * y + m[6] * z + m[7];
+			P cz = m[8] * x + m[9] * y + m[10] * z + m[11];
+			P cw = m[12] * x + m[13] * y + m[14] * z + m[15];
+
+			// behind the eye counts as past the near plane whatever the depth range, each bit is added once
+			auto behind = Less(cw, Broadcast<P>(FLT_MIN));
+			auto belowDepth = Less(cz, v[4] * cw);
+			auto aboveDepth = Less(cw, cz);
+			auto nearPlane = Or(reverse ? aboveDepth : belowDepth, behind);
+			auto farPlane = reverse ? belowDepth : aboveDepth;
+
+			P zero = Broadcast<P>(0.f);
+			flags = Select(Less(cx, -cw), Broadcast<P>(ClipLeft), zero) + Select(Less(cw, cx), Broadcast<P>(ClipRight), zero)
+				+ Select(Less(cy, -cw), Broadcast<P>(ClipBottom), zero) + Select(Less(cw, cy), Broadcast<P>(ClipTop), zero)
+				+ Select(nearPlane, Broadcast<P>(ClipNear), zero) + Select(farPlane, Broadcast<P>(ClipFar), zero);
+
+			P invW = Broadcast<P>(1.f) / cw;
+			sx = cx * invW * v[0] + v[2];
+			sy = cy * invW * v[1] + v[3];
+		}
+
+		void ProjectToScreen(const Matrix4x4& m, const Viewport& viewport, DepthRange range, const Vector3* points, Vector2* screen, uint8_t* clipFlags, size_t count)
+		{
+			const float* e = m.elements.data();
+			float halfWidth = 0.5f * viewport.width, halfHeight = 0.5f * viewport.height;
+			const float v[5] = { halfWidth, -halfHeight, viewport.x + halfWidth, viewport.y + halfHeight, range == DepthRange::MinusOneToOne ? -1.f : 0.f };
+			bool reverse = range == DepthRange::ReverseZ;
+
+			size_t i = 0;
+#if !defined(BABOON_LANES_SCALAR)
+			Pack lanes[16], viewportLanes[5];
+			for (int k = 0; k < 16; k++)
+				lanes[k] = Broadcast<Pack>(e[k]);
+			for (int k = 0; k < 5; k++)
+				viewportLanes[k] = Broadcast<Pack>(v[k]);
+
+			// Vector3 being three packed floats, each point is loaded with the next one's x : the last point, whose
+			// next x may be past the caller's array, is left to the scalar loop
+			for (; i + Width < count; i += Width)
+			{
+				Pack x, y, z, next, sx, sy, flags;
+				LoadTransposed4(&points[i].x, 3, x, y, z, next);
+				ProjectLanes(lanes, viewportLanes, reverse, x, y, z, sx, sy, flags);
+
+				float px[Width], py[Width], f[Width];
+				Store(px, sx);
+				Store(py, sy);
+				Store(f, flags);
+				for (int j = 0; j < Width; j++) {
+					screen[i + j].x = px[j];
+					screen[i + j].y = py[j];
+				}
+				if (clipFlags) {
+					for (int j = 0; j < Width; j++)
+						clipFlags[i + j] = (uint8_t)f[j];
+				}
+			}
+#endif
+			for (; i < count; i++)
+			{
+				float sx, sy, flags;
+				ProjectLanes(e, v, reverse, points[i].x, points[i].y, points[i].z, sx, sy, flags);
+				screen[i].x = sx;
+				screen[i].y = sy;
+				if (clipFlags)
+					clipFlags[i] = (uint8_t)flags;
+			}
+		}
+	}
+}
@@ -0,0 +1,408 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Hints.h"
+#include "Profile.h"
+#include <algorithm>
+#include <thread>
+
+namespace Baboon
+{
+	namespace
+	{
+		// register tile of the micro kernel
+		constexpr int MR = GemmMR;
+		constexpr int NR = GemmNR;
+		// cache blocks : a MC x KC block of mat1 stays in L2, a KC x NC panel of mat2 in L3
+		constexpr int MC = 120;
+		constexpr int KC = 256;
+		constexpr int NC = 1024;
+		// below this many multiply-adds a product is not worth spreading across threads
+		constexpr long long ThreadingThreshold = 64LL * 64LL * 64LL;
+
+		// packs a mc x kc block of a into MR-row micro panels, padding the last one with zeros
+		void PackA(int mc, int kc, const float* a, int lda, float* packed)
+		{
+			for (int i = 0; i < mc; i += MR)
+			{
+				int mr = std::min(MR, mc - i);
+				for (int p = 0; p < kc; ++p)
+				{
+					for (int r = 0; r < mr; ++r)
+						packed[r] = a[(size_t)(i + r) * lda + p];
+					for (int r = mr; r < MR; ++r)
+						packed[r] = 0.f;
+					packed += MR;
+				}
+			}
+		}
+
+		// packs a kc x nc panel of b into NR-column micro panels, padding the last one with zeros
+		void PackB(int kc, int nc, const float* b, int ldb, float* packed)
+		{
+			for (int j = 0; j < nc; j += NR)
+			{
+				int nr = std::min(NR, nc - j);
+				for (int p = 0; p < kc; ++p)
+				{
+					const float* row = b + (size_t)p * ldb + j;
+					for (int c = 0; c < nr; ++c)
+						packed[c] = row[c];
+					for (int c = nr; c < NR; ++c)
+						packed[c] = 0.f;
+					packed += NR;
+				}
+			}
+		}
+
+		// runs the blocked product on a slice of rows, c must already be zeroed
+		void GemmBlocked(int m, int n, int k, const float* a, int lda, const float* b, int ldb, float* c, int ldc)
+		{
+			// the panels are kept per thread so repeated products do not allocate
+			thread_local std::vector<float> packedA;
+			thread_local std::vector<float> packedB;
+			packedA.resize(MC * KC);
+			packedB.resize(std::max(packedB.size(), (size_t)KC * ((std::min(n, NC) + NR - 1) / NR) * NR));
+			float edge[MR * NR];
+			auto microKernel = Kernels().gemmMicroKernel;
+
+			for (int jc = 0; jc < n; jc += NC)
+			{
+				int nc = std::min(NC, n - jc);
+				for (int pc = 0; pc < k; pc += KC)
+				{
+					int kc = std::min(KC, k - pc);
+					PackB(kc, nc, b + (size_t)pc * ldb + jc, ldb, packedB.data());
+
+					for (int ic = 0; ic < m; ic += MC)
+					{
+						int mc = std::min(MC, m - ic);
+						PackA(mc, kc, a + (size_t)ic * lda + pc, lda, packedA.data());
+
+						for (int jr = 0; jr < nc; jr += NR)
+						{
+							int nr = std::min(NR, nc - jr);
+							for (int ir = 0; ir < mc; ir += MR)
+							{
+								int mr = std::min(MR, mc - ir);
+								float* tile = c + (size_t)(ic + ir) * ldc + jc + jr;
+
+								if (mr == MR && nr == NR)
+								{
+									microKernel(kc, packedA.data() + ir * kc, packedB.data() + jr * kc, tile, ldc);
+									continue;
+								}
+
+								// partial tile on the matrix border : compute in a scratch tile then copy the valid part
+								std::fill(edge, edge + MR * NR, 0.f);
+								microKernel(kc, packedA.data() + ir * kc, packedB.data() + jr * kc, edge, NR);
+								for (int r = 0; r < mr; ++r)
+								{
+									for (int j = 0; j < nr; ++j)
+										tile[(size_t)r * ldc + j] += edge[r * NR + j];
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	MatrixX::MatrixX() : rows(0), cols(0) {}
+
+	MatrixX::MatrixX(int _rows, int _cols, bool identity, std::pmr::memory_resource* resource)
+		: rows(_rows), cols(_cols), elements(resource)
+	{
+		if (BABOON_UNLIKELY(_rows < 0 || _cols < 0))
+			abort();
+
+		elements.assign((size_t)_rows * _cols, 0.f);
+
+		if (identity)
+		{
+			for (int i = 0; i < std::min(_rows, _cols); i++)
+			{
+				elements[(size_t)i * _cols + i] = 1.f;
+			}
+		}
+	}
+
+	MatrixX::MatrixX(int _rows, int _cols, std::vector<float> _elements) : rows(_rows), cols(_cols)
+	{
+		if (BABOON_UNLIKELY(_rows < 0 || _cols < 0 || _elements.size() != (size_t)_rows * _cols))
+			abort();
+
+		elements.assign(_elements.begin(), _elements.end());
+	}
+
+	MatrixX::MatrixX(const Matrix2x2& m) : rows(2), cols(2), elements(m.elements.begin(), m.elements.end()) {}
+
+	MatrixX::MatrixX(const Matrix3x3& m) : rows(3), cols(3), elements(m.elements.begin(), m.elements.end()) {}
+
+	MatrixX::MatrixX(const Matrix4x4& m) : rows(4), cols(4), elements(m.elements.begin(), m.elements.end()) {}
+
+	void MatrixX::Print()
+	{
+		std::cout << "Matrix " << rows << "x" << cols << " : " << std::endl;
+
+		for (int i = 0; i < rows; i++)
+		{
+			for (int j = 0; j < cols; j++)
+			{
+				std::cout << elements[(size_t)i * cols + j] << (j + 1 < cols ? "  " : "");
+			}
+			std::cout << std::endl;
+		}
+
+		std::cout << std::endl;
+	}
+
+	float MatrixX::operator[](int index)
+	{
+		if (BABOON_UNLIKELY(index < 0 || (size_t)index >= elements.size()))
+		{
+			Warn("Error : overflow");
+			return 0.f;
+		}
+
+		return elements[index];
+	}
+
+	float& MatrixX::At(int row, int col)
+	{
+		return elements[(size_t)row * cols + col];
+	}
+
+	float MatrixX::At(int row, int col) const
+	{
+		return elements[(size_t)row * cols + col];
+	}
+
+	void MatrixX::Opposite()
+	{
+		BABOON_PROFILE_SCOPE("MatrixX::Opposite");
+		for (size_t i = 0; i < elements.size(); i++)
+		{
+			elements[i] *= -1;
+		}
+	}
+
+	void MatrixX::Transpose()
+	{
+		BABOON_PROFILE_SCOPE("MatrixX::Transpose");
+		std::pmr::vector<float> transposed(elements.size(), 0.f, elements.get_allocator());
+
+		for (int i = 0; i < rows; ++i) {
+			for (int j = 0; j < cols; ++j) {
+				transposed[(size_t)j * rows + i] = elements[(size_t)i * cols + j];
+			}
+		}
+
+		elements = std::move(transposed);
+		std::swap(rows, cols);
+	}
+
+	MatrixX MatrixX::Add(const MatrixX& mat1, const MatrixX& mat2)
+	{
+		BABOON_PROFILE_SCOPE("MatrixX::Add");
+		if (BABOON_UNLIKELY(mat1.rows != mat2.rows || mat1.cols != mat2.cols))
+			Fail("Cannot add matrices of different sizes");
+
+		MatrixX m(mat1.rows, mat1.cols);
+		for (size_t i = 0; i < m.elements.size(); i++)
+		{
+			m.elements[i] = mat1.elements[i] + mat2.elements[i];
+		}
+		return m;
+	}
+
+	MatrixX MatrixX::MultiplyNumber(const MatrixX& mat, float number)
+	{
+		BABOON_PROFILE_SCOPE("MatrixX::MultiplyNumber");
+		MatrixX m(mat.rows, mat.cols);
+		for (size_t i = 0; i < m.elements.size(); i++)
+		{
+			m.elements[i] = mat.elements[i] * number;
+		}
+		return m;
+	}
+
+	MatrixX MatrixX::Multiply(const MatrixX& mat1, const MatrixX& mat2, int threadCount)
+	{
+		BABOON_ZONE("MatrixX::Multiply");
+		if (BABOON_UNLIKELY(mat1.cols != mat2.rows))
+			Fail("Cannot multiply matrices with mismatched sizes");
+
+		MatrixX m(mat1.rows, mat2.cols);
+		Gemm(mat1.rows, mat2.cols, mat1.cols, mat1.elements.data(), mat1.cols,
+			mat2.elements.data(), mat2.cols, m.elements.data(), m.cols, threadCount);
+		return m;
+	}
+
+	void MatrixX::Gemm(int m, int n, int k, const float* a, int lda, const float* b, int ldb, float* c, int ldc, int threadCount)
+	{
+		BABOON_ZONE("MatrixX::Gemm");
+		for (int i = 0; i < m; ++i)
+			std::fill(c + (size_t)i * ldc, c + (size_t)i * ldc + n, 0.f);
+
+		if (m == 0 || n == 0 || k == 0)
+			return;
+
+		if (threadCount <= 0)
+			threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+
+		// every thread gets whole MR row tiles and packs its own panels, so no synchronisation is needed
+		int tiles = (m + MR - 1) / MR;
+		threadCount = std::min(threadCount, tiles);
+		if ((long long)m * n * k < ThreadingThreshold)
+			threadCount = 1;
+
+		if (threadCount == 1)
+		{
+			GemmBlocked(m, n, k, a, lda, b, ldb, c, ldc);
+			return;
+		}
+
+		std::vector<std::thread> workers;
+		workers.reserve(threadCount - 1);
+		int first = 0;
+		for (int t = 0; t < threadCount; ++t)
+		{
+			int count = (tiles / threadCount + (t < tiles % threadCount ? 1 : 0)) * MR;
+			int rowCount = std::min(count, m - first);
+			const float* aSlice = a + (size_t)first * lda;
+			float* cSlice = c + (size_t)first * ldc;
+
+			if (t + 1 == threadCount)
+				GemmBlocked(rowCount, n, k, aSlice, lda, b, ldb, cSlice, ldc);
+			else
+				workers.emplace_back(GemmBlocked, rowCount, n, k, aSlice, lda, b, ldb, cSlice, ldc);
+
+			first += rowCount;
+		}
+
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	void MatrixX::Assign(const MatrixXProduct& p)
+	{
+		BABOON_ZONE("MatrixX::Assign");
+		// the chain is fully evaluated before being moved in, so p may reference *this
+		*this = p.Evaluate();
+	}
+
+	void MatrixXCheckSameSize(int rows1, int cols1, int rows2, int cols2)
+	{
+		if (BABOON_UNLIKELY(rows1 != rows2 || cols1 != cols2))
+			Fail("Cannot add matrices of different sizes");
+	}
+
+	void MatrixXProduct::Append(const MatrixX& m)
+	{
+		if (BABOON_UNLIKELY(!factors.empty() && factors.back()->cols != m.rows))
+			Fail("Cannot multiply matrices with mismatched sizes");
+
+		factors.push_back(&m);
+		result.reset();
+	}
+
+	void MatrixXProduct::Append(const MatrixXProduct& p)
+	{
+		for (const MatrixX* factor : p.factors)
+			Append(*factor);
+
+		owned.insert(owned.end(), p.owned.begin(), p.owned.end());
+	}
+
+	void MatrixXProduct::Append(std::shared_ptr<const MatrixX> m)
+	{
+		Append(*m);
+		owned.push_back(std::move(m));
+	}
+
+	int MatrixXProduct::Rows() const
+	{
+		return factors.empty() ? 0 : factors.front()->rows;
+	}
+
+	int MatrixXProduct::Cols() const
+	{
+		return factors.empty() ? 0 : factors.back()->cols;
+	}
+
+	float MatrixXProduct::Coefficient(size_t index) const
+	{
+		if (!result)
+			result = std::make_shared<const MatrixX>(Evaluate());
+
+		return result->elements[index];
+	}
+
+	MatrixX MatrixXProduct::Evaluate() const
+	{
+		BABOON_ZONE("MatrixXProduct::Evaluate");
+		if (result)
+			return *result;
+
+		int n = (int)factors.size();
+		if (n == 0)
+			return MatrixX();
+		if (n == 1)
+			return *factors[0];
+
+		// classic matrix chain ordering : factor i is dims[i] x dims[i + 1], cost[i * n + j] is the
+		// cheapest number of multiply-adds for factors i..j and split[i * n + j] where to cut that range
+		std::vector<long long> dims(n + 1);
+		for (int i = 0; i < n; i++)
+			dims[i] = factors[i]->rows;
+		dims[n] = factors[n - 1]->cols;
+
+		std::vector<long long> cost((size_t)n * n, 0);
+		std::vector<int> split((size_t)n * n, 0);
+		for (int length = 2; length <= n; length++)
+		{
+			for (int i = 0; i + length - 1 < n; i++)
+			{
+				int j = i + length - 1;
+				cost[i * n + j] = -1;
+				for (int k = i; k < j; k++)
+				{
+					long long c = cost[i * n + k] + cost[(k + 1) * n + j] + dims[i] * dims[k + 1] * dims[j + 1];
+					if (cost[i * n + j] < 0 || c < cost[i * n + j])
+					{
+						cost[i * n + j] = c;
+						split[i * n + j] = k;
+					}
+				}
+			}
+		}
+
+		struct Chain
+		{
+			const std::vector<const MatrixX*>& factors;
+			const std::vector<int>& split;
+			int n;
+
+			MatrixX Multiply(int i, int j) const
+			{
+				int k = split[i * n + j];
+				MatrixX leftProduct, rightProduct;
+				const MatrixX* left = factors[i];
+				const MatrixX* right = factors[k + 1];
+
+				if (k > i) {
+					leftProduct = Multiply(i, k);
+					left = &leftProduct;
+				}
+				if (j > k + 1) {
+					rightProduct = Multiply(k + 1, j);
+					right = &rightProduct;
+				}
+				return MatrixX::Multiply(*left, *right);
+			}
+		};
+
+		return Chain{ factors, split, n }.Multiply(0, n - 1);
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Lanes.h"
+
+namespace Baboon::BABOON_LANES_NAMESPACE
+{
+	namespace
+	{
+		using namespace Lanes;
+
+		// c += a * b for one GemmMR x GemmNR tile, a and b being packed micro panels of depth kc.
+		// The accumulators are GemmMR rows of GemmNR / Width packs : 12 registers with AVX2, 6 with AVX-512.
+		// With SSE packs they would not fit the 16 registers, the tile is then run in column groups. The plain
+		// float one stays whole for the compiler to vectorize.
+		void GemmMicroKernel(int kc, const float* a, const float* b, float* c, int ldc)
+		{
+			constexpr int Columns = GemmNR / Width;
+			constexpr int Group = Width == 1 || Columns * GemmMR <= 12 ? Columns : 12 / GemmMR;
+			static_assert(GemmNR % Width == 0 && Columns % Group == 0, "a micro panel row is made of whole groups of packs");
+
+			for (int g = 0; g < Columns; g += Group)
+			{
+				const float* ap = a;
+				const float* bp = b + g * Width;
+
+				Pack acc[GemmMR][Group];
+				for (int r = 0; r < GemmMR; ++r) {
+					for (int j = 0; j < Group; ++j)
+						acc[r][j] = Broadcast<Pack>(0.f);
+				}
+
+				for (int p = 0; p < kc; ++p)
+				{
+					Pack row[Group];
+					for (int j = 0; j < Group; ++j)
+						row[j] = Load(bp + j * Width);
+
+					for (int r = 0; r < GemmMR; ++r)
+					{
+						Pack ar = Broadcast<Pack>(ap[r]);
+						for (int j = 0; j < Group; ++j)
+							acc[r][j] = MultiplyAdd(ar, row[j], acc[r][j]);
+					}
+					ap += GemmMR;
+					bp += GemmNR;
+				}
+
+				for (int r = 0; r < GemmMR; ++r)
+				{
+					float* out = c + (size_t)r * ldc + g * Width;
+					for (int j = 0; j < Group; ++j)
+						Store(out + j * Width, Load(out + j * Width) + acc[r][j]);
+				}
+			}
+		}
+	}
+}
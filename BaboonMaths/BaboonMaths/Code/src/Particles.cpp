@@ -0,0 +1,102 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Lanes.h"
+#include "Profile.h"
+#include <algorithm>
+#include <climits>
+#include <thread>
+
+namespace Baboon
+{
+	using namespace Lanes;
+
+	namespace
+	{
+		// below this many particles per thread, starting threads costs more than it saves
+		constexpr int ParticlesPerThread = 16384;
+
+		bool OutOfBounds(const ParticleStreams& particles, const ParticleForces& forces, int i)
+		{
+			float x = particles.positions.x[i], y = particles.positions.y[i], z = particles.positions.z[i];
+			return x < forces.boundsMin.x || x > forces.boundsMax.x || y < forces.boundsMin.y || y > forces.boundsMax.y
+				|| z < forces.boundsMin.z || z > forces.boundsMax.z;
+		}
+
+		void MoveParticle(const ParticleStreams& particles, int from, int to)
+		{
+			for (const Vector3Lanes* lanes : { &particles.positions, &particles.velocities, &particles.previous }) {
+				if (lanes->x) {
+					lanes->x[to] = lanes->x[from];
+					lanes->y[to] = lanes->y[from];
+					lanes->z[to] = lanes->z[from];
+				}
+			}
+		}
+
+		using IntegrateKernel = int (*)(const ParticleStreams&, const ParticleForces&, float, int, int);
+
+		// splits the system in chunks of whole packs of any level over the threads, then removes the killed particles
+		int Integrate(IntegrateKernel kernel, ParticleStreams& particles, const ParticleForces& forces, float dt, int threadCount)
+		{
+			int count = particles.count;
+			if (threadCount <= 0)
+				threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+			threadCount = std::max(1, std::min(threadCount, count / ParticlesPerThread));
+
+			// first pack of each chunk holding a killed particle, chunks are in order so the compaction can skip the others
+			std::vector<int> firstOut(threadCount, INT_MAX);
+			std::vector<int> chunkEnd(threadCount);
+			auto run = [&](int t, int begin, int end) {
+				firstOut[t] = kernel(particles, forces, dt, begin, end);
+			};
+
+			int packs = count / BatchAlignment;
+			std::vector<std::thread> workers;
+			workers.reserve(threadCount - 1);
+			int begin = 0;
+			for (int t = 0; t < threadCount; t++)
+			{
+				int end = t + 1 == threadCount ? count : begin + (packs / threadCount + (t < packs % threadCount ? 1 : 0)) * BatchAlignment;
+				chunkEnd[t] = end;
+				if (t + 1 == threadCount)
+					run(t, begin, end);
+				else
+					workers.emplace_back(run, t, begin, end);
+				begin = end;
+			}
+
+			for (std::thread& worker : workers)
+				worker.join();
+
+			// the last alive particles fill the holes, each is tested again as it may be out as well
+			for (int t = 0; t < threadCount; t++)
+			{
+				for (int i = firstOut[t]; i < std::min(chunkEnd[t], count); i++) {
+					while (i < count && OutOfBounds(particles, forces, i))
+						MoveParticle(particles, --count, i);
+				}
+			}
+
+			particles.count = count;
+			return count;
+		}
+	}
+
+	int Particles::ExplicitEuler(ParticleStreams& particles, const ParticleForces& forces, float dt, int threadCount)
+	{
+		BABOON_ZONE("Particles::ExplicitEuler");
+		return Integrate(Kernels().explicitEuler, particles, forces, dt, threadCount);
+	}
+
+	int Particles::SemiImplicitEuler(ParticleStreams& particles, const ParticleForces& forces, float dt, int threadCount)
+	{
+		BABOON_ZONE("Particles::SemiImplicitEuler");
+		return Integrate(Kernels().semiImplicitEuler, particles, forces, dt, threadCount);
+	}
+
+	int Particles::Verlet(ParticleStreams& particles, const ParticleForces& forces, float dt, int threadCount)
+	{
+		BABOON_ZONE("Particles::Verlet");
+		return Integrate(Kernels().verlet, particles, forces, dt, threadCount);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+#include "Lanes.h"
+
+namespace Baboon::BABOON_LANES_NAMESPACE
+{
+	namespace
+	{
+		using namespace Lanes;
+
+		enum class Integrator { ExplicitEuler, SemiImplicitEuler, Verlet };
+
+		// forces broadcast once per chunk rather than once per pack
+		template <class P>
+		struct LaneForces
+		{
+			P gravity[3];
+			P damping; // 1 - drag * dt
+			P min[3];
+			P max[3];
+			P dt;
+			P dtSquared;
+
+			LaneForces(const ParticleForces& forces, float step)
+			{
+				const float g[3] = { forces.gravity.x, forces.gravity.y, forces.gravity.z };
+				const float lo[3] = { forces.boundsMin.x, forces.boundsMin.y, forces.boundsMin.z };
+				const float hi[3] = { forces.boundsMax.x, forces.boundsMax.y, forces.boundsMax.z };
+				for (int c = 0; c < 3; c++) {
+					gravity[c] = Broadcast<P>(g[c]);
+					min[c] = Broadcast<P>(lo[c]);
+					max[c] = Broadcast<P>(hi[c]);
+				}
+				damping = Broadcast<P>(1.f - forces.drag * step);
+				dt = Broadcast<P>(step);
+				dtSquared = Broadcast<P>(step * step);
+			}
+		};
+
+		// integrates the particles from i, as many as the lane count of P, returns true if one of them left the bounds
+		template <Integrator I, bool Kill, class P>
+		bool IntegrateLanes(const ParticleStreams& particles, const LaneForces<P>& f, int i)
+		{
+			float* x[3] = { particles.positions.x + i, particles.positions.y + i, particles.positions.z + i };
+			P position[3];
+
+			if (I == Integrator::Verlet)
+			{
+				float* previous[3] = { particles.previous.x + i, particles.previous.y + i, particles.previous.z + i };
+				for (int c = 0; c < 3; c++) {
+					P current = LoadAs<P>(x[c]);
+					position[c] = current + (current - LoadAs<P>(previous[c])) * f.damping + f.gravity[c] * f.dtSquared;
+					Store(previous[c], current);
+					Store(x[c], position[c]);
+				}
+			}
+			else
+			{
+				float* v[3] = { particles.velocities.x + i, particles.velocities.y + i, particles.velocities.z + i };
+				for (int c = 0; c < 3; c++) {
+					P velocity = LoadAs<P>(v[c]);
+					// the drag is folded in the damping : v + (g - drag * v) * dt = v * (1 - drag * dt) + g * dt
+					P next = velocity * f.damping + f.gravity[c] * f.dt;
+					position[c] = LoadAs<P>(x[c]) + (I == Integrator::ExplicitEuler ? velocity : next) * f.dt;
+					Store(v[c], next);
+					Store(x[c], position[c]);
+				}
+			}
+
+			if (!Kill)
+				return false;
+
+			auto out = Or(Less(position[0], f.min[0]), Less(f.max[0], position[0]));
+			for (int c = 1; c < 3; c++)
+				out = Or(out, Or(Less(position[c], f.min[c]), Less(f.max[c], position[c])));
+			return Any(out);
+		}
+
+		template <Integrator I, bool Kill>
+		int IntegrateRange(const ParticleStreams& particles, const ParticleForces& forces, float dt, int first, int end)
+		{
+			LaneForces<Pack> packForces(forces, dt);
+			LaneForces<float> floatForces(forces, dt);
+
+			int firstOut = INT_MAX;
+			int i = first;
+			for (; i + Width <= end; i += Width) {
+				if (IntegrateLanes<I, Kill>(particles, packForces, i) && firstOut == INT_MAX)
+					firstOut = i;
+			}
+			for (; i < end; i++) {
+				if (IntegrateLanes<I, Kill>(particles, floatForces, i) && firstOut == INT_MAX)
+					firstOut = i;
+			}
+			return firstOut;
+		}
+
+		template <Integrator I>
+		int IntegrateParticles(const ParticleStreams& particles, const ParticleForces& forces, float dt, int first, int end)
+		{
+			if (forces.killOutOfBounds)
+				return IntegrateRange<I, true>(particles, forces, dt, first, end);
+			return IntegrateRange<I, false>(particles, forces, dt, first, end);
+		}
+	}
+}
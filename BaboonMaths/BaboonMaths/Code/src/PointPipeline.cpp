@@ -0,0 +1,155 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Hints.h"
+#include "Profile.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Baboon
+{
+	namespace
+	{
+		// blocking queue of chunk indices between two pipeline stages
+		class ChunkQueue
+		{
+		public:
+			void Push(int chunk)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					chunks.push_back(chunk);
+				}
+				ready.notify_one();
+			}
+
+			int Pop()
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				ready.wait(lock, [this] { return !chunks.empty(); });
+				int chunk = chunks.front();
+				chunks.pop_front();
+				return chunk;
+			}
+
+		private:
+			std::mutex mutex;
+			std::condition_variable ready;
+			std::deque<int> chunks;
+		};
+
+		struct Chunk
+		{
+			std::vector<Vector3> points;
+			size_t count = 0;
+		};
+	}
+
+	void Matrix4x4::TransformPoints(const Matrix4x4& m, const Vector3* points, Vector3* result, size_t count)
+	{
+		BABOON_ZONE("Matrix4x4::TransformPoints");
+		Kernels().transformPoints(m, points, result, count);
+	}
+
+	PointPipeline::PointPipeline(size_t _chunkSize, int _chunkCount)
+		: transform(true), chunkSize(_chunkSize), chunkCount(_chunkCount)
+	{
+		if (BABOON_UNLIKELY(_chunkSize == 0 || _chunkCount < 1))
+			Fail("Cannot create a point pipeline without chunks");
+	}
+
+	void PointPipeline::SetTransform(const Matrix4x4& m)
+	{
+		BABOON_PROFILE_SCOPE("PointPipeline::SetTransform");
+		transform = m;
+	}
+
+	void PointPipeline::SetTransform(const Matrix4x4* chain, int count)
+	{
+		BABOON_PROFILE_SCOPE("PointPipeline::SetTransform");
+		transform = Matrix4x4(true);
+		for (int i = 0; i < count; i++)
+			transform = chain[i] * transform;
+	}
+
+	const Matrix4x4& PointPipeline::Transform() const
+	{
+		return transform;
+	}
+
+	uint64_t PointPipeline::Run(const Source& source, const Sink& sink)
+	{
+		BABOON_ZONE("PointPipeline::Run");
+		// chunks cycle free -> read -> transformed -> free, an empty chunk tells the next stage the stream ended
+		std::vector<Chunk> chunks(chunkCount);
+		ChunkQueue freeChunks, readChunks, transformedChunks;
+		for (int i = 0; i < chunkCount; i++)
+		{
+			chunks[i].points.resize(chunkSize);
+			freeChunks.Push(i);
+		}
+
+		std::atomic<bool> stopped(false);
+		uint64_t written = 0;
+
+		std::thread reader([&] {
+			for (;;)
+			{
+				int c = freeChunks.Pop();
+				size_t count = stopped ? 0 : source(chunks[c].points.data(), chunkSize);
+				chunks[c].count = count;
+				readChunks.Push(c);
+				if (count == 0)
+					return;
+			}
+		});
+
+		std::thread writer([&] {
+			for (;;)
+			{
+				int c = transformedChunks.Pop();
+				if (chunks[c].count == 0)
+					return;
+
+				// keeps draining after a failed write so the other stages never block
+				if (!stopped) {
+					if (sink(chunks[c].points.data(), chunks[c].count))
+						written += chunks[c].count;
+					else
+						stopped = true;
+				}
+				freeChunks.Push(c);
+			}
+		});
+
+		for (;;)
+		{
+			// the count is read before handing the chunk over, the other stages may refill it right away
+			int c = readChunks.Pop();
+			size_t count = chunks[c].count;
+			Matrix4x4::TransformPoints(transform, chunks[c].points.data(), chunks[c].points.data(), count);
+			transformedChunks.Push(c);
+			if (count == 0)
+				break;
+		}
+
+		reader.join();
+		writer.join();
+		return written;
+	}
+
+	uint64_t PointPipeline::Run(std::istream& in, std::ostream& out)
+	{
+		BABOON_ZONE("PointPipeline::Run");
+		return Run(
+			[&in](Vector3* points, size_t capacity) {
+				in.read(reinterpret_cast<char*>(points), (std::streamsize)(capacity * sizeof(Vector3)));
+				return (size_t)in.gcount() / sizeof(Vector3);
+			},
+			[&out](const Vector3* points, size_t count) {
+				out.write(reinterpret_cast<const char*>(points), (std::streamsize)(count * sizeof(Vector3)));
+				return (bool)out;
+			});
+	}
+}
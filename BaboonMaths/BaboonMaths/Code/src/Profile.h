@@ -0,0 +1,86 @@
+#pragma once
+#include "BaboonMaths.h"
+
+// BABOON_PROFILE_SCOPE("Class::Operation") opens every instrumented operation. In the BABOON_PROFILE build it counts
+// the call in the calling thread's counters, without any lock or shared write, and times it if Profiler::Timing().
+// Otherwise it expands to nothing.
+#if defined(BABOON_PROFILE)
+namespace Baboon
+{
+	namespace Profiling
+	{
+		constexpr int MaxOperations = 512;
+
+		// written by their thread only, atomics so that Snapshot reads them from another one
+		struct ThreadCounters
+		{
+			std::atomic<uint64_t> calls[MaxOperations];
+			std::atomic<uint64_t> cycles[MaxOperations];
+		};
+
+		extern thread_local ThreadCounters* threadCounters;
+		extern std::atomic<bool> timing;
+
+		int Register(const char* name); // index of the operation, the same for every call with that name
+		ThreadCounters& AttachThread();
+		uint64_t Timestamp();
+
+		inline ThreadCounters& Counters()
+		{
+			ThreadCounters* counters = threadCounters;
+			return counters ? *counters : AttachThread();
+		}
+
+		inline void Add(std::atomic<uint64_t>& counter, uint64_t n)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+		}
+
+		class Scope
+		{
+		public:
+			explicit Scope(int _id) : counters(Counters()), id(_id), start(timing.load(std::memory_order_relaxed) ? Timestamp() : 0)
+			{
+				Add(counters.calls[id], 1);
+			}
+
+			~Scope()
+			{
+				if (start)
+					Add(counters.cycles[id], Timestamp() - start);
+			}
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			ThreadCounters& counters;
+			int id;
+			uint64_t start;
+		};
+	}
+}
+
+#define BABOON_PROFILE_SCOPE(name) \
+	static const int baboonProfileId = ::Baboon::Profiling::Register(name); \
+	::Baboon::Profiling::Scope baboonProfileScope(baboonProfileId)
+#else
+#define BABOON_PROFILE_SCOPE(name) ((void)0)
+#endif
+
+// BABOON_ZONE opens the batch and solver entry points instead : the same counting, plus, in the BABOON_TRACY build
+// (Tracy's headers on the include path, TRACY_ENABLE defined as Tracy wants), a zone named after the operation whose
+// text is the SimdLevel its kernels run at.
+#if defined(BABOON_TRACY)
+#include <cstring>
+#include <tracy/Tracy.hpp>
+#define BABOON_TRACY_ZONE(name) \
+	ZoneScopedN(name); \
+	ZoneText(::Baboon::Cpu::Name(::Baboon::Cpu::Active()), std::strlen(::Baboon::Cpu::Name(::Baboon::Cpu::Active())))
+#else
+#define BABOON_TRACY_ZONE(name)
+#endif
+
+#define BABOON_ZONE(name) \
+	BABOON_PROFILE_SCOPE(name); \
+	BABOON_TRACY_ZONE(name)
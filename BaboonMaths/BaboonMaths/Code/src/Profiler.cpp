@@ -0,0 +1,236 @@
+#include "BaboonMaths.h"
+#include "Profile.h"
+#include <sstream>
+#if defined(BABOON_PROFILE)
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BABOON_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BABOON_RDTSC
+#endif
+#endif
+
+namespace Baboon
+{
+#if defined(BABOON_PROFILE)
+	namespace Profiling
+	{
+		thread_local ThreadCounters* threadCounters = nullptr;
+		std::atomic<bool> timing{ false };
+
+#if defined(BABOON_RDTSC)
+		constexpr const char* TimerName = "rdtsc";
+#else
+		constexpr const char* TimerName = "nanoseconds";
+#endif
+
+		namespace
+		{
+			struct Registry
+			{
+				std::mutex mutex;
+				std::vector<std::string> names;
+				std::unordered_map<std::string, int> indices;
+				std::vector<ThreadCounters*> threads;
+				// counts of the ended threads, and the totals at the last Reset
+				uint64_t retiredCalls[MaxOperations] = {}, retiredCycles[MaxOperations] = {};
+				uint64_t baseCalls[MaxOperations] = {}, baseCycles[MaxOperations] = {};
+			};
+
+			// never destroyed, threads may still end after the static destructors ran
+			Registry& GetRegistry()
+			{
+				static Registry* registry = new Registry();
+				return *registry;
+			}
+
+			// the totals of every thread, registry locked
+			void Totals(Registry& registry, uint64_t* calls, uint64_t* cycles)
+			{
+				for (int id = 0; id < MaxOperations; id++) {
+					calls[id] = registry.retiredCalls[id];
+					cycles[id] = registry.retiredCycles[id];
+				}
+				for (ThreadCounters* counters : registry.threads) {
+					for (int id = 0; id < MaxOperations; id++) {
+						calls[id] += counters->calls[id].load(std::memory_order_relaxed);
+						cycles[id] += counters->cycles[id].load(std::memory_order_relaxed);
+					}
+				}
+			}
+
+			// hands the counts of its thread over to the registry as the thread ends
+			struct ThreadExit
+			{
+				ThreadCounters* counters = nullptr;
+
+				~ThreadExit()
+				{
+					if (!counters)
+						return;
+					Registry& registry = GetRegistry();
+					std::lock_guard<std::mutex> lock(registry.mutex);
+					for (int id = 0; id < MaxOperations; id++) {
+						registry.retiredCalls[id] += counters->calls[id].load(std::memory_order_relaxed);
+						registry.retiredCycles[id] += counters->cycles[id].load(std::memory_order_relaxed);
+					}
+					registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), counters));
+					threadCounters = nullptr;
+					delete counters;
+				}
+			};
+		}
+
+		int Register(const char* name)
+		{
+			Registry& registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			auto found = registry.indices.find(name);
+			if (found != registry.indices.end())
+				return found->second;
+
+			if ((int)registry.names.size() == MaxOperations) {
+				std::cout << "Too many profiled operations, raise Profiling::MaxOperations" << std::endl;
+				abort();
+			}
+			int id = (int)registry.names.size();
+			registry.names.push_back(name);
+			registry.indices.emplace(name, id);
+			return id;
+		}
+
+		void Count(int id)
+		{
+			Add(Counters().calls[id], 1);
+		}
+
+		ThreadCounters& AttachThread()
+		{
+			static thread_local ThreadExit threadExit;
+
+			ThreadCounters* counters = new ThreadCounters();
+			for (int id = 0; id < MaxOperations; id++) {
+				counters->calls[id].store(0, std::memory_order_relaxed);
+				counters->cycles[id].store(0, std::memory_order_relaxed);
+			}
+
+			Registry& registry = GetRegistry();
+			{
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				registry.threads.push_back(counters);
+			}
+			threadExit.counters = counters;
+			threadCounters = counters;
+			return *counters;
+		}
+
+		uint64_t Timestamp()
+		{
+#if defined(BABOON_RDTSC)
+			return __rdtsc();
+#else
+			return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+		}
+	}
+
+	bool Profiler::Enabled()
+	{
+		return true;
+	}
+
+	void Profiler::SetTiming(bool enabled)
+	{
+		Profiling::timing.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool Profiler::Timing()
+	{
+		return Profiling::timing.load(std::memory_order_relaxed);
+	}
+
+	std::vector<ProfileEntry> Profiler::Snapshot()
+	{
+		using namespace Profiling;
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+
+		std::vector<uint64_t> calls(MaxOperations), cycles(MaxOperations);
+		Totals(registry, calls.data(), cycles.data());
+
+		std::vector<ProfileEntry> entries;
+		for (int id = 0; id < (int)registry.names.size(); id++) {
+			uint64_t n = calls[id] - registry.baseCalls[id];
+			if (n)
+				entries.push_back({ registry.names[id], n, cycles[id] - registry.baseCycles[id] });
+		}
+		std::sort(entries.begin(), entries.end(), [](const ProfileEntry& a, const ProfileEntry& b) { return a.name < b.name; });
+		return entries;
+	}
+
+	void Profiler::Reset()
+	{
+		using namespace Profiling;
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		Totals(registry, registry.baseCalls, registry.baseCycles);
+	}
+#else
+	namespace Profiling
+	{
+		std::atomic<bool> timing{ false };
+		constexpr const char* TimerName = "none";
+	}
+
+	bool Profiler::Enabled()
+	{
+		return false;
+	}
+
+	void Profiler::SetTiming(bool enabled)
+	{
+		Profiling::timing.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool Profiler::Timing()
+	{
+		return Profiling::timing.load(std::memory_order_relaxed);
+	}
+
+	std::vector<ProfileEntry> Profiler::Snapshot()
+	{
+		return {};
+	}
+
+	void Profiler::Reset() {}
+#endif
+
+	std::string Profiler::ToJson(const std::vector<ProfileEntry>& entries)
+	{
+		// the names are the library's own Class::Operation, nothing to escape
+		std::ostringstream json;
+		json << "{\n\t\"enabled\": " << (Enabled() ? "true" : "false") << ",\n\t\"timer\": \"" << Profiling::TimerName
+			<< "\",\n\t\"operations\": [";
+		for (size_t i = 0; i < entries.size(); i++) {
+			json << (i ? ",\n" : "\n") << "\t\t{ \"name\": \"" << entries[i].name << "\", \"calls\": " << entries[i].calls
+				<< ", \"cycles\": " << entries[i].cycles << " }";
+		}
+		json << (entries.empty() ? "]\n}\n" : "\n\t]\n}\n");
+		return json.str();
+	}
+
+	bool Profiler::WriteJson(const std::string& path)
+	{
+		std::ofstream stream(path, std::ios::out | std::ios::trunc);
+		if (!stream)
+			return false;
+		stream << ToJson(Snapshot());
+		return (bool)stream;
+	}
+}
@@ -0,0 +1,67 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Profile.h"
+
+namespace Baboon
+{
+	Projection::Projection(float _fovY, float _aspect, float _nearPlane, float _farPlane, DepthRange _range)
+		: fovY(_fovY), aspect(_aspect), nearPlane(_nearPlane), farPlane(_farPlane), range(_range)
+	{
+		Update();
+	}
+
+	void Projection::SetFieldOfView(float _fovY)
+	{
+		fovY = _fovY;
+		Update();
+	}
+
+	void Projection::SetAspect(float _aspect)
+	{
+		aspect = _aspect;
+		Update();
+	}
+
+	void Projection::SetClipPlanes(float _nearPlane, float _farPlane)
+	{
+		nearPlane = _nearPlane;
+		farPlane = _farPlane;
+		Update();
+	}
+
+	void Projection::SetDepthRange(DepthRange _range)
+	{
+		range = _range;
+		Update();
+	}
+
+	void Projection::Update()
+	{
+		BABOON_PROFILE_SCOPE("Projection::Update");
+		matrix = farPlane == std::numeric_limits<float>::infinity()
+			? Matrix4x4::InfinitePerspective(fovY, aspect, nearPlane, range)
+			: Matrix4x4::Perspective(fovY, aspect, nearPlane, farPlane, range);
+
+		// the projection has the form
+		//   sx 0  0  0
+		//   0  sy 0  0
+		//   0  0  a  b
+		//   0  0  -1 0
+		// whose inverse needs no general 4x4 inversion, b being never 0
+		const std::array<float, 16>& m = matrix.elements;
+		float invB = 1.f / m[11];
+		inverse = Matrix4x4({
+			1.f / m[0], 0.f, 0.f, 0.f,
+			0.f, 1.f / m[5], 0.f, 0.f,
+			0.f, 0.f, 0.f, -1.f,
+			0.f, 0.f, invB, m[10] * invB
+			});
+	}
+
+	void Projection::Unproject(const Vector3* points, Vector3* result, size_t count) const
+	{
+		BABOON_ZONE("Projection::Unproject");
+		// points are at w = 1 in clip space, the kernel divides by the w the inverse gives
+		Kernels().transformPoints(inverse, points, result, count);
+	}
+}
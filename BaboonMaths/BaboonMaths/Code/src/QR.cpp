@@ -0,0 +1,156 @@
+#include "BaboonMaths.h"
+#include "Hints.h"
+#include "Profile.h"
+#include <algorithm>
+#include <cfloat>
+
+namespace Baboon
+{
+	QR::QR(const MatrixX& m) : qr(m), rDiagonal(m.cols, 0.f)
+	{
+		BABOON_ZONE("QR::QR");
+		if (BABOON_UNLIKELY(m.rows < m.cols))
+			Fail("Cannot compute the QR factorization of a matrix with more columns than rows");
+
+		int rows = qr.rows;
+		int cols = qr.cols;
+		for (int k = 0; k < cols; ++k) {
+			// norm of the k-th column below the diagonal, hypot avoids overflow on large entries
+			float norm = 0.f;
+			for (int i = k; i < rows; ++i)
+				norm = hypotf(norm, qr.At(i, k));
+
+			if (norm != 0.f) {
+				if (qr.At(k, k) < 0.f)
+					norm = -norm;
+
+				// k-th Householder vector, scaled so that its first component is 1 + |x0| / norm
+				float invNorm = 1.f / norm;
+				for (int i = k; i < rows; ++i)
+					qr.At(i, k) *= invNorm;
+				qr.At(k, k) += 1.f;
+
+				// reflects the remaining columns
+				for (int j = k + 1; j < cols; ++j) {
+					float s = 0.f;
+					for (int i = k; i < rows; ++i)
+						s += qr.At(i, k) * qr.At(i, j);
+					s = -s / qr.At(k, k);
+					for (int i = k; i < rows; ++i)
+						qr.At(i, j) += s * qr.At(i, k);
+				}
+			}
+			rDiagonal[k] = -norm;
+		}
+	}
+
+	QR::QR(const Matrix3x3& m) : QR(MatrixX(m)) {}
+
+	QR::QR(const Matrix4x4& m) : QR(MatrixX(m)) {}
+
+	bool QR::IsFullRank() const
+	{
+		float scale = 0.f;
+		for (float r : rDiagonal)
+			scale = std::max(scale, fabsf(r));
+
+		float tolerance = qr.rows * FLT_EPSILON * scale;
+		for (float r : rDiagonal) {
+			if (fabsf(r) <= tolerance)
+				return false;
+		}
+		return true;
+	}
+
+	MatrixX QR::Q() const
+	{
+		BABOON_PROFILE_SCOPE("QR::Q");
+		int rows = qr.rows;
+		int cols = qr.cols;
+		MatrixX q(rows, cols);
+
+		for (int k = cols - 1; k >= 0; --k) {
+			q.At(k, k) = 1.f;
+			for (int j = k; j < cols; ++j) {
+				if (qr.At(k, k) == 0.f)
+					continue;
+
+				float s = 0.f;
+				for (int i = k; i < rows; ++i)
+					s += qr.At(i, k) * q.At(i, j);
+				s = -s / qr.At(k, k);
+				for (int i = k; i < rows; ++i)
+					q.At(i, j) += s * qr.At(i, k);
+			}
+		}
+		return q;
+	}
+
+	MatrixX QR::R() const
+	{
+		BABOON_PROFILE_SCOPE("QR::R");
+		int cols = qr.cols;
+		MatrixX r(cols, cols);
+
+		for (int i = 0; i < cols; ++i) {
+			r.At(i, i) = rDiagonal[i];
+			for (int j = i + 1; j < cols; ++j)
+				r.At(i, j) = qr.At(i, j);
+		}
+		return r;
+	}
+
+	MatrixX QR::Solve(const MatrixX& b) const
+	{
+		BABOON_ZONE("QR::Solve");
+		if (BABOON_UNLIKELY(b.rows != qr.rows))
+			Fail("Cannot solve a system with a right-hand side of a different size");
+
+		int rows = qr.rows;
+		int cols = qr.cols;
+		int nrhs = b.cols;
+		MatrixX solution(cols, nrhs);
+		if (!IsFullRank())
+			return solution;
+
+		// computes transpose(Q) * b
+		MatrixX x = b;
+		for (int k = 0; k < cols; ++k) {
+			for (int j = 0; j < nrhs; ++j) {
+				float s = 0.f;
+				for (int i = k; i < rows; ++i)
+					s += qr.At(i, k) * x.At(i, j);
+				s = -s / qr.At(k, k);
+				for (int i = k; i < rows; ++i)
+					x.At(i, j) += s * qr.At(i, k);
+			}
+		}
+
+		// solves R * solution = transpose(Q) * b
+		for (int k = cols - 1; k >= 0; --k) {
+			for (int j = 0; j < nrhs; ++j)
+				x.At(k, j) /= rDiagonal[k];
+			for (int i = 0; i < k; ++i) {
+				for (int j = 0; j < nrhs; ++j)
+					x.At(i, j) -= x.At(k, j) * qr.At(i, k);
+			}
+		}
+
+		std::copy(x.elements.begin(), x.elements.begin() + (size_t)cols * nrhs, solution.elements.begin());
+		return solution;
+	}
+
+	Vector3 QR::Solve(const Vector3& b) const
+	{
+		BABOON_ZONE("QR::Solve");
+		MatrixX x = Solve(MatrixX(3, 1, { b.x, b.y, b.z }));
+		return Vector3(x.elements[0], x.elements[1], x.elements[2]);
+	}
+
+	Vector4 QR::Solve(const Vector4& b) const
+	{
+		BABOON_ZONE("QR::Solve");
+		MatrixX x = Solve(MatrixX(4, 1, { b.x, b.y, b.z, b.w }));
+		return Vector4(x.elements[0], x.elements[1], x.elements[2], x.elements[3]);
+	}
+}
@@ -0,0 +1,146 @@
+#include "BaboonMaths.h"
+#include "Profile.h"
+
+namespace Baboon
+{
+	Quaternion::Quaternion() : x(0.f), y(0.f), z(0.f), w(1.f) {}
+
+	Quaternion::Quaternion(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+
+	void Quaternion::Print()
+	{
+		std::cout << "Quaternion : " << "x = " << x << ", y = " << y << ", z = " << z << ", w = " << w << std::endl;
+	}
+
+	Quaternion Quaternion::AxisAngle(const Vector3& axis, float angle)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::AxisAngle");
+		float s = sinf(angle * 0.5f);
+		return Quaternion(axis.x * s, axis.y * s, axis.z * s, cosf(angle * 0.5f));
+	}
+
+	Quaternion Quaternion::FromMatrix(const Matrix3x3& m)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::FromMatrix");
+		// takes the square root of the largest of the four diagonal combinations, which keeps the divisions accurate
+		const std::array<float, 9>& e = m.elements;
+		float trace = e[0] + e[4] + e[8];
+
+		if (trace > 0.f) {
+			float s = 0.5f / sqrtf(trace + 1.f);
+			return Quaternion((e[7] - e[5]) * s, (e[2] - e[6]) * s, (e[3] - e[1]) * s, 0.25f / s);
+		}
+		if (e[0] > e[4] && e[0] > e[8]) {
+			float s = 0.5f / sqrtf(1.f + e[0] - e[4] - e[8]);
+			return Quaternion(0.25f / s, (e[1] + e[3]) * s, (e[2] + e[6]) * s, (e[7] - e[5]) * s);
+		}
+		if (e[4] > e[8]) {
+			float s = 0.5f / sqrtf(1.f + e[4] - e[0] - e[8]);
+			return Quaternion((e[1] + e[3]) * s, 0.25f / s, (e[5] + e[7]) * s, (e[2] - e[6]) * s);
+		}
+		float s = 0.5f / sqrtf(1.f + e[8] - e[0] - e[4]);
+		return Quaternion((e[2] + e[6]) * s, (e[5] + e[7]) * s, 0.25f / s, (e[3] - e[1]) * s);
+	}
+
+	Matrix3x3 Quaternion::ToMatrix(const Quaternion& q)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::ToMatrix");
+		float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+		return Matrix3x3({
+			1.f - 2.f * (yy + zz), 2.f * (xy - wz), 2.f * (xz + wy),
+			2.f * (xy + wz), 1.f - 2.f * (xx + zz), 2.f * (yz - wx),
+			2.f * (xz - wy), 2.f * (yz + wx), 1.f - 2.f * (xx + yy)
+			});
+	}
+
+	Quaternion Quaternion::Conjugate(const Quaternion& q)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::Conjugate");
+		return Quaternion(-q.x, -q.y, -q.z, q.w);
+	}
+
+	Quaternion Quaternion::Normalize(const Quaternion& q)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::Normalize");
+		float invNorm = 1.f / sqrtf(DotProduct(q, q));
+		return Quaternion(q.x * invNorm, q.y * invNorm, q.z * invNorm, q.w * invNorm);
+	}
+
+	float Quaternion::DotProduct(const Quaternion& q1, const Quaternion& q2)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::DotProduct");
+		return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+	}
+
+	Quaternion Quaternion::Multiply(const Quaternion& q1, const Quaternion& q2)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::Multiply");
+		return Quaternion(
+			q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y,
+			q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x,
+			q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w,
+			q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z);
+	}
+
+	Vector3 Quaternion::Rotate(const Quaternion& q, const Vector3& v)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::Rotate");
+		// v + 2w (u x v) + 2 u x (u x v), cheaper than building the matrix
+		float tx = 2.f * (q.y * v.z - q.z * v.y);
+		float ty = 2.f * (q.z * v.x - q.x * v.z);
+		float tz = 2.f * (q.x * v.y - q.y * v.x);
+
+		return Vector3(
+			v.x + q.w * tx + q.y * tz - q.z * ty,
+			v.y + q.w * ty + q.z * tx - q.x * tz,
+			v.z + q.w * tz + q.x * ty - q.y * tx);
+	}
+
+	Quaternion Quaternion::Nlerp(const Quaternion& q1, const Quaternion& q2, float t)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::Nlerp");
+		float sign = DotProduct(q1, q2) < 0.f ? -1.f : 1.f;
+		float t1 = 1.f - t;
+		float t2 = t * sign;
+		return Normalize(Quaternion(q1.x * t1 + q2.x * t2, q1.y * t1 + q2.y * t2, q1.z * t1 + q2.z * t2, q1.w * t1 + q2.w * t2));
+	}
+
+	Quaternion Quaternion::Slerp(const Quaternion& q1, const Quaternion& q2, float t)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::Slerp");
+		float cosTheta = DotProduct(q1, q2);
+		float sign = cosTheta < 0.f ? -1.f : 1.f;
+		cosTheta *= sign;
+
+		// nearly parallel rotations make sin(theta) vanish, the lerp is exact enough there
+		if (cosTheta > 0.9995f)
+			return Nlerp(q1, q2, t);
+
+		float theta = acosf(cosTheta);
+		float invSin = 1.f / sinf(theta);
+		float t1 = sinf((1.f - t) * theta) * invSin;
+		float t2 = sinf(t * theta) * invSin * sign;
+		return Quaternion(q1.x * t1 + q2.x * t2, q1.y * t1 + q2.y * t2, q1.z * t1 + q2.z * t2, q1.w * t1 + q2.w * t2);
+	}
+
+	bool operator==(const Quaternion& q1, const Quaternion& q2)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::operator==");
+		return q1.x == q2.x && q1.y == q2.y && q1.z == q2.z && q1.w == q2.w;
+	}
+
+	Quaternion operator*(const Quaternion& q1, const Quaternion& q2)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::operator*");
+		return Quaternion::Multiply(q1, q2);
+	}
+
+	Vector3 operator*(const Quaternion& q, const Vector3& v)
+	{
+		BABOON_PROFILE_SCOPE("Quaternion::operator*");
+		return Quaternion::Rotate(q, v);
+	}
+}
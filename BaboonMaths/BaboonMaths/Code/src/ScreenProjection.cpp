@@ -0,0 +1,50 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Lanes.h"
+#include "Profile.h"
+#include <algorithm>
+#include <thread>
+
+namespace Baboon
+{
+	using namespace Lanes;
+
+	static_assert(sizeof(Vector3) == 3 * sizeof(float) && sizeof(Vector2) == 2 * sizeof(float),
+		"the points are loaded as packed floats");
+
+	namespace
+	{
+		// below this many points per thread, starting threads costs more than it saves
+		constexpr size_t PointsPerThread = 16384;
+	}
+
+	void ScreenProjection::Project(const Matrix4x4& viewProjection, const Viewport& viewport, const Vector3* points, Vector2* screen,
+		uint8_t* clipFlags, size_t count, DepthRange range, int threadCount)
+	{
+		BABOON_ZONE("ScreenProjection::Project");
+		auto project = Kernels().projectToScreen;
+
+		if (threadCount <= 0)
+			threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+		threadCount = (int)std::max<size_t>(1, std::min<size_t>(threadCount, count / PointsPerThread));
+
+		// every thread gets whole packs of any level
+		size_t packs = count / BatchAlignment;
+		std::vector<std::thread> workers;
+		workers.reserve(threadCount - 1);
+		size_t first = 0;
+		for (int t = 0; t < threadCount; t++)
+		{
+			size_t end = t + 1 == threadCount ? count : first + (packs / threadCount + (t < (int)(packs % threadCount) ? 1 : 0)) * BatchAlignment;
+			uint8_t* flags = clipFlags ? clipFlags + first : nullptr;
+			if (t + 1 == threadCount)
+				project(viewProjection, viewport, range, points + first, screen + first, flags, end - first);
+			else
+				workers.emplace_back(project, std::cref(viewProjection), std::cref(viewport), range, points + first, screen + first, flags, end - first);
+			first = end;
+		}
+
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+}
@@ -0,0 +1,64 @@
+#include "BaboonMaths.h"
+#include "Dispatch.h"
+#include "Lanes.h"
+#include "Profile.h"
+#include <algorithm>
+#include <thread>
+
+namespace Baboon
+{
+	using namespace Lanes;
+
+	static_assert(sizeof(Matrix4x4) == 16 * sizeof(float) && sizeof(DualQuaternion) == 8 * sizeof(float),
+		"the palettes are gathered from as plain floats");
+
+	namespace
+	{
+		// below this many vertices per thread, starting threads costs more than it saves
+		constexpr int VerticesPerThread = 4096;
+
+		// splits the mesh in chunks of whole packs of any level, each thread runs kernel on a [first, end) range
+		template <class Kernel>
+		void RunChunks(int vertexCount, int threadCount, Kernel kernel)
+		{
+			if (threadCount <= 0)
+				threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+			threadCount = std::max(1, std::min(threadCount, vertexCount / VerticesPerThread));
+
+			int packs = vertexCount / BatchAlignment;
+			std::vector<std::thread> workers;
+			workers.reserve(threadCount - 1);
+			int begin = 0;
+			for (int t = 0; t < threadCount; t++)
+			{
+				int end = t + 1 == threadCount ? vertexCount : begin + (packs / threadCount + (t < packs % threadCount ? 1 : 0)) * BatchAlignment;
+				if (t + 1 == threadCount)
+					kernel(begin, end);
+				else
+					workers.emplace_back(kernel, begin, end);
+				begin = end;
+			}
+
+			for (std::thread& worker : workers)
+				worker.join();
+		}
+	}
+
+	void Skinning::LinearBlend(const SkinStreams& mesh, const Matrix4x4* palette, Vector3* positions, Vector3* normals, int threadCount)
+	{
+		BABOON_ZONE("Skinning::LinearBlend");
+		auto blend = Kernels().linearBlend;
+		RunChunks(mesh.vertexCount, threadCount, [&](int first, int end) {
+			blend(mesh, palette, positions, normals, first, end);
+		});
+	}
+
+	void Skinning::DualQuaternionBlend(const SkinStreams& mesh, const DualQuaternion* palette, Vector3* positions, Vector3* normals, int threadCount)
+	{
+		BABOON_ZONE("Skinning::DualQuaternionBlend");
+		auto blend = Kernels().dualQuaternionBlend;
+		RunChunks(mesh.vertexCount, threadCount, [&](int first, int end) {
+			blend(mesh, palette, positions, normals, first, end);
+		});
+	}
+}
\ No newline at end of file
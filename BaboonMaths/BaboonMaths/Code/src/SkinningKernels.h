@@ -0,0 +1,195 @@
+#pragma once
+#include "Lanes.h"
+
+namespace Baboon::BABOON_LANES_NAMESPACE
+{
+	namespace
+	{
+		using namespace Lanes;
+
+		constexpr int Influences = 4;
+
+		// offsets of the lanes' x components in a Vector3 stream and of their first weight in the weight stream
+		template <int N>
+		struct StreamOffsets
+		{
+			int vector[N];
+			int weight[N];
+
+			constexpr StreamOffsets() : vector(), weight()
+			{
+				for (int j = 0; j < N; j++) {
+					vector[j] = 3 * j;
+					weight[j] = Influences * j;
+				}
+			}
+		};
+
+		template <class P>
+		void StoreVector3(const P& x, const P& y, const P& z, Vector3* out)
+		{
+			constexpr int n = LaneCount<P>();
+			float xs[n], ys[n], zs[n];
+			Store(xs, x);
+			Store(ys, y);
+			Store(zs, z);
+			for (int j = 0; j < n; j++)
+			{
+				out[j].x = xs[j];
+				out[j].y = ys[j];
+				out[j].z = zs[j];
+			}
+		}
+
+		template <class P>
+		void NormalizeLanes(P& x, P& y, P& z)
+		{
+			P invLength = Broadcast<P>(1.f) / Sqrt(Max(x * x + y * y + z * z, Broadcast<P>(1e-30f)));
+			x = x * invLength;
+			y = y * invLength;
+			z = z * invLength;
+		}
+
+		// skins the n vertices from first, n being the lane count of P
+		template <class P>
+		void LinearBlendLanes(const SkinStreams& mesh, const float* palette, Vector3* positions, Vector3* normals, int first)
+		{
+			constexpr int n = LaneCount<P>();
+			static constexpr StreamOffsets<n> streams{};
+
+			// blends the 3 x 4 upper part of the bone matrices, the last row is always 0 0 0 1
+			P m[12];
+			for (int e = 0; e < 12; e++)
+				m[e] = Broadcast<P>(0.f);
+
+			const float* weights = mesh.boneWeights + (size_t)first * Influences;
+			for (int k = 0; k < Influences; k++)
+			{
+				int bones[n];
+				for (int j = 0; j < n; j++)
+					bones[j] = 16 * mesh.boneIndices[(size_t)(first + j) * Influences + k];
+
+				P w = GatherAs<P>(weights + k, streams.weight);
+				for (int e = 0; e < 12; e++)
+					m[e] = m[e] + w * GatherAs<P>(palette + e, bones);
+			}
+
+			const float* p = reinterpret_cast<const float*>(mesh.positions + first);
+			P x = GatherAs<P>(p, streams.vector), y = GatherAs<P>(p + 1, streams.vector), z = GatherAs<P>(p + 2, streams.vector);
+			StoreVector3<P>(m[0] * x + m[1] * y + m[2] * z + m[3], m[4] * x + m[5] * y + m[6] * z + m[7],
+				m[8] * x + m[9] * y + m[10] * z + m[11], positions + first);
+
+			if (mesh.normals && normals)
+			{
+				const float* v = reinterpret_cast<const float*>(mesh.normals + first);
+				x = GatherAs<P>(v, streams.vector);
+				y = GatherAs<P>(v + 1, streams.vector);
+				z = GatherAs<P>(v + 2, streams.vector);
+				P nx = m[0] * x + m[1] * y + m[2] * z;
+				P ny = m[4] * x + m[5] * y + m[6] * z;
+				P nz = m[8] * x + m[9] * y + m[10] * z;
+				NormalizeLanes(nx, ny, nz);
+				StoreVector3(nx, ny, nz, normals + first);
+			}
+		}
+
+		template <class P>
+		void DualQuaternionBlendLanes(const SkinStreams& mesh, const float* palette, Vector3* positions, Vector3* normals, int first)
+		{
+			constexpr int n = LaneCount<P>();
+			static constexpr StreamOffsets<n> streams{};
+
+			P r[4], d[4], pivot[4];
+			const float* weights = mesh.boneWeights + (size_t)first * Influences;
+			for (int k = 0; k < Influences; k++)
+			{
+				int bones[n];
+				for (int j = 0; j < n; j++)
+					bones[j] = 8 * mesh.boneIndices[(size_t)(first + j) * Influences + k];
+
+				P w = GatherAs<P>(weights + k, streams.weight);
+				P rk[4], dk[4];
+				for (int c = 0; c < 4; c++) {
+					rk[c] = GatherAs<P>(palette + c, bones);
+					dk[c] = GatherAs<P>(palette + 4 + c, bones);
+				}
+
+				if (k == 0) {
+					for (int c = 0; c < 4; c++) {
+						pivot[c] = rk[c];
+						r[c] = w * rk[c];
+						d[c] = w * dk[c];
+					}
+					continue;
+				}
+
+				// q and -q are the same rotation, blends every bone in the first one's hemisphere
+				P dot = rk[0] * pivot[0] + rk[1] * pivot[1] + rk[2] * pivot[2] + rk[3] * pivot[3];
+				w = Select(Less(dot, Broadcast<P>(0.f)), -w, w);
+				for (int c = 0; c < 4; c++) {
+					r[c] = r[c] + w * rk[c];
+					d[c] = d[c] + w * dk[c];
+				}
+			}
+
+			P invLength = Broadcast<P>(1.f) / Sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]);
+			for (int c = 0; c < 4; c++) {
+				r[c] = r[c] * invLength;
+				d[c] = d[c] * invLength;
+			}
+
+			P two = Broadcast<P>(2.f);
+			P tx = two * (r[3] * d[0] - d[3] * r[0] + r[1] * d[2] - r[2] * d[1]);
+			P ty = two * (r[3] * d[1] - d[3] * r[1] + r[2] * d[0] - r[0] * d[2]);
+			P tz = two * (r[3] * d[2] - d[3] * r[2] + r[0] * d[1] - r[1] * d[0]);
+
+			// v + 2w (u x v) + 2 u x (u x v), as in Quaternion::Rotate
+			auto rotate = [&](P& x, P& y, P& z) {
+				P cx = two * (r[1] * z - r[2] * y);
+				P cy = two * (r[2] * x - r[0] * z);
+				P cz = two * (r[0] * y - r[1] * x);
+				P rx = x + r[3] * cx + r[1] * cz - r[2] * cy;
+				P ry = y + r[3] * cy + r[2] * cx - r[0] * cz;
+				P rz = z + r[3] * cz + r[0] * cy - r[1] * cx;
+				x = rx;
+				y = ry;
+				z = rz;
+			};
+
+			const float* p = reinterpret_cast<const float*>(mesh.positions + first);
+			P x = GatherAs<P>(p, streams.vector), y = GatherAs<P>(p + 1, streams.vector), z = GatherAs<P>(p + 2, streams.vector);
+			rotate(x, y, z);
+			StoreVector3(x + tx, y + ty, z + tz, positions + first);
+
+			if (mesh.normals && normals)
+			{
+				const float* v = reinterpret_cast<const float*>(mesh.normals + first);
+				x = GatherAs<P>(v, streams.vector);
+				y = GatherAs<P>(v + 1, streams.vector);
+				z = GatherAs<P>(v + 2, streams.vector);
+				rotate(x, y, z);
+				StoreVector3(x, y, z, normals + first);
+			}
+		}
+
+		void LinearBlendRange(const SkinStreams& mesh, const Matrix4x4* palette, Vector3* positions, Vector3* normals, int first, int end)
+		{
+			const float* bones = palette[0].elements.data();
+			int i = first;
+			for (; i + Width <= end; i += Width)
+				LinearBlendLanes<Pack>(mesh, bones, positions, normals, i);
+			for (; i < end; i++)
+				LinearBlendLanes<float>(mesh, bones, positions, normals, i);
+		}
+
+		void DualQuaternionBlendRange(const SkinStreams& mesh, const DualQuaternion* palette, Vector3* positions, Vector3* normals, int first, int end)
+		{
+			const float* bones = &palette[0].real.x;
+			int i = first;
+			for (; i + Width <= end; i += Width)
+				DualQuaternionBlendLanes<Pack>(mesh, bones, positions, normals, i);
+			for (; i < end; i++)
+				DualQuaternionBlendLanes<float>(mesh, bones, positions, normals, i);
+		}
+	}
+}
@@ -0,0 +1,118 @@
+#include "BaboonMaths.h"
+#include "Hints.h"
+
+namespace Baboon
+{
+	TransformBuffer::Snapshot::Snapshot() : transforms(nullptr), count(0), frame(0), readers(nullptr) {}
+
+	TransformBuffer::Snapshot::Snapshot(Snapshot&& other) noexcept
+		: transforms(other.transforms), count(other.count), frame(other.frame), readers(other.readers)
+	{
+		other.transforms = nullptr;
+		other.count = 0;
+		other.readers = nullptr;
+	}
+
+	TransformBuffer::Snapshot& TransformBuffer::Snapshot::operator=(Snapshot&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Release();
+			transforms = other.transforms;
+			count = other.count;
+			frame = other.frame;
+			readers = other.readers;
+			other.transforms = nullptr;
+			other.count = 0;
+			other.readers = nullptr;
+		}
+		return *this;
+	}
+
+	TransformBuffer::Snapshot::~Snapshot()
+	{
+		Release();
+	}
+
+	void TransformBuffer::Snapshot::Release()
+	{
+		if (readers)
+			readers->fetch_sub(1);
+
+		readers = nullptr;
+		transforms = nullptr;
+		count = 0;
+	}
+
+	TransformBuffer::TransformBuffer(int _capacity, int maxReaders)
+		: capacity(_capacity), slots(maxReaders + 2), latest(-1), writing(-1), frameCount(0)
+	{
+		if (BABOON_UNLIKELY(_capacity < 0 || maxReaders < 1))
+			Fail("Cannot create a transform buffer with a negative capacity or no reader");
+
+		for (Slot& slot : slots)
+			slot.transforms.resize(_capacity);
+	}
+
+	int TransformBuffer::Capacity() const
+	{
+		return capacity;
+	}
+
+	Matrix4x4* TransformBuffer::BeginFrame()
+	{
+		// any slot that is neither the latest frame nor pinned by a reader is free : readers only ever pin the latest
+		// slot, and they check it is still the latest after pinning it, so nobody can start reading it from now on
+		int current = latest.load();
+		for (int i = 0; i < (int)slots.size(); i++)
+		{
+			if (i != current && slots[i].readers.load() == 0)
+			{
+				writing = i;
+				return slots[i].transforms.data();
+			}
+		}
+
+		writing = -1;
+		return nullptr;
+	}
+
+	void TransformBuffer::Publish(int count)
+	{
+		if (BABOON_UNLIKELY(writing < 0 || count < 0 || count > capacity)) {
+			Warn("Cannot publish a frame that was not begun");
+			return;
+		}
+
+		Slot& slot = slots[writing];
+		slot.count = count;
+		slot.frame = ++frameCount;
+		latest.store(writing);
+		writing = -1;
+	}
+
+	TransformBuffer::Snapshot TransformBuffer::AcquireLatest()
+	{
+		Snapshot snapshot;
+
+		for (;;)
+		{
+			int current = latest.load();
+			if (current < 0)
+				return snapshot;
+
+			// pin, then make sure the slot is still the latest one, otherwise the writer may already be refilling it
+			Slot& slot = slots[current];
+			slot.readers.fetch_add(1);
+			if (latest.load() == current)
+			{
+				snapshot.transforms = slot.transforms.data();
+				snapshot.count = slot.count;
+				snapshot.frame = slot.frame;
+				snapshot.readers = &slot.readers;
+				return snapshot;
+			}
+			slot.readers.fetch_sub(1);
+		}
+	}
+}
@@ -1,13 +1,9 @@
 #include "BaboonMaths.h"
+#include "Hints.h"
+#include "Profile.h"
 
 namespace Baboon
 {
-	Vector2::Vector2() : x(0.f), y(0.f) {}
-
-	Vector2::Vector2(float _x, float _y) : x(_x), y(_y) {}
-
-	Vector2::Vector2(float coords) : x(coords), y(coords) {}
-
 	void Vector2::Print()
 	{
 		std::cout << "Vector2 : " << "x = " << x << ", y = " << y << std::endl;
@@ -20,33 +16,37 @@ namespace Baboon
 
 	void Vector2::Opposite()
 	{
+		BABOON_PROFILE_SCOPE("Vector2::Opposite");
 		x *= -1.f;
 		y *= -1.f;
 	}
 
 	void Vector2::Invert()
 	{
+		BABOON_PROFILE_SCOPE("Vector2::Invert");
 		x = 1 / x;
 		y = 1 / y;
 	}
 
 	void Vector2::AddNumber(float number)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::AddNumber");
 		x += number;
 		y += number;
 	}
 
 	void Vector2::MultiplyNumber(float number)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::MultiplyNumber");
 		x *= number;
 		y *= number;
 	}
 
 	float Vector2::operator[](int index)
 	{
-		if (index < 0 || index > 1)
+		if (BABOON_UNLIKELY(index < 0 || index > 1))
 		{
-			std::cout << "Error : overflow" << std::endl;
+			Warn("Error : overflow");
 			return NULL;
 		}
 
@@ -58,6 +58,7 @@ namespace Baboon
 
 	Vector2 Vector2::Add(Vector2 v1, Vector2 v2)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::Add");
 		Vector2 v;
 
 		v.x = v1.x + v2.x;
@@ -68,6 +69,7 @@ namespace Baboon
 
 	Vector2 Vector2::Multiply(Vector2 v1, Vector2 v2)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::Multiply");
 		Vector2 v;
 
 		v.x = v1.x * v2.x;
@@ -78,6 +80,7 @@ namespace Baboon
 
 	Vector2 Vector2::MidPoint(Vector2 v1, Vector2 v2)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::MidPoint");
 		Vector2 v3;
 
 		v3.x = (v1.x + v2.x) / 2;
@@ -88,6 +91,7 @@ namespace Baboon
 
 	float Vector2::Distance(Vector2 p1, Vector2 p2)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::Distance");
 		float xSquared = powf(p1.x - p2.x, 2.f);
 		float ySquared = powf(p1.y - p2.y, 2.f);
 		float dist = sqrtf(xSquared + ySquared);
@@ -97,6 +101,7 @@ namespace Baboon
 
 	float Vector2::SquaredNorm(Vector2 v)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::SquaredNorm");
 		float xSquared = powf(v.x, 2.f);
 		float ySquared = powf(v.y, 2.f);
 		float squaredNorm = xSquared + ySquared;
@@ -106,6 +111,7 @@ namespace Baboon
 
 	float Vector2::Norm(Vector2 v)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::Norm");
 		float norm = sqrtf(Vector2::SquaredNorm(v));
 
 		return norm;
@@ -113,6 +119,7 @@ namespace Baboon
 
 	Vector2 Vector2::Normalize(Vector2 v)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::Normalize");
 		float norm = Vector2::Norm(v);
 
 		return { v.x / norm, v.y / norm };
@@ -120,6 +127,7 @@ namespace Baboon
 
 	float Vector2::DotProduct(Vector2 v1, Vector2 v2)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::DotProduct");
 		float dotProduct = (v1.x * v2.x) + (v1.y * v2.y);
 
 		return dotProduct;
@@ -127,6 +135,7 @@ namespace Baboon
 
 	float Vector2::CrossProduct(Vector2 v1, Vector2 v2)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::CrossProduct");
 		float crossProduct = (v1.x * v2.y) - (v2.x * v1.y);
 
 		return crossProduct;
@@ -134,6 +143,7 @@ namespace Baboon
 
 	float Vector2::GetAngle(Vector2 v1, Vector2 v2)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::GetAngle");
 		float dotProduct = Vector2::DotProduct(v1, v2);
 		float v1Norm = Vector2::Norm(v1);
 		float v2Norm = Vector2::Norm(v2);
@@ -148,6 +158,7 @@ namespace Baboon
 
 	Vector2 Vector2::Rotate(Vector2 p, float theta, Vector2 anchor)
 	{
+		BABOON_PROFILE_SCOPE("Vector2::Rotate");
 		Vector2 pTemp = p - anchor;
 
 		float x = (pTemp.x * cosf(theta)) - (pTemp.y * sinf(theta));
@@ -158,163 +169,4 @@ namespace Baboon
 
 		return vectorRotated;
 	}
-
-	bool operator==(const Vector2& v1, const Vector2& v2)
-	{
-		return v1.x == v2.x && v1.y == v2.y;
-	}
-
-	Vector2 operator+(const Vector2& v, const float& f)
-	{
-		Vector2 vR = v;
-
-		vR.AddNumber(f);
-
-		return vR;
-	}
-
-	Vector2 operator+(const float& f, const Vector2& v)
-	{
-		Vector2 vR = v;
-
-		vR.AddNumber(f);
-
-		return vR;
-	}
-
-	Vector2 operator-(const Vector2& v, const float& f)
-	{
-		Vector2 vR = v;
-
-		vR.AddNumber(-f);
-
-		return vR;
-	}
-
-	Vector2 operator*(const Vector2& v, const float& f)
-	{
-		Vector2 vR = v;
-
-		vR.MultiplyNumber(f);
-
-		return vR;
-	}
-
-	Vector2 operator*(const float& f, const Vector2& v)
-	{
-		Vector2 vR = v;
-
-		vR.MultiplyNumber(f);
-
-		return vR;
-	}
-
-	Vector2 operator/(const Vector2& v, const float& f)
-	{
-		Vector2 vR = v;
-
-		vR.MultiplyNumber(1.f / f);
-
-		return vR;
-	}
-
-	Vector2 operator+(const Vector2& v1, const Vector2& v2)
-	{
-		Vector2 v;
-
-		v = Vector2::Add(v1, v2);
-
-		return v;
-	}
-
-	Vector2 operator-(const Vector2& v1, const Vector2& v2)
-	{
-		Vector2 v;
-		Vector2 v3 = v2;
-
-		v3.Opposite();
-		v = Vector2::Add(v1, v3);
-
-		return v;
-	}
-
-	Vector2 operator*(const Vector2& v1, const Vector2& v2)
-	{
-		Vector2 v;
-
-		v = Vector2::Multiply(v1, v2);
-
-		return v;
-	}
-
-	Vector2 operator/(const Vector2& v1, const Vector2& v2)
-	{
-		Vector2 v;
-		Vector2 v3 = v2;
-
-		v3.Invert();
-		v = Vector2::Multiply(v1, v3);
-
-		return v;
-	}
-
-	Vector2 operator+=(Vector2& v, float& f)
-	{
-		v.AddNumber(f);
-
-		return v;
-	}
-
-	Vector2 operator-=(Vector2& v, float& f)
-	{
-		v.AddNumber(-f);
-
-		return v;
-	}
-
-	Vector2 operator*=(Vector2& v, float& f)
-	{
-		v.MultiplyNumber(f);
-
-		return v;
-	}
-
-	Vector2 operator/=(Vector2& v, float& f)
-	{
-		v.MultiplyNumber(1.f / f);
-
-		return v;
-	}
-
-	Vector2& operator+=(Vector2& v1, Vector2& v2)
-	{
-		v1 = Vector2::Add(v1, v2);
-
-		return v1;
-	}
-
-	Vector2& operator-=(Vector2& v1, Vector2& v2)
-	{
-		v2.Opposite();
-
-		v1 = Vector2::Add(v1, v2);
-
-		return v1;
-	}
-
-	Vector2& operator*=(Vector2& v1, Vector2& v2)
-	{
-		v1 = Vector2::Multiply(v1, v2);
-
-		return v1;
-	}
-
-	Vector2& operator/=(Vector2& v1, Vector2& v2)
-	{
-		v2.Invert();
-
-		v1 = Vector2::Multiply(v1, v2);
-
-		return v1;
-	}
 }
@@ -0,0 +1,30 @@
+#!/bin/sh
+# The AVX2 and AVX-512 kernel files are built for their instruction set as a whole, MSVC's /arch does so : an inline
+# function of the library they instantiate is a weak copy in AVX the linker may keep for every caller, which then
+# faults on a machine without it. Builds both files the way /arch does, without optimisation so nothing is inlined
+# away, and fails if one defines a weak symbol outside the Lanes and kernel namespaces of its instruction set.
+# std::array's accessors are let through, they only compute addresses. Run from the project directory (BaboonMaths).
+CXX=${CXX:-g++}
+OUT=${TMPDIR:-/tmp}/BaboonKernelSymbols.$$
+failures=0
+
+check() {
+	file=$1; namespace=$2; flags=$3
+	if ! $CXX -std=c++17 -O0 $flags -ICode/include -c Code/src/$file -o $OUT.o; then
+		echo "FAILED: $file does not build"
+		failures=$((failures + 1))
+		return
+	fi
+	shared=$(nm -C --defined-only $OUT.o | awk '$2 ~ /^[WVu]$/' | cut -d' ' -f3- |
+		grep -v "^\([^ (]* \)\?Baboon::\(Lanes::\)\?$namespace::\|^std::array<.*>::\(data\|operator\[\]\)(\|^std::__array_traits<")
+	if [ -n "$shared" ]; then
+		echo "FAILED: $file shares inline functions built for its instruction set"
+		echo "$shared"
+		failures=$((failures + 1))
+	fi
+}
+
+check KernelsAVX2.cpp Avx2 "-mavx2 -mfma -mf16c -mbmi -mbmi2"
+check KernelsAVX512.cpp Avx512 "-mavx512f -mavx512cd -mavx512bw -mavx512dq -mavx512vl -mavx2 -mfma -mf16c -mbmi -mbmi2"
+rm -f $OUT.o
+exit $failures
@@ -0,0 +1,155 @@
+#include "TestCommon.h"
+#include <random>
+#include <vector>
+
+// Accuracy and throughput of Matrix3x3::SymmetricEigen, SVD and PolarDecomposition and of their Matrix3x3Batch modes,
+// on random matrices and on the degenerate ones the solvers must survive.
+using namespace Baboon;
+using namespace BaboonTests;
+
+namespace
+{
+	Matrix3x3 Diagonal(const Vector3& v)
+	{
+		return Matrix3x3({ v.x, 0.f, 0.f, 0.f, v.y, 0.f, 0.f, 0.f, v.z });
+	}
+
+	Matrix3x3 Transposed(Matrix3x3 m)
+	{
+		m.Transpose();
+		return m;
+	}
+
+	float Scale(const Matrix3x3& m)
+	{
+		float s = 0.f;
+		for (float e : m.elements)
+			s = std::max(s, fabsf(e));
+		return std::max(s, 1e-30f);
+	}
+
+	struct Errors
+	{
+		float eigen = 0.f, svd = 0.f, polar = 0.f, orthogonality = 0.f;
+		bool sorted = true, rotations = true;
+	};
+
+	// errors relative to the matrix's largest element
+	void Measure(const Matrix3x3& m, Errors& errors)
+	{
+		Matrix3x3 identity(true);
+		Matrix3x3 symmetric = m + Transposed(m);
+		Vector3 lambda;
+		Matrix3x3 eigenvectors;
+		Matrix3x3::SymmetricEigen(symmetric, lambda, eigenvectors);
+		errors.eigen = std::max(errors.eigen, MaxDifference(eigenvectors * Diagonal(lambda) * Transposed(eigenvectors), symmetric) / Scale(symmetric));
+		errors.orthogonality = std::max(errors.orthogonality, MaxDifference(eigenvectors * Transposed(eigenvectors), identity));
+		errors.sorted = errors.sorted && lambda.x >= lambda.y && lambda.y >= lambda.z;
+
+		Matrix3x3 u, v;
+		Vector3 sigma;
+		Matrix3x3::SVD(m, u, sigma, v);
+		errors.svd = std::max(errors.svd, MaxDifference(u * Diagonal(sigma) * Transposed(v), m) / Scale(m));
+		errors.orthogonality = std::max(errors.orthogonality, MaxDifference(u * Transposed(u), identity));
+		errors.orthogonality = std::max(errors.orthogonality, MaxDifference(v * Transposed(v), identity));
+		errors.rotations = errors.rotations && fabsf(u.Determinant() - 1.f) < 1e-4f && fabsf(v.Determinant() - 1.f) < 1e-4f;
+
+		Matrix3x3 rotation, stretch;
+		Matrix3x3::PolarDecomposition(m, rotation, stretch);
+		errors.polar = std::max(errors.polar, MaxDifference(rotation * stretch, m) / Scale(m));
+		errors.orthogonality = std::max(errors.orthogonality, MaxDifference(rotation * Transposed(rotation), identity));
+	}
+
+	void Report(const char* name, const Errors& errors)
+	{
+		std::printf("%-16s eigen %.1e  svd %.1e  polar %.1e  orthogonality %.1e\n", name, errors.eigen, errors.svd, errors.polar, errors.orthogonality);
+		Check(errors.eigen < 1e-5f, "eigen reconstruction");
+		Check(errors.svd < 1e-5f, "SVD reconstruction");
+		Check(errors.polar < 1e-5f, "polar reconstruction");
+		Check(errors.orthogonality < 1e-5f, "orthogonal factors");
+		Check(errors.sorted, "eigenvalues sorted by decreasing value");
+		Check(errors.rotations, "SVD factors are rotations");
+	}
+}
+
+int main()
+{
+	std::mt19937 rng(4);
+	std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+	const int count = 100000;
+
+	std::vector<Matrix3x3> matrices(count), symmetric(count);
+	Errors random;
+	for (int i = 0; i < count; i++) {
+		for (float& e : matrices[i].elements)
+			e = uniform(rng);
+		symmetric[i] = matrices[i] + Transposed(matrices[i]);
+		Measure(matrices[i], random);
+	}
+	Report("random", random);
+
+	// rank deficient, repeated and nearly repeated eigenvalues, reflections, tiny and huge scales
+	Matrix3x3 rotation, stretch;
+	Matrix3x3::PolarDecomposition(matrices[0], rotation, stretch);
+	const Matrix3x3 degenerate[] = {
+		Matrix3x3(),
+		Matrix3x3(true),
+		Matrix3x3({ 1.f, 2.f, 3.f, 2.f, 4.f, 6.f, 1.f, 1.f, 1.f }),
+		Matrix3x3({ 1.f, 2.f, 3.f, 2.f, 4.f, 6.f, 3.f, 6.f, 9.f }),
+		Matrix3x3({ 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, -1.f }),
+		rotation * Diagonal(Vector3(1.f, 1.f, 2.f)) * Transposed(rotation),
+		rotation * Diagonal(Vector3(1.f, 1.f + 1e-6f, 2.f)) * Transposed(rotation),
+		rotation * Diagonal(Vector3(1.f, 1e-7f, 0.f)),
+		Diagonal(Vector3(1e-20f, 2e-20f, 3e-20f)),
+		Diagonal(Vector3(1e15f, -1e15f, 1.f)),
+	};
+	Errors degenerateErrors;
+	for (const Matrix3x3& m : degenerate)
+		Measure(m, degenerateErrors);
+	Report("degenerate", degenerateErrors);
+
+	// the batch modes must match the scalar accuracy
+	Matrix3x3Batch batch(matrices.data(), count), symmetricBatch(symmetric.data(), count), a, b, c;
+	std::vector<Vector3> values(count);
+	Errors batchErrors;
+	Matrix3x3Batch::SymmetricEigen(symmetricBatch, values.data(), a);
+	for (int i = 0; i < count; i++) {
+		batchErrors.eigen = std::max(batchErrors.eigen, MaxDifference(a.Get(i) * Diagonal(values[i]) * Transposed(a.Get(i)), symmetric[i]) / Scale(symmetric[i]));
+		batchErrors.orthogonality = std::max(batchErrors.orthogonality, MaxDifference(a.Get(i) * Transposed(a.Get(i)), Matrix3x3(true)));
+		batchErrors.sorted = batchErrors.sorted && values[i].x >= values[i].y && values[i].y >= values[i].z;
+	}
+	Matrix3x3Batch::SVD(batch, a, values.data(), b);
+	for (int i = 0; i < count; i++)
+		batchErrors.svd = std::max(batchErrors.svd, MaxDifference(a.Get(i) * Diagonal(values[i]) * Transposed(b.Get(i)), matrices[i]) / Scale(matrices[i]));
+	Matrix3x3Batch::PolarDecomposition(batch, a, c);
+	for (int i = 0; i < count; i++) {
+		batchErrors.polar = std::max(batchErrors.polar, MaxDifference(a.Get(i) * c.Get(i), matrices[i]) / Scale(matrices[i]));
+		batchErrors.orthogonality = std::max(batchErrors.orthogonality, MaxDifference(a.Get(i) * Transposed(a.Get(i)), Matrix3x3(true)));
+	}
+	Report("batch", batchErrors);
+
+	// throughput, ns per matrix
+	volatile float sink = 0.f;
+	double eigen = NanosecondsPerItem(count, 3, [&] {
+		for (int i = 0; i < count; i++) {
+			Vector3 lambda;
+			Matrix3x3 vectors;
+			Matrix3x3::SymmetricEigen(symmetric[i], lambda, vectors);
+			sink = sink + lambda.x;
+		}
+	});
+	double polar = NanosecondsPerItem(count, 3, [&] {
+		for (int i = 0; i < count; i++) {
+			Matrix3x3 r, s;
+			Matrix3x3::PolarDecomposition(matrices[i], r, s);
+			sink = sink + r.elements[0];
+		}
+	});
+	double batchEigen = NanosecondsPerItem(count, 3, [&] { Matrix3x3Batch::SymmetricEigen(symmetricBatch, values.data(), a); });
+	double batchSvd = NanosecondsPerItem(count, 3, [&] { Matrix3x3Batch::SVD(batch, a, values.data(), b); });
+	double batchPolar = NanosecondsPerItem(count, 3, [&] { Matrix3x3Batch::PolarDecomposition(batch, a, c); });
+	std::printf("ns per matrix (%s) : eigen %.1f  polar %.1f | batch eigen %.1f  svd %.1f  polar %.1f\n", Cpu::Name(Cpu::Active()),
+		eigen, polar, batchEigen, batchSvd, batchPolar);
+
+	return failures;
+}
@@ -0,0 +1,164 @@
+#include "TestCommon.h"
+#include <climits>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Fixed16 and Fixed32 arithmetic and functions against double, the bits they must give on every compiler and SIMD
+// level, and the time of rotating vectors in fixed point against the float Matrix3x3 * Vector3 loop.
+using namespace Baboon;
+using namespace BaboonTests;
+
+namespace
+{
+	// Q32.32 products and quotients of random and edge operands, hashed. The value is the one of the __int128 path,
+	// a compiler without it (MSVC) checks the portable 128 bit path against it.
+	uint64_t HashFixed32()
+	{
+		std::mt19937_64 rng(5);
+		uint64_t h = 0;
+		for (int i = 0; i < 2000000; i++) {
+			int64_t a = (int64_t)rng(), b = (int64_t)rng();
+			a >>= rng() % 60;
+			b >>= rng() % 60;
+			if (b == 0)
+				continue;
+			h = h * 1000003 ^ (uint64_t)Fixed32::Multiply(a, b);
+			h = h * 1000003 ^ (uint64_t)Fixed32::Divide(a, b);
+		}
+		const int64_t edges[] = { INT64_MIN, INT64_MAX, -1, 1, 0, 1LL << 32, -(1LL << 32) };
+		for (int64_t a : edges) {
+			for (int64_t b : edges) {
+				h = h * 31 ^ (uint64_t)Fixed32::Multiply(a, b);
+				if (b != 0 && !(a == INT64_MIN && b == -1))
+					h = h * 31 ^ (uint64_t)Fixed32::Divide(a, b);
+			}
+		}
+		return h;
+	}
+}
+
+int main()
+{
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> uniform(-100., 100.);
+
+	// products and quotients against double on the same operands, within the range of Fixed16
+	double multiply16 = 0., multiply32 = 0., divide16 = 0., divide32 = 0.;
+	for (int i = 0; i < 100000; i++) {
+		double a = uniform(rng), b = uniform(rng);
+		if (fabs(b) < 0.1)
+			continue;
+		Fixed16 fa = Fixed16::FromDouble(a), fb = Fixed16::FromDouble(b);
+		Fixed32 ga = Fixed32::FromDouble(a), gb = Fixed32::FromDouble(b);
+		if (fabs(a * b) < 30000.)
+			multiply16 = std::max(multiply16, fabs((fa * fb).ToDouble() - fa.ToDouble() * fb.ToDouble()));
+		if (fabs(a / b) < 30000.)
+			divide16 = std::max(divide16, fabs((fa / fb).ToDouble() - fa.ToDouble() / fb.ToDouble()));
+		multiply32 = std::max(multiply32, fabs((ga * gb).ToDouble() - ga.ToDouble() * gb.ToDouble()));
+		divide32 = std::max(divide32, fabs((ga / gb).ToDouble() - ga.ToDouble() / gb.ToDouble()));
+	}
+	std::printf("largest error, Q16.16 | Q32.32 : multiply %.1e | %.1e  divide %.1e | %.1e\n", multiply16, multiply32, divide16, divide32);
+	Check(multiply16 <= 1. / 65536. && divide16 <= 1. / 65536., "Q16.16 products and quotients within a step");
+	Check(multiply32 <= 1e-9 && divide32 <= 1e-9, "Q32.32 products and quotients within a step");
+
+	double sin16 = 0., sin32 = 0., cos16 = 0., cos32 = 0., sqrt16 = 0., sqrt32 = 0.;
+	for (int i = 0; i < 200000; i++) {
+		double a = uniform(rng) * 3.;
+		Fixed16 f = Fixed16::FromDouble(a), fx = Fixed16::FromDouble(fabs(a));
+		Fixed32 g = Fixed32::FromDouble(a), gx = Fixed32::FromDouble(fabs(a));
+		sin16 = std::max(sin16, fabs(Sin(f).ToDouble() - sin(f.ToDouble())));
+		sin32 = std::max(sin32, fabs(Sin(g).ToDouble() - sin(g.ToDouble())));
+		cos16 = std::max(cos16, fabs(Cos(f).ToDouble() - cos(f.ToDouble())));
+		cos32 = std::max(cos32, fabs(Cos(g).ToDouble() - cos(g.ToDouble())));
+		sqrt16 = std::max(sqrt16, fabs(Sqrt(fx).ToDouble() - sqrt(fx.ToDouble())));
+		sqrt32 = std::max(sqrt32, fabs(Sqrt(gx).ToDouble() - sqrt(gx.ToDouble())));
+	}
+	std::printf("largest error, Q16.16 | Q32.32 : sin %.1e | %.1e  cos %.1e | %.1e  sqrt %.1e | %.1e\n", sin16, sin32, cos16, cos32, sqrt16, sqrt32);
+	Check(sin16 < 2e-5 && cos16 < 2e-5 && sqrt16 <= 1. / 65536., "Q16.16 functions within a step");
+	Check(sin32 < 3e-8 && cos32 < 3e-8 && sqrt32 < 1e-9, "Q32.32 functions within the table's error");
+
+	FixedVector2<Fixed16> quarter = FixedVector2<Fixed16>::Rotate(FixedVector2<Fixed16>(Fixed16(1), Fixed16(0)), Fixed16::FromFloat(PI / 2.f));
+	Check(fabsf(quarter.x.ToFloat()) < 1e-4f && fabsf(quarter.y.ToFloat() - 1.f) < 1e-4f, "quarter turn of (1, 0)");
+	Check(FixedVector3<Fixed16>::Norm(FixedVector3<Fixed16>(Fixed16(3), Fixed16(4), Fixed16(12))) == Fixed16(13), "exact norm of (3, 4, 12)");
+
+	uint64_t hash = HashFixed32();
+	std::printf("Q32.32 product and quotient hash %016llx\n", (unsigned long long)hash);
+	Check(hash == 0xf063d6ffc57d8ff7ULL, "Q32.32 products and quotients give the reference bits");
+
+	// every SIMD level gives the bits of the scalar operators
+	const int count = 1 << 20;
+	std::vector<Vector3> floats(count), floatResult(count);
+	std::vector<FixedVector3<Fixed16>> vectors(count), expected(count), result(count);
+	for (int i = 0; i < count; i++) {
+		floats[i] = Vector3((float)uniform(rng), (float)uniform(rng), (float)uniform(rng));
+		vectors[i] = FixedVector3<Fixed16>::FromVector(floats[i]);
+	}
+	FixedMatrix3x3<Fixed16> rotation = FixedMatrix3x3<Fixed16>::Rotation(Fixed16::FromFloat(0.3f), Fixed16::FromFloat(1.1f), Fixed16::FromFloat(-2.f));
+	for (int i = 0; i < count; i++)
+		expected[i] = rotation * vectors[i];
+	Matrix3x3 floatRotation = rotation.ToMatrix();
+
+	std::vector<float> raw(count * 3), back(count * 3);
+	std::vector<Fixed16> fixed(count * 3), fixedExpected(count * 3);
+	for (int i = 0; i < count * 3; i++) {
+		raw[i] = (float)uniform(rng);
+		fixedExpected[i] = Fixed16::FromFloat(raw[i]);
+	}
+
+	// out of range values saturate and NaN gives 0, in the SIMD blocks and the scalar tails alike
+	const float edges[] = { 32767.5f, 32767.998f, 32768.f, -32768.f, -32768.01f, 1e9f, -1e9f, INFINITY, -INFINITY, NAN, -NAN, 1e-9f, -0.f };
+	const int32_t edgesExpected[] = { 2147450880, 2147483520, INT32_MAX, INT32_MIN, INT32_MIN, INT32_MAX, INT32_MIN, INT32_MAX, INT32_MIN, 0, 0, 0, 0 };
+	const int edgeCount = 13 * 7 + 5;
+	std::vector<float> edgeFloats(edgeCount);
+	std::vector<Fixed16> edgeFixed(edgeCount), edgeExpected(edgeCount);
+	bool saturated = true;
+	for (int i = 0; i < edgeCount; i++) {
+		edgeFloats[i] = edges[i * 5 % 13];
+		edgeExpected[i] = Fixed16::FromRaw(edgesExpected[i * 5 % 13]);
+		saturated = saturated && Fixed16::FromFloat(edgeFloats[i]) == edgeExpected[i];
+	}
+	Check(saturated, "FromFloat saturates and gives 0 for NaN");
+	Check(Fixed32::FromDouble(1e30) == Fixed32::FromRaw(INT64_MAX) && Fixed32::FromDouble(-1e30) == Fixed32::FromRaw(INT64_MIN) && Fixed32::FromDouble(NAN) == Fixed32(), "FromDouble saturates and gives 0 for NaN");
+
+	std::printf("ns per vector : float Matrix3x3 * Vector3 %.2f\n", NanosecondsPerItem(count, 5, [&] {
+		for (int i = 0; i < count; i++)
+			floatResult[i] = floatRotation * floats[i];
+	}));
+	SimdLevel detected = Cpu::Detected();
+	for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+		if (level > detected || !Cpu::Force(level))
+			continue;
+		FixedMatrix3x3<Fixed16>::TransformVectors(rotation, vectors.data(), result.data(), count);
+		Check(std::memcmp(result.data(), expected.data(), count * sizeof(result[0])) == 0, "TransformVectors gives the operator bits");
+		Fixed16::FromFloats(raw.data(), fixed.data(), count * 3);
+		Check(std::memcmp(fixed.data(), fixedExpected.data(), count * 3 * sizeof(Fixed16)) == 0, "FromFloats gives FromFloat's bits");
+		Fixed16::FromFloats(edgeFloats.data(), edgeFixed.data(), edgeCount);
+		Check(std::memcmp(edgeFixed.data(), edgeExpected.data(), edgeCount * sizeof(Fixed16)) == 0, "FromFloats saturates as FromFloat does");
+		Fixed16::ToFloats(fixed.data(), back.data(), count * 3);
+		bool same = true;
+		for (int i = 0; i < count * 3; i++)
+			same = same && back[i] == fixedExpected[i].ToFloat();
+		Check(same, "ToFloats gives ToFloat's bits");
+
+		double transform = NanosecondsPerItem(count, 5, [&] { FixedMatrix3x3<Fixed16>::TransformVectors(rotation, vectors.data(), result.data(), count); });
+		std::printf("  %-8s Q16.16 TransformVectors %.2f\n", Cpu::Name(level), transform);
+	}
+	Cpu::Force(detected);
+
+	float drift = 0.f;
+	for (int i = 0; i < count; i++)
+		drift = std::max(drift, Vector3::Norm(expected[i].ToVector() - floatResult[i]));
+	std::printf("largest distance between the fixed and float rotations %.1e\n", drift);
+	Check(drift < 1e-2f, "fixed rotation close to the float one");
+
+	FixedMatrix3x3<Fixed32> rotation32 = FixedMatrix3x3<Fixed32>::Rotation(Fixed32::FromFloat(0.3f), Fixed32::FromFloat(1.1f), Fixed32::FromFloat(-2.f));
+	std::vector<FixedVector3<Fixed32>> vectors32(count);
+	for (int i = 0; i < count; i++)
+		vectors32[i] = FixedVector3<Fixed32>::FromVector(floats[i]);
+	std::printf("  %-8s Q32.32 TransformVectors %.2f\n", "Scalar", NanosecondsPerItem(count, 5, [&] {
+		FixedMatrix3x3<Fixed32>::TransformVectors(rotation32, vectors32.data(), vectors32.data(), count);
+	}));
+
+	return failures;
+}
@@ -0,0 +1,147 @@
+#include "TestCommon.h"
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Matrix2x2 and Matrix3x3 Inverse in place, out of place and on singular matrices, the batched Inverses against it
+// and the batched Determinants against double at every SIMD level, with counts that leave a scalar tail.
+using namespace Baboon;
+using namespace BaboonTests;
+
+namespace
+{
+	// determinant by cofactor expansion along the first row, in double
+	double ReferenceDeterminant(const float* m, int n)
+	{
+		if (n == 1)
+			return m[0];
+		double det = 0.;
+		float minor[9];
+		for (int c = 0; c < n; c++) {
+			int k = 0;
+			for (int i = 1; i < n; i++)
+				for (int j = 0; j < n; j++)
+					if (j != c)
+						minor[k++] = m[i * n + j];
+			det += (c % 2 ? -1. : 1.) * m[c] * ReferenceDeterminant(minor, n - 1);
+		}
+		return det;
+	}
+
+	// random matrix with a dominant diagonal, so its inverse is well conditioned
+	template <class M>
+	M Random(std::mt19937& rng, int n)
+	{
+		std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+		M m;
+		for (int i = 0; i < n * n; i++)
+			m.elements[i] = uniform(rng) + (i % (n + 1) == 0 ? 3.f : 0.f);
+		return m;
+	}
+
+	// Inverse out of place, in place through result == *this and through Inverse(), and singular with a zero row
+	template <class M>
+	void CheckInverse(std::mt19937& rng, int n, const char* name)
+	{
+		float error = 0.f;
+		bool inPlace = true, singular = true;
+		for (int t = 0; t < 1000; t++) {
+			M m = Random<M>(rng, n), inverse;
+			bool regular = m.Inverse(inverse);
+			error = std::max(error, MaxDifference(m * inverse, M(true)));
+
+			M self = m, other = m;
+			inPlace = inPlace && regular && self.Inverse(self) && other.Inverse();
+			inPlace = inPlace && self.elements == inverse.elements && other.elements == inverse.elements;
+
+			M zero = m, result = m;
+			for (int j = 0; j < n; j++)
+				zero.elements[(t % n) * n + j] = 0.f;
+			M untouched = zero;
+			singular = singular && !zero.Inverse(result) && result.elements == m.elements;
+			singular = singular && !zero.Inverse() && zero.elements == untouched.elements;
+		}
+		std::printf("%s Inverse : largest error of m * inverse %.1e\n", name, error);
+		Check(error < 1e-5f, "m * inverse is the identity");
+		Check(inPlace, "Inverse in place gives the out of place bits");
+		Check(singular, "Inverse of a singular matrix returns false and leaves the result untouched");
+	}
+
+	// Inverses against the scalar Inverse, singular matrices copied and counted, in place as out of place
+	template <class M>
+	void CheckInverses(std::mt19937& rng, int n, const char* name)
+	{
+		const size_t count = 1000 + 7;
+		std::vector<M> matrices(count), inverses(count), expected(count);
+		size_t expectedSingular = 0;
+		for (size_t i = 0; i < count; i++) {
+			matrices[i] = Random<M>(rng, n);
+			if (i % 97 == 3 || i == count - 2) {
+				for (int j = 0; j < n; j++)
+					matrices[i].elements[(i % n) * n + j] = 0.f;
+				expected[i] = matrices[i];
+				expectedSingular++;
+			}
+			else
+				matrices[i].Inverse(expected[i]);
+		}
+
+		SimdLevel detected = Cpu::Detected();
+		for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+			if (level > detected || !Cpu::Force(level))
+				continue;
+			size_t singular = M::Inverses(matrices.data(), inverses.data(), count);
+			float error = 0.f;
+			for (size_t i = 0; i < count; i++)
+				error = std::max(error, MaxDifference(inverses[i], expected[i]));
+			std::printf("  %-8s %s Inverses : largest difference to Inverse %.1e\n", Cpu::Name(level), name, error);
+			Check(singular == expectedSingular, "Inverses counts the singular matrices");
+			Check(error < 1e-5f, "Inverses matches Inverse");
+
+			std::vector<M> inPlace = matrices;
+			M::Inverses(inPlace.data(), inPlace.data(), count);
+			Check(std::memcmp(inPlace.data(), inverses.data(), count * sizeof(M)) == 0, "Inverses in place gives the out of place bits");
+		}
+		Cpu::Force(detected);
+	}
+
+	template <class M>
+	void CheckDeterminants(std::mt19937& rng, int n, const char* name)
+	{
+		const size_t count = 1000 + 13;
+		std::vector<M> matrices(count);
+		std::vector<double> expected(count);
+		std::vector<float> determinants(count);
+		for (size_t i = 0; i < count; i++) {
+			matrices[i] = Random<M>(rng, n);
+			expected[i] = ReferenceDeterminant(matrices[i].elements.data(), n);
+		}
+
+		SimdLevel detected = Cpu::Detected();
+		for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+			if (level > detected || !Cpu::Force(level))
+				continue;
+			M::Determinants(matrices.data(), determinants.data(), count);
+			double error = 0., scalarError = 0.;
+			for (size_t i = 0; i < count; i++) {
+				error = std::max(error, fabs(determinants[i] - expected[i]) / fabs(expected[i]));
+				scalarError = std::max(scalarError, fabs(matrices[i].Determinant() - expected[i]) / fabs(expected[i]));
+			}
+			std::printf("  %-8s %s Determinants | Determinant : largest relative error %.1e | %.1e\n", Cpu::Name(level), name, error, scalarError);
+			Check(error < 1e-5 && scalarError < 1e-5, "Determinants and Determinant within float rounding");
+		}
+		Cpu::Force(detected);
+	}
+}
+
+int main()
+{
+	std::mt19937 rng(6);
+	CheckInverse<Matrix2x2>(rng, 2, "Matrix2x2");
+	CheckInverse<Matrix3x3>(rng, 3, "Matrix3x3");
+	CheckInverses<Matrix2x2>(rng, 2, "Matrix2x2");
+	CheckInverses<Matrix3x3>(rng, 3, "Matrix3x3");
+	CheckDeterminants<Matrix3x3>(rng, 3, "Matrix3x3");
+	CheckDeterminants<Matrix4x4>(rng, 4, "Matrix4x4");
+	return failures;
+}
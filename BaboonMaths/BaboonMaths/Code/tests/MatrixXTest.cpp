@@ -0,0 +1,69 @@
+#include "TestCommon.h"
+#include <random>
+
+// MatrixX expression templates against the plain Add / MultiplyNumber / Multiply functions, including assignments
+// whose expression reads the matrix being assigned, with and without a change of size.
+using namespace Baboon;
+using namespace BaboonTests;
+
+namespace
+{
+	std::mt19937 rng(5);
+
+	MatrixX Random(int rows, int cols)
+	{
+		std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+		MatrixX m(rows, cols);
+		for (float& e : m.elements)
+			e = uniform(rng);
+		return m;
+	}
+
+	bool Same(const MatrixX& a, const MatrixX& b, float tolerance = 1e-4f)
+	{
+		return a.rows == b.rows && a.cols == b.cols && MaxDifference(a, b) <= tolerance;
+	}
+}
+
+int main()
+{
+	MatrixX a = Random(50, 60), b = Random(50, 60), c = Random(50, 60);
+	MatrixX fused = a * 2.f + b - c;
+	Check(Same(fused, MatrixX::Add(MatrixX::Add(MatrixX::MultiplyNumber(a, 2.f), b), MatrixX::MultiplyNumber(c, -1.f))), "a * 2 + b - c");
+
+	MatrixX p = Random(500, 10), q = Random(10, 500), r = Random(500, 3);
+	MatrixX chain = MatrixX::Multiply(MatrixX::Multiply(p, q), r);
+	Check(Same(p * q * r, chain, 1e-3f), "chain p * q * r");
+	Check(Same(2.f * (p * (q * r)), MatrixX::MultiplyNumber(chain, 2.f), 1e-3f), "scaled chain");
+	Check(Same(p * q * r - chain + (p * q) * r, chain, 1e-3f), "products inside a sum");
+	MatrixX identity(60, 5, true);
+	Check(Same((a + b) * identity, MatrixX::Multiply(MatrixX::Add(a, b), identity)), "sum as a factor");
+
+	// self references keeping the size
+	MatrixX s = Random(4, 4), t = Random(4, 4), s0 = s;
+	s = s * t;
+	Check(Same(s, MatrixX::Multiply(s0, t)), "s = s * t");
+	s = s0;
+	s = s + t;
+	Check(Same(s, MatrixX::Add(s0, t)), "s = s + t");
+	s = s0;
+	s = s * t + s;
+	Check(Same(s, MatrixX::Add(MatrixX::Multiply(s0, t), s0)), "s = s * t + s");
+
+	// self references changing the size : the product must read the matrix before it is resized
+	MatrixX m = Random(3, 2), n = Random(2, 4), o = Random(3, 4), m0 = m;
+	m = m * n + o;
+	Check(Same(m, MatrixX::Add(MatrixX::Multiply(m0, n), o)), "m = m * n + o, 3x2 to 3x4");
+	m = m0;
+	m = 2.f * (m * n) - o;
+	Check(Same(m, MatrixX::Add(MatrixX::MultiplyNumber(MatrixX::Multiply(m0, n), 2.f), MatrixX::MultiplyNumber(o, -1.f))), "m = 2 * (m * n) - o");
+	m = m0;
+	m = m * n;
+	Check(Same(m, MatrixX::Multiply(m0, n)), "m = m * n, 3x2 to 3x4");
+	MatrixX w = Random(4, 3), w0 = w;
+	w = n * w + Random(2, 3) * 0.f;
+	Check(Same(w, MatrixX::Multiply(n, w0)), "w = n * w + zero, 4x3 to 2x3");
+
+	std::printf("%s\n", failures ? "MatrixX expressions failed" : "MatrixX expressions passed");
+	return failures;
+}
@@ -0,0 +1,142 @@
+#include "TestCommon.h"
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// The SoA particle integrators against the same update written with the Vector3 operators over std::vector<Vector3>
+// (AoS) : results, bounds killing, and the time of a step at every SIMD level and with every thread.
+// The particle count is the first argument, 10M by default.
+using namespace Baboon;
+using namespace BaboonTests;
+
+namespace
+{
+	struct Soa
+	{
+		std::vector<float> lanes[9];
+
+		explicit Soa(int count)
+		{
+			for (std::vector<float>& lane : lanes)
+				lane.resize(count);
+		}
+
+		ParticleStreams Streams(int count)
+		{
+			return { { lanes[0].data(), lanes[1].data(), lanes[2].data() }, { lanes[3].data(), lanes[4].data(), lanes[5].data() },
+				{ lanes[6].data(), lanes[7].data(), lanes[8].data() }, count };
+		}
+	};
+
+	void Fill(Soa& soa, std::vector<Vector3>& positions, std::vector<Vector3>& velocities, std::vector<Vector3>& previous, float dt)
+	{
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+		for (size_t i = 0; i < positions.size(); i++) {
+			positions[i] = Vector3(uniform(rng), uniform(rng), uniform(rng));
+			velocities[i] = Vector3(uniform(rng), uniform(rng), uniform(rng));
+			previous[i] = positions[i] - velocities[i] * dt;
+			const Vector3* v[3] = { &positions[i], &velocities[i], &previous[i] };
+			for (int s = 0; s < 3; s++) {
+				soa.lanes[s * 3][i] = v[s]->x;
+				soa.lanes[s * 3 + 1][i] = v[s]->y;
+				soa.lanes[s * 3 + 2][i] = v[s]->z;
+			}
+		}
+	}
+
+	float MaxDifference(const std::vector<Vector3>& aos, const Soa& soa, int lane)
+	{
+		float e = 0.f;
+		for (size_t i = 0; i < aos.size(); i++) {
+			e = std::max(e, fabsf(aos[i].x - soa.lanes[lane][i]));
+			e = std::max(e, fabsf(aos[i].y - soa.lanes[lane + 1][i]));
+			e = std::max(e, fabsf(aos[i].z - soa.lanes[lane + 2][i]));
+		}
+		return e;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int count = argc > 1 ? std::atoi(argv[1]) : 10000000;
+	const float dt = 0.01f;
+	ParticleForces forces;
+	forces.gravity = Vector3(0.f, -9.81f, 0.f);
+	forces.drag = 0.1f;
+
+	Soa soa(count);
+	std::vector<Vector3> positions(count), velocities(count), previous(count);
+	Fill(soa, positions, velocities, previous, dt);
+	ParticleStreams streams = soa.Streams(count);
+
+	// one step of each integrator against the operator version
+	double aos = NanosecondsPerItem(count, 1, [&] {
+		for (int i = 0; i < count; i++) {
+			velocities[i] += (forces.gravity - forces.drag * velocities[i]) * dt;
+			positions[i] += velocities[i] * dt;
+		}
+	});
+	Particles::SemiImplicitEuler(streams, forces, dt, 1);
+	float semiImplicit = std::max(MaxDifference(positions, soa, 0), MaxDifference(velocities, soa, 3));
+
+	for (int i = 0; i < count; i++) {
+		positions[i] += velocities[i] * dt;
+		velocities[i] += (forces.gravity - forces.drag * velocities[i]) * dt;
+	}
+	Particles::ExplicitEuler(streams, forces, dt, 1);
+	float explicitEuler = std::max(MaxDifference(positions, soa, 0), MaxDifference(velocities, soa, 3));
+
+	for (int i = 0; i < count; i++) {
+		Vector3 position = positions[i];
+		positions[i] += (positions[i] - previous[i]) * (1.f - forces.drag * dt) + forces.gravity * (dt * dt);
+		previous[i] = position;
+	}
+	Particles::Verlet(streams, forces, dt, 1);
+	float verlet = std::max(MaxDifference(positions, soa, 0), MaxDifference(previous, soa, 6));
+
+	std::printf("%d particles, largest difference with the operators : semi-implicit %.1e  explicit %.1e  Verlet %.1e\n",
+		count, semiImplicit, explicitEuler, verlet);
+	Check(semiImplicit < 1e-5f && explicitEuler < 1e-5f && verlet < 1e-5f, "SoA integrators match the operator updates");
+
+	// bounds killing keeps exactly the particles inside, in any order
+	ParticleForces killing = forces;
+	killing.killOutOfBounds = true;
+	killing.boundsMin = Vector3(-1.f);
+	killing.boundsMax = Vector3(1.f);
+	int inside = 0;
+	double insideSum = 0.;
+	for (int i = 0; i < count; i++) {
+		Vector3 v = velocities[i] + (killing.gravity - killing.drag * velocities[i]) * 0.1f;
+		Vector3 p = positions[i] + v * 0.1f;
+		if (p.x >= -1.f && p.x <= 1.f && p.y >= -1.f && p.y <= 1.f && p.z >= -1.f && p.z <= 1.f) {
+			inside++;
+			insideSum += p.x;
+		}
+	}
+	Soa killed = soa;
+	ParticleStreams killedStreams = killed.Streams(count);
+	int alive = Particles::SemiImplicitEuler(killedStreams, killing, 0.1f);
+	double aliveSum = 0.;
+	for (int i = 0; i < alive; i++)
+		aliveSum += killed.lanes[0][i];
+	std::printf("bounds : %d of %d particles alive, %d expected\n", alive, count, inside);
+	Check(inside > 0 && alive == inside && fabs(aliveSum - insideSum) < 1e-6 * count, "bounds killing keeps the particles inside");
+
+	// ns per particle and step
+	std::printf("ns per particle : operators over std::vector<Vector3> %.2f\n", aos);
+	SimdLevel detected = Cpu::Detected();
+	for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+		if (level > detected || !Cpu::Force(level))
+			continue;
+		double semi = NanosecondsPerItem(count, 3, [&] { Particles::SemiImplicitEuler(streams, forces, dt, 1); });
+		double euler = NanosecondsPerItem(count, 3, [&] { Particles::ExplicitEuler(streams, forces, dt, 1); });
+		double step = NanosecondsPerItem(count, 3, [&] { Particles::Verlet(streams, forces, dt, 1); });
+		std::printf("  %-8s 1 thread     semi-implicit %.2f  explicit %.2f  Verlet %.2f\n", Cpu::Name(level), semi, euler, step);
+	}
+	Cpu::Force(detected);
+	double threaded = NanosecondsPerItem(count, 3, [&] { Particles::SemiImplicitEuler(streams, forces, dt); });
+	std::printf("  %-8s all threads  semi-implicit %.2f\n", Cpu::Name(detected), threaded);
+
+	return failures;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "BaboonMaths.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+// Helpers of the test and benchmark programs of this directory. Each program is one translation unit linked with the
+// library sources, prints its measurements and returns the number of failed checks :
+//   g++ -std=c++17 -O2 -ICode/include Code/tests/Decomposition3x3Test.cpp Code/src/*.cpp (minus main.cpp) -pthread
+namespace BaboonTests
+{
+	inline int failures = 0;
+
+	inline void Check(bool condition, const char* what)
+	{
+		if (!condition) {
+			std::printf("FAILED : %s\n", what);
+			failures++;
+		}
+	}
+
+	// largest absolute difference of two matrices
+	template <class M>
+	float MaxDifference(const M& a, const M& b)
+	{
+		float e = 0.f;
+		for (size_t i = 0; i < a.elements.size(); i++)
+			e = std::max(e, fabsf(a.elements[i] - b.elements[i]));
+		return e;
+	}
+
+	// nanoseconds per item of the fastest of repeats runs of f
+	template <class F>
+	double NanosecondsPerItem(size_t items, int repeats, F f)
+	{
+		double best = 1e300;
+		for (int r = 0; r < repeats; r++) {
+			auto start = std::chrono::steady_clock::now();
+			f();
+			best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+		}
+		return best / (double)items;
+	}
+}